@@ -24,6 +24,10 @@
  * @page account Representation of an account
  *
  * Representation of an account
+ *
+ * Registered Accounts are indexed by name and by ID, so they can be found
+ * without walking #AllAccounts.  The 'account' command stack holds the
+ * Accounts themselves, rather than their names.
  */
 
 #include "config.h"
@@ -31,7 +35,16 @@
 #include "account.h"
 
 struct AccountList AllAccounts = TAILQ_HEAD_INITIALIZER(AllAccounts);
-struct ListHead ConfigAccountStack = STAILQ_HEAD_INITIALIZER(ConfigAccountStack);
+
+static struct Hash *AccountNames = NULL; ///< Registered Accounts, by name
+static struct Hash *AccountIds = NULL;   ///< Registered Accounts, by ID
+static unsigned int AccountNextId = 1;   ///< ID for the next registered Account
+
+static struct Account **AccountStack = NULL; ///< Stack of 'account' commands in effect
+static size_t AccountStackLen = 0;           ///< Number of Accounts on the stack
+static size_t AccountStackSize = 0;          ///< Allocated size of the stack
+
+static void account_unregister(struct Account *a);
 
 /**
  * account_new - Create a new Account
@@ -41,7 +54,7 @@ struct ListHead ConfigAccountStack = STAILQ_HEAD_INITIALIZER(ConfigAccountStack)
 struct Account *account_new(struct ConfigSet *cs, const char *name)
 {
   struct Account *a = mutt_mem_calloc(1, sizeof(struct Account));
-  STAILQ_INIT(&a->mailboxes);
+  TAILQ_INIT(&a->mailboxes);
 
   if (name)
   {
@@ -74,7 +87,33 @@ bool account_add_config(struct Account *a, const struct ConfigSet *cs,
   for (; var_names[count]; count++)
     ;
 
-  a->name = mutt_str_strdup(name);
+  if (a->id != 0)
+  {
+    struct Account *other = account_find(name);
+    if (other && (other != a))
+      return false;
+  }
+
+  /* Replace any config items from before */
+  if (a->vars)
+  {
+    cs_he_delete_many(a->cs, a->vars, a->num_vars, a->name);
+    FREE(&a->vars);
+  }
+
+  if (a->name != name)
+  {
+    /* A registered Account keeps its entry, under the new name */
+    if (a->id != 0)
+      mutt_hash_delete(AccountNames, a->name, a);
+
+    FREE(&a->name);
+    a->name = mutt_str_strdup(name);
+
+    if (a->id != 0)
+      mutt_hash_insert(AccountNames, a->name, a);
+  }
+
   a->cs = cs;
   a->var_names = var_names;
   a->vars = mutt_mem_calloc(count, sizeof(struct HashElem *));
@@ -106,28 +145,82 @@ bool account_add_config(struct Account *a, const struct ConfigSet *cs,
 /**
  * account_free_config - Remove an Account's Config items
  * @param a Account
+ *
+ * The config items are deleted using their stored HashElems.  Observers are
+ * sent a single #NT_CONFIG_DELETED event, named after the Account.
+ *
+ * The Account loses its name, so it's removed from the registry, first.
  */
 void account_free_config(struct Account *a)
 {
   if (!a)
     return;
 
-  char child[128];
-  struct Buffer *err = mutt_buffer_alloc(128);
+  account_unregister(a);
+  cs_he_delete_many(a->cs, a->vars, a->num_vars, a->name);
 
-  for (size_t i = 0; i < a->num_vars; i++)
+  FREE(&a->name);
+  FREE(&a->vars);
+}
+
+/**
+ * account_add - Register an Account
+ * @param a Account to add
+ * @retval true Account was registered
+ *
+ * The Account is given a unique ID and added to #AllAccounts.  Its name must
+ * be set and must not already be in use.
+ */
+bool account_add(struct Account *a)
+{
+  if (!a || !a->name || (a->id != 0))
+    return false;
+
+  if (!AccountNames)
   {
-    snprintf(child, sizeof(child), "%s:%s", a->name, a->var_names[i]);
-    mutt_buffer_reset(err);
-    int result = cs_str_reset(a->cs, child, err);
-    if (CSR_RESULT(result) != CSR_SUCCESS)
-      mutt_debug(LL_DEBUG1, "reset failed for %s: %s\n", child, mutt_b2s(err));
-    mutt_hash_delete(a->cs->hash, child, NULL);
+    AccountNames = mutt_hash_new(128, MUTT_HASH_STRDUP_KEYS);
+    AccountIds = mutt_hash_int_new(128, MUTT_HASH_NO_FLAGS);
   }
 
-  mutt_buffer_free(&err);
-  FREE(&a->name);
-  FREE(&a->vars);
+  if (mutt_hash_find(AccountNames, a->name))
+    return false;
+
+  a->id = AccountNextId++;
+  mutt_hash_insert(AccountNames, a->name, a);
+  mutt_hash_int_insert(AccountIds, a->id, a);
+  TAILQ_INSERT_TAIL(&AllAccounts, a, entries);
+  return true;
+}
+
+/**
+ * account_unregister - Remove an Account from the registry
+ * @param a Account to remove
+ *
+ * The Account is also removed from the 'account' command stack.
+ */
+static void account_unregister(struct Account *a)
+{
+  size_t keep = 0;
+  for (size_t i = 0; i < AccountStackLen; i++)
+  {
+    if (AccountStack[i] != a)
+      AccountStack[keep++] = AccountStack[i];
+  }
+  AccountStackLen = keep;
+
+  if (a->id == 0)
+    return;
+
+  TAILQ_REMOVE(&AllAccounts, a, entries);
+  mutt_hash_delete(AccountNames, a->name, a);
+  mutt_hash_int_delete(AccountIds, a->id, a);
+  a->id = 0;
+
+  if (TAILQ_EMPTY(&AllAccounts))
+  {
+    mutt_hash_free(&AccountNames);
+    mutt_hash_free(&AccountIds);
+  }
 }
 
 /**
@@ -140,8 +233,17 @@ void account_free(struct Account **ptr)
     return;
 
   struct Account *a = *ptr;
-  if (!TAILQ_EMPTY(&AllAccounts))
-    TAILQ_REMOVE(&AllAccounts, a, entries);
+  account_unregister(a);
+
+  /* The Mailboxes outlive the Account */
+  while (!TAILQ_EMPTY(&a->mailboxes))
+  {
+    struct MailboxNode *np = TAILQ_FIRST(&a->mailboxes);
+    TAILQ_REMOVE(&a->mailboxes, np, entries);
+    np->mailbox->account = NULL;
+    np->mailbox = NULL;
+  }
+
   if (a->free_adata)
     a->free_adata(&a->adata);
 
@@ -150,24 +252,40 @@ void account_free(struct Account **ptr)
   FREE(ptr);
 }
 
+/**
+ * account_add_mailbox - Add a Mailbox to an Account
+ * @param a Account
+ * @param m Mailbox to add
+ * @retval true Mailbox was added
+ */
+bool account_add_mailbox(struct Account *a, struct Mailbox *m)
+{
+  if (!a || !m || m->account)
+    return false;
+
+  m->anode.mailbox = m;
+  TAILQ_INSERT_TAIL(&a->mailboxes, &m->anode, entries);
+  m->account = a;
+  return true;
+}
+
 /**
  * account_remove_mailbox - Remove a Mailbox from an Account
  * @param a Account
  * @param m Mailbox to remove
+ *
+ * If the Account has no Mailboxes left, it is freed.
  */
 void account_remove_mailbox(struct Account *a, struct Mailbox *m)
 {
-  struct MailboxNode *np = NULL;
-  STAILQ_FOREACH(np, &a->mailboxes, entries)
-  {
-    if (np->mailbox == m)
-    {
-      STAILQ_REMOVE(&a->mailboxes, np, MailboxNode, entries);
-      break;
-    }
-  }
+  if (!a || !m || (m->account != a))
+    return;
 
-  if (STAILQ_EMPTY(&a->mailboxes))
+  TAILQ_REMOVE(&a->mailboxes, &m->anode, entries);
+  m->anode.mailbox = NULL;
+  m->account = NULL;
+
+  if (TAILQ_EMPTY(&a->mailboxes))
   {
     account_free(&a);
   }
@@ -219,15 +337,14 @@ int account_get_value(const struct Account *a, size_t vid, struct Buffer *result
 
 /**
  * account_get_current - Current 'account' command in effect
- * @retval ptr Name of the current Account
+ * @retval ptr Current Account
  */
-char *account_get_current(void)
+struct Account *account_get_current(void)
 {
-  struct ListNode *np = STAILQ_FIRST(&ConfigAccountStack);
-  if (!np)
+  if (AccountStackLen == 0)
     return NULL;
 
-  return np->data;
+  return AccountStack[AccountStackLen - 1];
 }
 
 /**
@@ -238,45 +355,43 @@ char *account_get_current(void)
  */
 struct Account *account_find(const char *name)
 {
-  struct Account *np = NULL;
-  TAILQ_FOREACH(np, &AllAccounts, entries)
-  {
-    if (mutt_str_strcmp(name, np->name) == 0)
-      return np;
-  }
+  if (!AccountNames || !name)
+    return NULL;
 
-  return NULL;
+  return mutt_hash_find(AccountNames, name);
 }
 
 /**
- * account_count - Count the 'account' command stack depth
- * @param num Stack depth
+ * account_find_id - Find an Account by its ID
+ * @param id ID to find
+ * @retval ptr  Matching Account
+ * @retval NULL None found
  */
-size_t account_count(void)
+struct Account *account_find_id(unsigned int id)
 {
-  size_t count = 0;
+  if (!AccountIds || (id == 0))
+    return NULL;
 
-  struct ListNode *np = NULL;
-  STAILQ_FOREACH(np, &ConfigAccountStack, entries)
-  {
-    count++;
-  }
-  return count;
+  return mutt_hash_int_find(AccountIds, id);
 }
 
 /**
  * account_push_current - Set the current 'account' command in effect
- * @param name Current Account name
+ * @param a Current Account
  */
-void account_push_current(char *name)
+void account_push_current(struct Account *a)
 {
-  if (!name)
+  if (!a)
     return;
 
-  name = mutt_str_strdup(name);
-  mutt_list_insert_head(&ConfigAccountStack, name);
+  if (AccountStackLen == AccountStackSize)
+  {
+    AccountStackSize += 8;
+    mutt_mem_realloc(&AccountStack, AccountStackSize * sizeof(struct Account *));
+  }
+  AccountStack[AccountStackLen++] = a;
 
-  mutt_message("pushed %s (%ld)", name, account_count());
+  mutt_message("pushed %s (%zu)", a->name, AccountStackLen);
 }
 
 /**
@@ -284,13 +399,15 @@ void account_push_current(char *name)
  */
 void account_pop_current(void)
 {
-  struct ListNode *first = STAILQ_FIRST(&ConfigAccountStack);
-  if (!first)
+  if (AccountStackLen == 0)
     return;
 
-  STAILQ_REMOVE_HEAD(&ConfigAccountStack, entries);
+  struct Account *a = AccountStack[--AccountStackLen];
+  mutt_message("popped %s (%zu)", a->name, AccountStackLen);
 
-  mutt_message("popped %s (%ld)", first->data, account_count());
-  FREE(&first->data);
-  FREE(&first);
+  if (AccountStackLen == 0)
+  {
+    FREE(&AccountStack);
+    AccountStackSize = 0;
+  }
 }
@@ -44,6 +44,7 @@ struct Account
   void (*free_adata)(void **);
 
   char *name;                 ///< Name of Account
+  unsigned int id;            ///< Unique ID, set by account_add(), 0 if unregistered
   const struct ConfigSet *cs; ///< Parent ConfigSet
   const char **var_names;     ///< Array of the names of local config items
   size_t num_vars;            ///< Number of local config items
@@ -52,17 +53,19 @@ struct Account
 TAILQ_HEAD(AccountList, Account);
 
 extern struct AccountList AllAccounts; ///< List of all Accounts
-extern struct AccountList CurrentConfigAccount; ///< Current 'account' command in use
 
+bool            account_add(struct Account *a);
 bool            account_add_config(struct Account *a, const struct ConfigSet *cs, const char *name, const char *var_names[]);
+bool            account_add_mailbox(struct Account *a, struct Mailbox *m);
 struct Account *account_find(const char *name);
+struct Account *account_find_id(unsigned int id);
 void            account_free(struct Account **ptr);
 void            account_free_config(struct Account *a);
-char *          account_get_current(void);
+struct Account *account_get_current(void);
 int             account_get_value(const struct Account *a, size_t vid, struct Buffer *result);
 struct Account *account_new(struct ConfigSet *cs, const char *name);
 void            account_pop_current(void);
-void            account_push_current(char *name);
+void            account_push_current(struct Account *a);
 void            account_remove_mailbox(struct Account *a, struct Mailbox *m);
 int             account_set_value(const struct Account *a, size_t vid, intptr_t value, struct Buffer *err);
 
@@ -0,0 +1,263 @@
+/**
+ * @file
+ * Shared code for the benchmarks
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <time.h>
+#include <unistd.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+#include "dump/data.h"
+
+/* Count allocations by wrapping glibc's allocator.  This doesn't play well
+ * with the sanitisers, which provide their own malloc. */
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define BENCH_COUNT_ALLOCS
+#endif
+
+#ifdef BENCH_COUNT_ALLOCS
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static size_t AllocCount = 0;
+static size_t FreeCount = 0;
+static size_t AllocBytes = 0;
+static size_t HeapBytes = 0;
+static size_t HeapFreed = 0;
+
+/**
+ * count_heap - Count the heap space taken by an allocation
+ * @param ptr Allocated memory
+ * @retval ptr The same memory
+ *
+ * Each chunk costs its usable size plus one word of malloc bookkeeping.
+ */
+static void *count_heap(void *ptr)
+{
+  if (ptr)
+  {
+    size_t size = malloc_usable_size(ptr) + sizeof(size_t);
+    __atomic_add_fetch(&HeapBytes, size, __ATOMIC_RELAXED);
+  }
+  return ptr;
+}
+
+void *malloc(size_t size)
+{
+  __atomic_add_fetch(&AllocCount, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&AllocBytes, size, __ATOMIC_RELAXED);
+  return count_heap(__libc_malloc(size));
+}
+
+/**
+ * uncount_heap - Count the heap space released by a free
+ * @param ptr Memory about to be freed
+ */
+static void uncount_heap(void *ptr)
+{
+  if (ptr)
+  {
+    size_t size = malloc_usable_size(ptr) + sizeof(size_t);
+    __atomic_add_fetch(&HeapFreed, size, __ATOMIC_RELAXED);
+  }
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+  __atomic_add_fetch(&AllocCount, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&AllocBytes, nmemb * size, __ATOMIC_RELAXED);
+  return count_heap(__libc_calloc(nmemb, size));
+}
+
+void *realloc(void *ptr, size_t size)
+{
+  __atomic_add_fetch(&AllocCount, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&AllocBytes, size, __ATOMIC_RELAXED);
+  uncount_heap(ptr);
+  return count_heap(__libc_realloc(ptr, size));
+}
+
+void free(void *ptr)
+{
+  if (ptr)
+    __atomic_add_fetch(&FreeCount, 1, __ATOMIC_RELAXED);
+  uncount_heap(ptr);
+  __libc_free(ptr);
+}
+#endif
+
+/**
+ * now - Get a monotonic time in seconds
+ * @retval num Time
+ */
+static double now(void)
+{
+  struct timespec ts = { 0 };
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+/**
+ * bench_alloc_counting - Are allocations being counted?
+ * @retval true Allocation counts are meaningful
+ */
+bool bench_alloc_counting(void)
+{
+#ifdef BENCH_COUNT_ALLOCS
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * bench_start - Start measuring
+ * @param stats Measurements to initialise
+ */
+void bench_start(struct BenchStats *stats)
+{
+  if (!stats)
+    return;
+
+#ifdef BENCH_COUNT_ALLOCS
+  stats->allocs = __atomic_load_n(&AllocCount, __ATOMIC_RELAXED);
+  stats->frees = __atomic_load_n(&FreeCount, __ATOMIC_RELAXED);
+  stats->alloc_bytes = __atomic_load_n(&AllocBytes, __ATOMIC_RELAXED);
+  stats->heap_bytes = __atomic_load_n(&HeapBytes, __ATOMIC_RELAXED);
+  stats->heap_freed = __atomic_load_n(&HeapFreed, __ATOMIC_RELAXED);
+#else
+  stats->allocs = 0;
+  stats->frees = 0;
+  stats->alloc_bytes = 0;
+  stats->heap_bytes = 0;
+  stats->heap_freed = 0;
+#endif
+  stats->seconds = now();
+}
+
+/**
+ * bench_stop - Stop measuring
+ * @param stats Measurements started by bench_start()
+ */
+void bench_stop(struct BenchStats *stats)
+{
+  if (!stats)
+    return;
+
+  stats->seconds = now() - stats->seconds;
+#ifdef BENCH_COUNT_ALLOCS
+  stats->allocs = __atomic_load_n(&AllocCount, __ATOMIC_RELAXED) - stats->allocs;
+  stats->frees = __atomic_load_n(&FreeCount, __ATOMIC_RELAXED) - stats->frees;
+  stats->alloc_bytes = __atomic_load_n(&AllocBytes, __ATOMIC_RELAXED) - stats->alloc_bytes;
+  stats->heap_bytes = __atomic_load_n(&HeapBytes, __ATOMIC_RELAXED) - stats->heap_bytes;
+  stats->heap_freed = __atomic_load_n(&HeapFreed, __ATOMIC_RELAXED) - stats->heap_freed;
+#endif
+}
+
+/**
+ * bench_report - Print the results of a benchmark
+ * @param name  Name of the benchmark
+ * @param stats Measurements
+ * @param count Number of operations performed
+ * @param unit  Name of one operation, e.g. "line"
+ */
+void bench_report(const char *name, const struct BenchStats *stats, size_t count,
+                  const char *unit)
+{
+  if (!name || !stats || !unit || (count == 0))
+    return;
+
+  double rate = (stats->seconds > 0) ? (count / stats->seconds) : 0;
+  printf("%-24s %8zu %ss  %9.3f ms  %12.0f %ss/s", name, count, unit,
+         stats->seconds * 1000, rate, unit);
+
+  if (bench_alloc_counting())
+  {
+    printf("  %7.2f allocs/%s  %8.1f bytes/%s  %8.1f heap/%s",
+           (double) stats->allocs / count, unit,
+           (double) stats->alloc_bytes / count, unit,
+           (double) stats->heap_bytes / count, unit);
+  }
+  printf("\n");
+}
+
+/**
+ * bench_quiet - Silence stdout
+ * @param quiet If true, discard stdout; if false, restore it
+ *
+ * Some library functions print debugging messages, which would swamp the
+ * results of a benchmark.
+ */
+void bench_quiet(bool quiet)
+{
+  static int saved_fd = -1;
+
+  fflush(stdout);
+  if (quiet && (saved_fd < 0))
+  {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0)
+      return;
+    saved_fd = dup(STDOUT_FILENO);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+  }
+  else if (!quiet && (saved_fd >= 0))
+  {
+    dup2(saved_fd, STDOUT_FILENO);
+    close(saved_fd);
+    saved_fd = -1;
+  }
+}
+
+/**
+ * bench_config_new - Create a ConfigSet with all of NeoMutt's config
+ * @retval ptr New ConfigSet
+ */
+struct ConfigSet *bench_config_new(void)
+{
+  struct ConfigSet *cs = cs_new(500);
+
+  address_init(cs);
+  bool_init(cs);
+  enum_init(cs);
+  long_init(cs);
+  mbtable_init(cs);
+  number_init(cs);
+  quad_init(cs);
+  regex_init(cs);
+  slist_init(cs);
+  sort_init(cs);
+  string_init(cs);
+
+  if (!cs_register_variables(cs, MuttVars, 0))
+    cs_free(&cs);
+
+  return cs;
+}
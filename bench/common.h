@@ -0,0 +1,52 @@
+/**
+ * @file
+ * Shared code for the benchmarks
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BENCH_COMMON_H
+#define _BENCH_COMMON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct ConfigSet;
+
+/**
+ * struct BenchStats - Measurements for one benchmark run
+ */
+struct BenchStats
+{
+  double seconds;     ///< Wall-clock time taken
+  size_t allocs;      ///< Number of malloc/calloc/realloc calls
+  size_t frees;       ///< Number of free calls
+  size_t alloc_bytes; ///< Total bytes requested
+  size_t heap_bytes;  ///< Total bytes used on the heap, including malloc's overhead
+  size_t heap_freed;  ///< Total heap bytes released, heap_bytes - heap_freed is the growth in use
+};
+
+bool   bench_alloc_counting(void);
+void   bench_start(struct BenchStats *stats);
+void   bench_stop (struct BenchStats *stats);
+void   bench_report(const char *name, const struct BenchStats *stats, size_t count, const char *unit);
+void   bench_quiet (bool quiet);
+
+struct ConfigSet *bench_config_new(void);
+
+#endif /* _BENCH_COMMON_H */
@@ -0,0 +1,159 @@
+/**
+ * @file
+ * Benchmarks for inherited config items
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+#include "test/common.h"
+
+#define BENCH_ACCOUNTS 5000
+
+static short VarApple;
+static short VarBanana;
+static short VarCherry;
+static short VarDamson;
+static short VarElderberry;
+static short VarFig;
+static short VarGuava;
+static short VarHawthorn;
+static short VarIlama;
+static short VarJackfruit;
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",      DT_NUMBER, &VarApple,      1,  0, NULL },
+  { "Banana",     DT_NUMBER, &VarBanana,     2,  0, NULL },
+  { "Cherry",     DT_NUMBER, &VarCherry,     3,  0, NULL },
+  { "Damson",     DT_NUMBER, &VarDamson,     4,  0, NULL },
+  { "Elderberry", DT_NUMBER, &VarElderberry, 5,  0, NULL },
+  { "Fig",        DT_NUMBER, &VarFig,        6,  0, NULL },
+  { "Guava",      DT_NUMBER, &VarGuava,      7,  0, NULL },
+  { "Hawthorn",   DT_NUMBER, &VarHawthorn,   8,  0, NULL },
+  { "Ilama",      DT_NUMBER, &VarIlama,      9,  0, NULL },
+  { "Jackfruit",  DT_NUMBER, &VarJackfruit,  10, 0, NULL },
+  { NULL },
+};
+// clang-format on
+
+/**
+ * bench_inherit_one - Time inherited items in one kind of ConfigSet
+ * @param label Label for the results, e.g. "heap"
+ * @param flags ConfigSet flags, e.g. #CS_ARENA
+ */
+static void bench_inherit_one(const char *label, ConfigSetFlags flags)
+{
+  const size_t num_vars = mutt_array_size(Vars) - 1;
+  const size_t count = BENCH_ACCOUNTS * num_vars;
+
+  struct ConfigSet *cs = cs_new_flags(count * 2, flags);
+  number_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+  {
+    cs_free(&cs);
+    return;
+  }
+
+  struct HashElem **hes = mutt_mem_calloc(count, sizeof(struct HashElem *));
+  struct HashElem *bases[mutt_array_size(Vars)];
+  for (size_t v = 0; v < num_vars; v++)
+    bases[v] = cs_get_elem(cs, Vars[v].name);
+
+  char name[64];
+  char title[64];
+  struct BenchStats stats = { 0 };
+
+  bench_start(&stats);
+  for (size_t a = 0, i = 0; a < BENCH_ACCOUNTS; a++)
+  {
+    for (size_t v = 0; v < num_vars; v++, i++)
+    {
+      snprintf(name, sizeof(name), "account%zu:%s", a, Vars[v].name);
+      hes[i] = cs_inherit_variable(cs, bases[v], name);
+    }
+  }
+  bench_stop(&stats);
+  snprintf(title, sizeof(title), "%s cs_inherit_variable", label);
+  bench_report(title, &stats, count, "item");
+
+  intptr_t total = 0;
+  bench_start(&stats);
+  for (size_t i = 0; i < count; i++)
+    total += cs_he_native_get(cs, hes[i], NULL);
+  bench_stop(&stats);
+  snprintf(title, sizeof(title), "%s native_get (inh)", label);
+  bench_report(title, &stats, count, "item");
+
+  bench_start(&stats);
+  for (size_t i = 0; i < count; i++)
+    cs_he_native_set(cs, hes[i], i % 100, NULL);
+  bench_stop(&stats);
+  snprintf(title, sizeof(title), "%s native_set", label);
+  bench_report(title, &stats, count, "item");
+
+  bench_start(&stats);
+  for (size_t i = 0; i < count; i++)
+    total += cs_he_native_get(cs, hes[i], NULL);
+  bench_stop(&stats);
+  snprintf(title, sizeof(title), "%s native_get (set)", label);
+  bench_report(title, &stats, count, "item");
+  printf("checksum %ld\n", (long) total);
+
+  /* With a fast exit, the items are left for cs_free() */
+  if (!(flags & CS_FAST_EXIT))
+  {
+    bench_start(&stats);
+    cs_he_delete_many(cs, hes, count, NULL);
+    bench_stop(&stats);
+    snprintf(title, sizeof(title), "%s cs_he_delete_many", label);
+    bench_report(title, &stats, count, "item");
+  }
+
+  bench_start(&stats);
+  cs_free(&cs);
+  bench_stop(&stats);
+  snprintf(title, sizeof(title), "%s cs_free", label);
+  bench_report(title, &stats, count, "item");
+
+  FREE(&hes);
+}
+
+/**
+ * bench_inherit - Measure the cost of inherited config items
+ *
+ * Create 50,000 inherited items (5,000 accounts of ten items each), then read
+ * and set them, reporting the time and memory per item.  Compare a plain
+ * ConfigSet, one using an Arena and one using an Arena and a fast exit.
+ */
+void bench_inherit(void)
+{
+  log_line(__func__);
+
+  bench_inherit_one("heap", CS_NO_FLAGS);
+  bench_inherit_one("arena", CS_ARENA);
+  bench_inherit_one("fast", CS_ARENA | CS_FAST_EXIT);
+
+  log_line(__func__);
+}
@@ -0,0 +1,353 @@
+/**
+ * @file
+ * Benchmarks for Regex config items
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <regex.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+#include "test/common.h"
+
+#define BENCH_LINES  20000
+#define BENCH_ROUNDS 10
+
+/* Config items whose Regexes are matched against every line of a mailbox */
+static const char *BenchRegexNames[] = {
+  "quote_regex",
+  "reply_regex",
+  "smileys",
+  "abort_noattach_regex",
+  "gecos_mask",
+};
+
+static const char *BenchWords[] = {
+  "the",  "message", "is",   "attached", "please", "see",    "below",
+  "mail", "from",    "list", "patch",    "review", "thanks", "regards",
+  ":-)",  ";)",      ":P",   "Re:",      "Aw:",    "Sv:",    "[2]",
+};
+
+/**
+ * bench_regex_corpus - Create a synthetic mailbox
+ * @param num Number of lines
+ * @retval ptr Array of lines
+ *
+ * The lines are a mixture of quoted text, subjects and plain text.  The same
+ * seed is used every time, so the runs are comparable.
+ */
+static char **bench_regex_corpus(size_t num)
+{
+  char **lines = mutt_mem_calloc(num, sizeof(char *));
+  unsigned int seed = 42;
+  char line[256];
+
+  for (size_t i = 0; i < num; i++)
+  {
+    seed = (seed * 1103515245) + 12345;
+    size_t len = 0;
+    switch ((seed >> 16) % 4)
+    {
+      case 0:
+        len = snprintf(line, sizeof(line), "%s", "> > ");
+        break;
+      case 1:
+        len = snprintf(line, sizeof(line), "%s", "Subject: Re: ");
+        break;
+      case 2:
+        len = snprintf(line, sizeof(line), "%s", "John Smith, Room 101: ");
+        break;
+      default:
+        break;
+    }
+
+    size_t words = 4 + ((seed >> 8) % 12);
+    for (size_t w = 0; w < words; w++)
+    {
+      seed = (seed * 1103515245) + 12345;
+      const char *word = BenchWords[(seed >> 16) % mutt_array_size(BenchWords)];
+      len += snprintf(line + len, sizeof(line) - len, "%s ", word);
+    }
+
+    lines[i] = mutt_str_strdup(line);
+  }
+
+  return lines;
+}
+
+/**
+ * bench_regex_regexec - Time matching a mailbox using regexec() directly
+ * @param cs    Config items
+ * @param lines Lines of the mailbox
+ * @param num   Number of lines
+ *
+ * This is the baseline, without the prefilter or any other engine.
+ */
+static void bench_regex_regexec(struct ConfigSet *cs, char **lines, size_t num)
+{
+  const struct Regex *regexes[mutt_array_size(BenchRegexNames)] = { 0 };
+  for (size_t i = 0; i < mutt_array_size(BenchRegexNames); i++)
+    regexes[i] = (const struct Regex *) cs_str_native_get(cs, BenchRegexNames[i], NULL);
+
+  size_t matches = 0;
+  struct BenchStats stats = { 0 };
+  bench_start(&stats);
+  for (size_t r = 0; r < BENCH_ROUNDS; r++)
+    for (size_t l = 0; l < num; l++)
+      for (size_t i = 0; i < mutt_array_size(regexes); i++)
+        if (regexes[i])
+          matches += ((regexec(regexes[i]->regex, lines[l], 0, NULL, 0) == 0) ^ regexes[i]->not);
+  bench_stop(&stats);
+
+  bench_report("regexec", &stats, BENCH_ROUNDS * num * mutt_array_size(regexes), "exec");
+  printf("%zu matches\n", matches);
+}
+
+/**
+ * bench_regex_engine - Time matching a mailbox using one engine
+ * @param cs    Config items
+ * @param lines Lines of the mailbox
+ * @param num   Number of lines
+ * @param name  Name of the engine, e.g. "posix"
+ */
+static void bench_regex_engine(struct ConfigSet *cs, char **lines, size_t num,
+                               const char *name)
+{
+  if (!regex_engine_set(name))
+  {
+    printf("%-24s not available\n", name);
+    return;
+  }
+
+  struct Regex *regexes[mutt_array_size(BenchRegexNames)] = { 0 };
+  for (size_t i = 0; i < mutt_array_size(BenchRegexNames); i++)
+  {
+    struct HashElem *he = cs_get_elem(cs, BenchRegexNames[i]);
+    const struct Regex *r = (const struct Regex *) cs_he_native_get(cs, he, NULL);
+    if (!r)
+      continue;
+
+    const struct ConfigDef *cdef = cs_he_base(he)->data;
+    regexes[i] = regex_new(r->pattern, cdef->type, NULL);
+  }
+
+  size_t matches = 0;
+  struct BenchStats stats = { 0 };
+  bench_start(&stats);
+  for (size_t r = 0; r < BENCH_ROUNDS; r++)
+    for (size_t l = 0; l < num; l++)
+      for (size_t i = 0; i < mutt_array_size(regexes); i++)
+        matches += regex_match(regexes[i], lines[l]);
+  bench_stop(&stats);
+
+  char title[64];
+  snprintf(title, sizeof(title), "regex_match (%s)", name);
+  bench_report(title, &stats, BENCH_ROUNDS * num * mutt_array_size(regexes), "exec");
+  printf("%zu matches\n", matches);
+
+  for (size_t i = 0; i < mutt_array_size(regexes); i++)
+    regex_free(&regexes[i]);
+}
+
+/**
+ * bench_regex_prefilter - Time matching a mailbox with and without the prefilter
+ * @param lines Lines of the mailbox
+ * @param num   Number of lines
+ *
+ * Each pattern is timed using regexec() directly, then regex_match(), which
+ * rules out some lines using the prefilter.
+ */
+static void bench_regex_prefilter(char **lines, size_t num)
+{
+  static const char *patterns[] = {
+    "\\<(attach|attached|attachments?)\\>",
+    "patch",
+    ":P",
+    "(m|l)ai",
+    "(>From )|(:[-^]?[][)(><}{|/DP])",
+  };
+
+  for (size_t i = 0; i < mutt_array_size(patterns); i++)
+  {
+    struct Regex *r = regex_new(patterns[i], 0, NULL);
+    printf("prefilter: %s\n", patterns[i]);
+
+    size_t matches = 0;
+    struct BenchStats stats = { 0 };
+    bench_start(&stats);
+    for (size_t n = 0; n < BENCH_ROUNDS; n++)
+      for (size_t l = 0; l < num; l++)
+        matches += (regexec(r->regex, lines[l], 0, NULL, 0) == 0);
+    bench_stop(&stats);
+    bench_report("  regexec", &stats, BENCH_ROUNDS * num, "exec");
+
+    size_t matches_pf = 0;
+    bench_start(&stats);
+    for (size_t n = 0; n < BENCH_ROUNDS; n++)
+      for (size_t l = 0; l < num; l++)
+        matches_pf += regex_match(r, lines[l]);
+    bench_stop(&stats);
+    bench_report("  regex_match", &stats, BENCH_ROUNDS * num, "exec");
+    printf("%zu matches, %zu with the prefilter\n", matches, matches_pf);
+
+    regex_free(&r);
+  }
+}
+
+/**
+ * bench_regex_group - Time matching a mailbox against a RegexGroup
+ * @param lines Lines of the mailbox
+ * @param num   Number of lines
+ *
+ * Several patterns, e.g. those of a set of hooks, are tested against every
+ * line.  Compare matching them separately with matching them as a group.
+ */
+static void bench_regex_group(char **lines, size_t num)
+{
+  static struct Regex *VarGroup[8] = { 0 };
+  // clang-format off
+  static struct ConfigDef Vars[] = {
+    { "group0", DT_REGEX, &VarGroup[0], IP "patch",      0, NULL },
+    { "group1", DT_REGEX, &VarGroup[1], IP "review",     0, NULL },
+    { "group2", DT_REGEX, &VarGroup[2], IP "thanks",     0, NULL },
+    { "group3", DT_REGEX, &VarGroup[3], IP "regards",    0, NULL },
+    { "group4", DT_REGEX, &VarGroup[4], IP "below",      0, NULL },
+    { "group5", DT_REGEX, &VarGroup[5], IP "mail",       0, NULL },
+    { "group6", DT_REGEX, &VarGroup[6], IP "list",       0, NULL },
+    { "group7", DT_REGEX, &VarGroup[7], IP "\\<attach",  0, NULL },
+    { NULL },
+  };
+  // clang-format on
+  const char *names[] = { "group0", "group1", "group2", "group3",
+                          "group4", "group5", "group6", "group7", NULL };
+
+  struct ConfigSet *cs = cs_new(30);
+  regex_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    goto done;
+
+  size_t matches = 0;
+  struct BenchStats stats = { 0 };
+  bench_start(&stats);
+  for (size_t r = 0; r < BENCH_ROUNDS; r++)
+    for (size_t l = 0; l < num; l++)
+      for (size_t i = 0; i < mutt_array_size(VarGroup); i++)
+        matches += regex_match(VarGroup[i], lines[l]);
+  bench_stop(&stats);
+  bench_report("separate (8 regexes)", &stats, BENCH_ROUNDS * num, "line");
+  printf("%zu matches\n", matches);
+
+  struct RegexGroup *group = cs_regex_group_new(cs, names);
+  matches = 0;
+  bench_start(&stats);
+  for (size_t r = 0; r < BENCH_ROUNDS; r++)
+  {
+    for (size_t l = 0; l < num; l++)
+    {
+      for (RegexGroupMatches m = cs_regex_group_match(group, lines[l]); m != 0; m &= (m - 1))
+        matches++;
+    }
+  }
+  bench_stop(&stats);
+  bench_report("regex_group", &stats, BENCH_ROUNDS * num, "line");
+  printf("%zu matches\n", matches);
+  cs_regex_group_free(&group);
+
+done:
+  cs_free(&cs);
+}
+
+/**
+ * bench_regex_hook - Time a folder-hook that sets a Regex on every folder change
+ * @param cs    Config items
+ * @param limit Size of the shared value cache
+ * @param title Name of the benchmark
+ */
+static void bench_regex_hook(struct ConfigSet *cs, size_t limit, const char *title)
+{
+  static const char *patterns[] = {
+    "^((re|aw|sv|antw)(\\[[0-9]+\\])*:[ \t]*)*",
+    "^((re|aw|sv)(\\[[0-9]+\\])*:[ \t]*)*",
+  };
+
+  struct HashElem *he = cs_get_elem(cs, "reply_regex");
+  cs_shared_cache_limit(cs, limit);
+
+  struct SharedStats before = { 0 };
+  struct SharedStats after = { 0 };
+  cs_shared_stats(cs, &before);
+
+  struct BenchStats stats = { 0 };
+  bench_start(&stats);
+  for (size_t r = 0; r < (BENCH_LINES / 10); r++)
+    cs_he_string_set(cs, he, patterns[r % mutt_array_size(patterns)], NULL);
+  bench_stop(&stats);
+
+  cs_shared_stats(cs, &after);
+  bench_report(title, &stats, BENCH_LINES / 10, "set");
+  printf("%zu hits, %zu misses\n", after.hits - before.hits, after.misses - before.misses);
+
+  cs_he_reset(cs, he, NULL);
+  cs_shared_cache_limit(cs, SHARED_CACHE_MAX);
+}
+
+/**
+ * bench_regex - Measure the throughput of the Regex engines
+ *
+ * Using NeoMutt's config, match a synthetic mailbox against several of its
+ * Regexes, using plain regexec(), then once for each engine (with the
+ * prefilter).  Engines that weren't built are skipped.  Time some patterns
+ * with and without the prefilter.  Then, compare matching several Regexes
+ * separately with matching them as a RegexGroup.  Finally, simulate a
+ * folder-hook that keeps resetting reply_regex, with and without the shared
+ * value cache.
+ */
+void bench_regex(void)
+{
+  log_line(__func__);
+
+  char **lines = NULL;
+  struct ConfigSet *cs = bench_config_new();
+  if (!cs)
+    goto done;
+
+  lines = bench_regex_corpus(BENCH_LINES);
+  printf("%d lines, %zu regexes\n", BENCH_LINES, mutt_array_size(BenchRegexNames));
+
+  bench_regex_regexec(cs, lines, BENCH_LINES);
+  bench_regex_engine(cs, lines, BENCH_LINES, "posix");
+  bench_regex_engine(cs, lines, BENCH_LINES, "pcre2");
+  regex_engine_set(NULL);
+  bench_regex_prefilter(lines, BENCH_LINES);
+  bench_regex_group(lines, BENCH_LINES);
+  bench_regex_hook(cs, 0, "folder-hook (no cache)");
+  bench_regex_hook(cs, SHARED_CACHE_MAX, "folder-hook (cache)");
+
+done:
+  for (size_t i = 0; lines && (i < BENCH_LINES); i++)
+    FREE(&lines[i]);
+  FREE(&lines);
+  cs_free(&cs);
+  log_line(__func__);
+}
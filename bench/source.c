@@ -0,0 +1,206 @@
+/**
+ * @file
+ * Benchmarks for reading config from a file
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+#include "dump/data.h"
+#include "test/common.h"
+
+#define BENCH_LINES 100000
+#define BENCH_VALIDATE_FILES 64
+#define BENCH_VALIDATE_LINES 10000
+
+static const char *RcFile = "/tmp/neomutt-bench-source.rc";
+
+/**
+ * write_rc - Generate a large config file
+ * @param cs    Config items
+ * @param path  File to create
+ * @param lines Number of lines to write
+ * @retval true Success
+ *
+ * The file cycles through every config item, setting it to its initial value.
+ * Every so often, an item is reset or toggled instead.
+ */
+static bool write_rc(struct ConfigSet *cs, const char *path, size_t lines)
+{
+  FILE *fp = fopen(path, "w");
+  if (!fp)
+    return false;
+
+  struct Buffer *value = mutt_buffer_alloc(1024);
+  struct Buffer *quoted = mutt_buffer_alloc(1024);
+
+  size_t count = 0;
+  for (size_t i = 0; count < lines; i++)
+  {
+    const struct ConfigDef *cdef = &MuttVars[i];
+    if (!cdef->name)
+    {
+      i = -1;
+      continue;
+    }
+
+    const int type = DTYPE(cdef->type);
+    if (type == DT_SYNONYM)
+      continue;
+
+    if ((count % 10) == 9)
+    {
+      if ((type == DT_BOOL) || (type == DT_QUAD))
+        fprintf(fp, "toggle %s\n", cdef->name);
+      else
+        fprintf(fp, "reset %s\n", cdef->name);
+    }
+    else if ((type == DT_BOOL) || (type == DT_QUAD))
+    {
+      fprintf(fp, "set %s%s\n", (count % 2) ? "no" : "", cdef->name);
+    }
+    else
+    {
+      mutt_buffer_reset(value);
+      mutt_buffer_reset(quoted);
+      cs_str_initial_get(cs, cdef->name, value);
+      /* Some items may not be set to an empty string */
+      if (mutt_buffer_is_empty(value))
+      {
+        fprintf(fp, "reset %s\n", cdef->name);
+      }
+      else
+      {
+        pretty_var(mutt_b2s(value), quoted);
+        fprintf(fp, "set %s = %s\n", cdef->name, mutt_b2s(quoted));
+      }
+    }
+    count++;
+  }
+
+  mutt_buffer_free(&value);
+  mutt_buffer_free(&quoted);
+  return (fclose(fp) == 0);
+}
+
+/**
+ * bench_source - Time cs_source_file() on a large config file
+ */
+void bench_source(void)
+{
+  log_line(__func__);
+
+  struct Buffer *err = mutt_buffer_alloc(256);
+  struct ConfigSet *cs = bench_config_new();
+  if (!cs)
+    goto done;
+
+  if (!write_rc(cs, RcFile, BENCH_LINES))
+  {
+    printf("Can't create %s\n", RcFile);
+    goto done;
+  }
+
+  struct BenchStats stats = { 0 };
+  bench_start(&stats);
+  int errors = cs_source_file(cs, RcFile, err);
+  bench_stop(&stats);
+  unlink(RcFile);
+
+  if (errors != 0)
+    printf("%d errors, first: %s\n", errors, mutt_b2s(err));
+
+  bench_report("cs_source_file", &stats, BENCH_LINES, "line");
+
+done:
+  cs_free(&cs);
+  mutt_buffer_free(&err);
+  log_line(__func__);
+}
+
+/**
+ * bench_validate - Time cs_validate_files() on many config files
+ *
+ * The same files are validated by one thread, then by one thread per CPU.
+ */
+void bench_validate(void)
+{
+  log_line(__func__);
+
+  char paths[BENCH_VALIDATE_FILES][64];
+  struct ValidateResult files[BENCH_VALIDATE_FILES];
+  memset(paths, 0, sizeof(paths));
+  memset(files, 0, sizeof(files));
+
+  struct ConfigSet *cs = bench_config_new();
+  if (!cs)
+    goto done;
+
+  for (size_t i = 0; i < BENCH_VALIDATE_FILES; i++)
+  {
+    snprintf(paths[i], sizeof(paths[i]), "/tmp/neomutt-bench-validate-%zu.rc", i);
+    if (!write_rc(cs, paths[i], BENCH_VALIDATE_LINES))
+    {
+      printf("Can't create %s\n", paths[i]);
+      goto done;
+    }
+  }
+
+  static const int threads[] = { 1, 0 };
+  for (size_t t = 0; t < mutt_array_size(threads); t++)
+  {
+    cs_validate_free(files, BENCH_VALIDATE_FILES);
+    memset(files, 0, sizeof(files));
+    for (size_t i = 0; i < BENCH_VALIDATE_FILES; i++)
+      files[i].path = paths[i];
+
+    struct BenchStats stats = { 0 };
+    bench_start(&stats);
+    size_t errors = cs_validate_files(cs, files, BENCH_VALIDATE_FILES, threads[t]);
+    bench_stop(&stats);
+
+    for (size_t i = 0; i < BENCH_VALIDATE_FILES; i++)
+    {
+      if (files[i].errors != 0)
+        printf("%s", mutt_b2s(files[i].err));
+    }
+    if (errors != 0)
+      printf("%zu errors\n", errors);
+
+    bench_report((threads[t] == 1) ? "cs_validate_files (1)" : "cs_validate_files (all)",
+                 &stats, BENCH_VALIDATE_FILES * BENCH_VALIDATE_LINES, "line");
+  }
+
+done:
+  cs_validate_free(files, BENCH_VALIDATE_FILES);
+  for (size_t i = 0; i < BENCH_VALIDATE_FILES; i++)
+  {
+    if (paths[i][0] != '\0')
+      unlink(paths[i]);
+  }
+  cs_free(&cs);
+  log_line(__func__);
+}
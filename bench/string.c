@@ -0,0 +1,128 @@
+/**
+ * @file
+ * Benchmarks for String config items
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+#include "dump/data.h"
+#include "test/common.h"
+
+#define BENCH_ROUNDS 1000
+
+/**
+ * bench_string_set - Time setting every String to a new value
+ * @param cs    Config items
+ * @param hes   String config items
+ * @param num   Number of items
+ * @param title Name of the benchmark
+ * @param pad   Length to pad the values to
+ *
+ * Every value is different, so none of them can share storage.
+ */
+static void bench_string_set(struct ConfigSet *cs, struct HashElem **hes,
+                             size_t num, const char *title, int pad)
+{
+  char value[128];
+  struct BenchStats stats = { 0 };
+
+  bench_start(&stats);
+  for (size_t r = 0; r < BENCH_ROUNDS; r++)
+  {
+    for (size_t i = 0; i < num; i++)
+    {
+      snprintf(value, sizeof(value), "%*zu.%zu", pad, r, i);
+      cs_he_native_set(cs, hes[i], IP value, NULL);
+    }
+  }
+  bench_stop(&stats);
+  bench_report(title, &stats, BENCH_ROUNDS * num, "set");
+}
+
+/**
+ * bench_string_heap - Report the heap in use
+ * @param start Measurements taken before any values were set
+ * @param num   Number of items
+ */
+static void bench_string_heap(const struct BenchStats *start, size_t num)
+{
+  struct BenchStats stats = *start;
+  bench_stop(&stats);
+  printf("%-24s %8.1f bytes/item\n", "heap in use",
+         (double) (stats.heap_bytes - stats.heap_freed) / num);
+}
+
+/**
+ * bench_string - Measure the cost of String config items
+ *
+ * Using NeoMutt's config, repeatedly set every String to a short value, then
+ * to a long one, reporting the time, allocations and the memory in use.
+ * Items with a validator are skipped.
+ */
+void bench_string(void)
+{
+  log_line(__func__);
+
+  struct HashElem **hes = NULL;
+  struct ConfigSet *cs = bench_config_new();
+  if (!cs)
+    goto done;
+
+  size_t num = 0;
+  for (size_t i = 0; MuttVars[i].name; i++)
+  {
+    const struct ConfigDef *cdef = &MuttVars[i];
+    if ((DTYPE(cdef->type) != DT_STRING) || cdef->validator)
+      continue;
+
+    mutt_mem_realloc(&hes, (num + 1) * sizeof(struct HashElem *));
+    hes[num++] = cs_get_elem(cs, cdef->name);
+  }
+  printf("%zu String items\n", num);
+
+  struct BenchStats heap = { 0 };
+  bench_start(&heap);
+  bench_string_set(cs, hes, num, "string_set (short)", 0);
+  bench_string_heap(&heap, num);
+
+  struct BenchStats stats = { 0 };
+  size_t total = 0;
+  bench_start(&stats);
+  for (size_t r = 0; r < BENCH_ROUNDS; r++)
+    for (size_t i = 0; i < num; i++)
+      total += strlen((const char *) cs_he_native_get(cs, hes[i], NULL));
+  bench_stop(&stats);
+  bench_report("native_get", &stats, BENCH_ROUNDS * num, "get");
+  printf("checksum %zu\n", total);
+
+  bench_string_set(cs, hes, num, "string_set (long)", 40);
+  bench_string_heap(&heap, num);
+
+done:
+  FREE(&hes);
+  cs_free(&cs);
+  log_line(__func__);
+}
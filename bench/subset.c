@@ -0,0 +1,148 @@
+/**
+ * @file
+ * Benchmarks for config subsets
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+#include "test/common.h"
+
+static short VarApple;
+static short VarBanana;
+static short VarCherry;
+static short VarDamson;
+static short VarElderberry;
+static short VarFig;
+static short VarGuava;
+static short VarHawthorn;
+static short VarIlama;
+static short VarJackfruit;
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",      DT_NUMBER, &VarApple,      1,  0, NULL },
+  { "Banana",     DT_NUMBER, &VarBanana,     2,  0, NULL },
+  { "Cherry",     DT_NUMBER, &VarCherry,     3,  0, NULL },
+  { "Damson",     DT_NUMBER, &VarDamson,     4,  0, NULL },
+  { "Elderberry", DT_NUMBER, &VarElderberry, 5,  0, NULL },
+  { "Fig",        DT_NUMBER, &VarFig,        6,  0, NULL },
+  { "Guava",      DT_NUMBER, &VarGuava,      7,  0, NULL },
+  { "Hawthorn",   DT_NUMBER, &VarHawthorn,   8,  0, NULL },
+  { "Ilama",      DT_NUMBER, &VarIlama,      9,  0, NULL },
+  { "Jackfruit",  DT_NUMBER, &VarJackfruit,  10, 0, NULL },
+  { NULL },
+};
+// clang-format on
+
+static const char *VarNames[] = {
+  "Apple", "Banana", "Cherry", "Damson",    "Elderberry",
+  "Fig",   "Guava",  "Hawthorn", "Ilama", "Jackfruit", NULL,
+};
+
+/**
+ * bench_subset_one - Time the creation of many Subsets
+ * @param count  Number of Subsets to create
+ * @param sparse If true, create sparse Subsets
+ */
+static void bench_subset_one(size_t count, bool sparse)
+{
+  const size_t num_vars = mutt_array_size(VarNames) - 1;
+
+  struct ConfigSet *cs = cs_new(count * num_vars * 2);
+  number_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+  {
+    cs_free(&cs);
+    return;
+  }
+
+  struct ConfigSubset **subs = mutt_mem_calloc(count, sizeof(struct ConfigSubset *));
+  struct ConfigSubset *account = NULL;
+  char name[32];
+
+  struct BenchStats stats = { 0 };
+  bench_start(&stats);
+  if (sparse)
+    account = cs_subset_new_sparse(cs, "ac", NULL, VarNames);
+  else
+    account = cs_subset_new(cs, "ac", NULL, VarNames);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    snprintf(name, sizeof(name), "mbox%zu", i);
+    if (sparse)
+      subs[i] = cs_subset_new_sparse(cs, name, account, VarNames);
+    else
+      subs[i] = cs_subset_new(cs, name, "ac", VarNames);
+  }
+  bench_stop(&stats);
+
+  char title[64];
+  snprintf(title, sizeof(title), "%s subset_new", sparse ? "sparse" : "eager");
+  bench_report(title, &stats, count, "subset");
+
+  /* Override one value in 1% of the mailboxes */
+  bench_start(&stats);
+  size_t written = 0;
+  for (size_t i = 0; i < count; i += 100, written++)
+    cs_subset_string_set(subs[i], i % num_vars, "42", NULL);
+  bench_stop(&stats);
+  snprintf(title, sizeof(title), "%s string_set (1%%)", sparse ? "sparse" : "eager");
+  bench_report(title, &stats, written, "set");
+
+  bench_quiet(true);
+  bench_start(&stats);
+  for (size_t i = 0; i < count; i++)
+    cs_subset_free(&subs[i]);
+  cs_subset_free(&account);
+  bench_stop(&stats);
+  bench_quiet(false);
+  snprintf(title, sizeof(title), "%s subset_free", sparse ? "sparse" : "eager");
+  bench_report(title, &stats, count, "subset");
+
+  FREE(&subs);
+  cs_free(&cs);
+}
+
+/**
+ * bench_subset - Compare eager and sparse Subsets
+ *
+ * For 1,000, 10,000 and 100,000 mailbox Subsets, each with ten config items,
+ * report the time, allocations and memory taken to create them.
+ */
+void bench_subset(void)
+{
+  log_line(__func__);
+
+  static const size_t counts[] = { 1000, 10000, 100000 };
+  for (size_t i = 0; i < mutt_array_size(counts); i++)
+  {
+    printf("%zu subsets\n", counts[i]);
+    bench_subset_one(counts[i], false);
+    bench_subset_one(counts[i], true);
+  }
+
+  log_line(__func__);
+}
@@ -25,6 +25,16 @@
  * @page config_address Type: Email address
  *
  * Type representing an email address.
+ *
+ * The config item's value is the first address in the string, but every
+ * address is kept.  The first time they're needed, the addresses are
+ * converted for sending (IDN-encoded) and for display (decoded) and the
+ * results are kept, so users don't have to convert them again.  The Address
+ * is shared, so the work is done once for all the scopes that use the same
+ * value.
+ *
+ * The conversions depend on `$idn_encode` and `$idn_decode`.  If either
+ * changes, the conversions are redone when they're next used.
  */
 
 #include "config.h"
@@ -36,9 +46,177 @@
 #include "address/lib.h"
 #include "email/lib.h"
 #include "address.h"
+#include "intern.h"
 #include "set.h"
+#include "shared.h"
 #include "types.h"
 
+static unsigned int AddressIdnGeneration = 1; ///< Incremented when $idn_encode or $idn_decode changes
+
+/**
+ * struct ConfigAddress - An Address config item, with its conversions
+ *
+ * The Address must be first, so a pointer to it is a pointer to the
+ * ConfigAddress.
+ */
+struct ConfigAddress
+{
+  struct Address addr;      ///< First address, the config item's value
+  struct AddressList all;   ///< Every address that was parsed
+  struct AddressList intl;  ///< Every address, IDN-encoded for sending
+  struct AddressList local; ///< Every address, decoded for display
+  bool intl_ok;             ///< All the addresses could be IDN-encoded
+  unsigned int generation;  ///< AddressIdnGeneration of the conversions, 0 if not done
+  char *str;                ///< First address, written
+  char *display;            ///< Every address, written for display
+};
+
+/**
+ * address_from_list - Create an Address from a parsed list
+ * @param al AddressList (the caller's list is emptied)
+ * @retval ptr New Address, the first in the list
+ */
+static struct Address *address_from_list(struct AddressList *al)
+{
+  struct Address *first = TAILQ_FIRST(al);
+  if (!first)
+    return NULL;
+
+  struct ConfigAddress *ca = mutt_mem_calloc(1, sizeof(*ca));
+  ca->addr.personal = mutt_str_strdup(first->personal);
+  ca->addr.mailbox = mutt_str_strdup(first->mailbox);
+  ca->addr.group = first->group;
+
+  TAILQ_INIT(&ca->all);
+  TAILQ_CONCAT(&ca->all, al, entries);
+  TAILQ_INIT(&ca->intl);
+  TAILQ_INIT(&ca->local);
+
+  char tmp[8192] = { 0 };
+  mutt_addr_write(tmp, sizeof(tmp), &ca->addr, false);
+  ca->str = mutt_str_strdup(tmp);
+
+  return &ca->addr;
+}
+
+/**
+ * address_convert - Convert the addresses for sending and display
+ * @param ca ConfigAddress
+ *
+ * If the conversions were made with the current IDN settings, nothing is done.
+ */
+static void address_convert(struct ConfigAddress *ca)
+{
+  if (ca->generation == AddressIdnGeneration)
+    return;
+
+  mutt_addrlist_clear(&ca->intl);
+  mutt_addrlist_copy(&ca->intl, &ca->all, false);
+  char *err = NULL;
+  ca->intl_ok = (mutt_addrlist_to_intl(&ca->intl, &err) == 0);
+  FREE(&err);
+
+  mutt_addrlist_clear(&ca->local);
+  mutt_addrlist_copy(&ca->local, &ca->all, false);
+  mutt_addrlist_to_local(&ca->local);
+
+  char tmp[8192] = { 0 };
+  mutt_addrlist_write(tmp, sizeof(tmp), &ca->local, true);
+  mutt_str_replace(&ca->display, tmp);
+
+  ca->generation = AddressIdnGeneration;
+}
+
+/**
+ * address_idn_observer - Notice changes to the IDN settings - Implements ::observer_t
+ */
+static int address_idn_observer(struct NotifyCallback *nc)
+{
+  if (!nc || (nc->event_type != NT_CONFIG))
+    return -1;
+
+  struct EventConfig *ec = (struct EventConfig *) nc->event;
+  if (!ec->he)
+    return 0;
+
+  const char *name = cs_he_base(ec->he)->key.strkey;
+  if ((mutt_str_strcmp(name, "idn_encode") == 0) || (mutt_str_strcmp(name, "idn_decode") == 0))
+    AddressIdnGeneration++;
+
+  return 0;
+}
+
+/**
+ * address_config_free - Free an Address created by address_from_list()
+ * @param[out] addr Address to free
+ */
+static void address_config_free(struct Address **addr)
+{
+  if (!addr || !*addr)
+    return;
+
+  struct ConfigAddress *ca = (struct ConfigAddress *) *addr;
+  mutt_addrlist_clear(&ca->all);
+  mutt_addrlist_clear(&ca->intl);
+  mutt_addrlist_clear(&ca->local);
+  FREE(&ca->str);
+  FREE(&ca->display);
+  FREE(&ca->addr.personal);
+  FREE(&ca->addr.mailbox);
+  FREE(addr);
+}
+
+/**
+ * address_copy - Create an Address from another one
+ * @param addr Address to copy
+ * @retval ptr New Address
+ */
+static struct Address *address_copy(const struct Address *addr)
+{
+  struct AddressList al = TAILQ_HEAD_INITIALIZER(al);
+  mutt_addrlist_append(&al, mutt_addr_copy(addr));
+  return address_from_list(&al);
+}
+
+/**
+ * address_shared_free - Free a shared Address - Implements ::shared_free_t
+ */
+static void address_shared_free(void **obj)
+{
+  address_config_free((struct Address **) obj);
+}
+
+/**
+ * address_shared - Share an Address
+ * @param cs   Config items
+ * @param addr Address to share (the caller's reference is taken over)
+ * @retval ptr Shared Address, with a new reference
+ *
+ * If an identical Address is already in use, addr is freed and the existing
+ * one is returned.
+ */
+static struct Address *address_shared(const struct ConfigSet *cs, struct Address *addr)
+{
+  if (!addr)
+    return NULL;
+
+  /* Addresses that differ after the first can't be shared */
+  const struct ConfigAddress *ca = (const struct ConfigAddress *) addr;
+  struct Buffer *key = mutt_buffer_alloc(256);
+  mutt_buffer_addstr(key, "address:");
+  const struct Address *a = NULL;
+  TAILQ_FOREACH(a, &ca->all, entries)
+  {
+    mutt_buffer_addstr(key, NONULL(a->personal));
+    mutt_buffer_addch(key, '\x1f');
+    mutt_buffer_addstr(key, NONULL(a->mailbox));
+    mutt_buffer_addch(key, '\x1e');
+  }
+  addr = cs_shared_add(cs, mutt_b2s(key), addr, address_shared_free);
+  mutt_buffer_free(&key);
+  return addr;
+}
+
 /**
  * address_destroy - Destroy an Address object - Implements ::cst_destroy()
  */
@@ -51,7 +229,8 @@ static void address_destroy(const struct ConfigSet *cs, void *var, const struct
   if (!*a)
     return;
 
-  address_free(a);
+  if (!cs_shared_release(cs, var))
+    address_config_free(a);
 }
 
 /**
@@ -68,10 +247,9 @@ static int address_string_set(const struct ConfigSet *cs, void *var, struct Conf
   /* An empty address "" will be stored as NULL */
   if (var && value && (value[0] != '\0'))
   {
-    // TODO - config can only store one
     struct AddressList al = TAILQ_HEAD_INITIALIZER(al);
     mutt_addrlist_parse(&al, value);
-    addr = mutt_addr_copy(TAILQ_FIRST(&al));
+    addr = address_shared(cs, address_from_list(&al));
     mutt_addrlist_clear(&al);
   }
 
@@ -101,11 +279,7 @@ static int address_string_set(const struct ConfigSet *cs, void *var, struct Conf
   else
   {
     /* set the default/initial value */
-    if (cdef->type & DT_INITIAL_SET)
-      FREE(&cdef->initial);
-
-    cdef->type |= DT_INITIAL_SET;
-    cdef->initial = IP mutt_str_strdup(value);
+    cs_intern_initial(cs, cdef, value);
   }
 
   return rc;
@@ -120,17 +294,13 @@ static int address_string_get(const struct ConfigSet *cs, void *var,
   if (!cs || !cdef)
     return CSR_ERR_CODE; /* LCOV_EXCL_LINE */
 
-  char tmp[8192] = { 0 };
   const char *str = NULL;
 
   if (var)
   {
-    struct Address *a = *(struct Address **) var;
-    if (a)
-    {
-      mutt_addr_write(tmp, sizeof(tmp), a, false);
-      str = tmp;
-    }
+    struct ConfigAddress *ca = *(struct ConfigAddress **) var;
+    if (ca)
+      str = ca->str;
   }
   else
   {
@@ -144,22 +314,6 @@ static int address_string_get(const struct ConfigSet *cs, void *var,
   return CSR_SUCCESS;
 }
 
-/**
- * address_dup - Create a copy of an Address object
- * @param addr Address to duplicate
- * @retval ptr New Address object
- */
-static struct Address *address_dup(struct Address *addr)
-{
-  if (!addr)
-    return NULL; /* LCOV_EXCL_LINE */
-
-  struct Address *a = mutt_mem_calloc(1, sizeof(*a));
-  a->personal = mutt_str_strdup(addr->personal);
-  a->mailbox = mutt_str_strdup(addr->mailbox);
-  return a;
-}
-
 /**
  * address_native_set - Set an Address config item by Address object - Implements ::cst_native_set()
  */
@@ -180,9 +334,11 @@ static int address_native_set(const struct ConfigSet *cs, void *var,
       return rc | CSR_INV_VALIDATOR;
   }
 
-  address_free(var);
+  struct Address *addr = (struct Address *) value;
+  if (addr && !cs_shared_ref(cs, addr))
+    addr = address_shared(cs, address_copy(addr));
 
-  struct Address *addr = address_dup((struct Address *) value);
+  address_destroy(cs, var, cdef);
 
   rc = CSR_SUCCESS;
   if (!addr)
@@ -219,7 +375,11 @@ static int address_reset(const struct ConfigSet *cs, void *var,
   const char *initial = (const char *) cdef->initial;
 
   if (initial)
-    a = address_new(initial);
+  {
+    struct Address tmp = { 0 };
+    tmp.mailbox = (char *) initial;
+    a = address_shared(cs, address_copy(&tmp));
+  }
 
   int rc = CSR_SUCCESS;
 
@@ -255,6 +415,7 @@ void address_init(struct ConfigSet *cs)
     address_destroy,
   };
   cs_register_type(cs, DT_ADDRESS, &cst_address);
+  notify_observer_add(cs->notify, NT_CONFIG, 0, address_idn_observer, 0);
 }
 
 /**
@@ -265,14 +426,15 @@ void address_init(struct ConfigSet *cs)
 struct Address *address_new(const char *addr)
 {
   struct Address *a = mutt_mem_calloc(1, sizeof(*a));
-  // a->personal = mutt_str_strdup(addr);
   a->mailbox = mutt_str_strdup(addr);
   return a;
 }
 
 /**
  * address_free - Free an Address object
- * @param[out] addr Address to free
+ * @param[out] addr Address to free, created by address_new()
+ *
+ * Addresses belonging to config items are freed by the ConfigSet.
  */
 void address_free(struct Address **addr)
 {
@@ -283,3 +445,68 @@ void address_free(struct Address **addr)
   FREE(&(*addr)->mailbox);
   FREE(addr);
 }
+
+/**
+ * address_list - Get every address in an Address config item
+ * @param addr Address, from cs_he_native_get()
+ * @retval ptr AddressList
+ */
+const struct AddressList *address_list(const struct Address *addr)
+{
+  if (!addr)
+    return NULL;
+
+  return &((const struct ConfigAddress *) addr)->all;
+}
+
+/**
+ * address_intl - Get every address in an Address config item, for sending
+ * @param addr Address, from cs_he_native_get()
+ * @retval ptr  AddressList, IDN-encoded
+ * @retval NULL An address couldn't be encoded
+ *
+ * The list is only valid until the IDN settings change.
+ */
+const struct AddressList *address_intl(struct Address *addr)
+{
+  if (!addr)
+    return NULL;
+
+  struct ConfigAddress *ca = (struct ConfigAddress *) addr;
+  address_convert(ca);
+  return ca->intl_ok ? &ca->intl : NULL;
+}
+
+/**
+ * address_local - Get every address in an Address config item, decoded
+ * @param addr Address, from cs_he_native_get()
+ * @retval ptr AddressList
+ *
+ * The list is only valid until the IDN settings change.
+ */
+const struct AddressList *address_local(struct Address *addr)
+{
+  if (!addr)
+    return NULL;
+
+  struct ConfigAddress *ca = (struct ConfigAddress *) addr;
+  address_convert(ca);
+  return &ca->local;
+}
+
+/**
+ * address_display - Get every address in an Address config item, for display
+ * @param addr Address, from cs_he_native_get()
+ * @retval ptr String, e.g. "Rose <rose@example.com>, bob@example.com"
+ *
+ * The string is only valid until the IDN settings change.
+ */
+const char *address_display(struct Address *addr)
+{
+  if (!addr)
+    return NULL;
+
+  struct ConfigAddress *ca = (struct ConfigAddress *) addr;
+  address_convert(ca);
+  return ca->display;
+}
@@ -24,10 +24,16 @@
 #define MUTT_CONFIG_ADDRESS_H
 
 struct Address;
+struct AddressList;
 struct ConfigSet;
 
 void address_init(struct ConfigSet *cs);
 struct Address *address_new(const char *addr);
 void address_free(struct Address **addr);
 
+const struct AddressList *address_list   (const struct Address *addr);
+const struct AddressList *address_intl   (struct Address *addr);
+const struct AddressList *address_local  (struct Address *addr);
+const char *              address_display(struct Address *addr);
+
 #endif /* MUTT_CONFIG_ADDRESS_H */
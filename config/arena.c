@@ -0,0 +1,221 @@
+/**
+ * @file
+ * Region allocator for config data
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_arena Region allocator for config data
+ *
+ * An Arena hands out memory from large blocks.  Individual allocations are
+ * never returned to the system; the whole Arena is released at once, by
+ * arena_free().
+ *
+ * A ConfigSet created with #CS_ARENA uses one for its metadata (inherited
+ * items) and its immutable values (interned strings).  This saves thousands
+ * of small allocations at startup, and frees.
+ *
+ * Released memory is kept on a free list for its size, so an Account that's
+ * removed and recreated, e.g. on reconnect, reuses its old inherited items
+ * rather than growing the Arena.  Allocations larger than #ARENA_FREE_MAX
+ * aren't reused.
+ *
+ * The Arena has its own lock, so it may be used by several threads at once,
+ * e.g. while validating config files in parallel, see cs_validate_files().
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <pthread.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "arena.h"
+
+#define ARENA_ALIGN (2 * sizeof(void *))
+#define ARENA_ROUND(x) (((x) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+/**
+ * struct ArenaBlock - A block of memory in an Arena
+ */
+struct ArenaBlock
+{
+  struct ArenaBlock *next; ///< Next (older) block
+  size_t size;             ///< Usable size of the block
+  size_t used;             ///< Bytes handed out
+};
+
+#define ARENA_FREE_MAX     512 ///< Largest allocation that's reused when released
+#define ARENA_FREE_CLASSES (ARENA_FREE_MAX / ARENA_ALIGN) ///< Number of free lists
+
+/* The memory follows the (padded) block header */
+#define ARENA_HEADER ARENA_ROUND(sizeof(struct ArenaBlock))
+
+/**
+ * struct Arena - A region allocator
+ */
+struct Arena
+{
+  struct ArenaBlock *blocks;      ///< Blocks, newest first
+  size_t block_size;              ///< Default size of a new block
+  size_t total;                   ///< Total bytes handed out
+  void *free[ARENA_FREE_CLASSES]; ///< Released memory, by size, see #ARENA_FREE_MAX
+  pthread_mutex_t lock;           ///< Protects the blocks, counters and free lists
+};
+
+/**
+ * arena_new - Create an Arena
+ * @param block_size Size of each block, 0 for the default
+ * @retval ptr New Arena
+ */
+struct Arena *arena_new(size_t block_size)
+{
+  struct Arena *a = mutt_mem_calloc(1, sizeof(*a));
+  a->block_size = (block_size > 0) ? block_size : ARENA_BLOCK_SIZE;
+  pthread_mutex_init(&a->lock, NULL);
+  return a;
+}
+
+/**
+ * arena_free - Free an Arena and everything allocated from it
+ * @param[out] ptr Arena to free
+ */
+void arena_free(struct Arena **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct Arena *a = *ptr;
+  struct ArenaBlock *b = a->blocks;
+  while (b)
+  {
+    struct ArenaBlock *next = b->next;
+    FREE(&b);
+    b = next;
+  }
+
+  pthread_mutex_destroy(&a->lock);
+  FREE(ptr);
+}
+
+/**
+ * arena_calloc - Allocate zeroed memory
+ * @param a    Arena, may be NULL
+ * @param size Number of bytes
+ * @retval ptr Memory, aligned for any type
+ *
+ * If there's no Arena, this is a plain mutt_mem_calloc().
+ */
+void *arena_calloc(struct Arena *a, size_t size)
+{
+  if (!a)
+    return mutt_mem_calloc(1, size);
+
+  size = ARENA_ROUND(size);
+
+  pthread_mutex_lock(&a->lock);
+
+  /* Reuse released memory of the same size */
+  const size_t cls = (size / ARENA_ALIGN) - 1;
+  if ((cls < ARENA_FREE_CLASSES) && a->free[cls])
+  {
+    void *mem = a->free[cls];
+    a->free[cls] = *(void **) mem;
+    pthread_mutex_unlock(&a->lock);
+    memset(mem, 0, size);
+    return mem;
+  }
+
+  struct ArenaBlock *b = a->blocks;
+  if (!b || ((b->size - b->used) < size))
+  {
+    /* Large allocations get a block of their own, behind the current one */
+    size_t bsize = MAX(size, a->block_size);
+    struct ArenaBlock *nb = mutt_mem_calloc(1, ARENA_HEADER + bsize);
+    nb->size = bsize;
+    if (b && (size > (a->block_size / 4)))
+    {
+      nb->next = b->next;
+      b->next = nb;
+    }
+    else
+    {
+      nb->next = b;
+      a->blocks = nb;
+    }
+    b = nb;
+  }
+
+  void *mem = (char *) b + ARENA_HEADER + b->used;
+  b->used += size;
+  a->total += size;
+  pthread_mutex_unlock(&a->lock);
+  return mem;
+}
+
+/**
+ * arena_release - Release memory allocated by arena_calloc()
+ * @param[in]  a    Arena, may be NULL
+ * @param[out] ptr  Memory to release
+ * @param[in]  size Size passed to arena_calloc()
+ *
+ * Small allocations are reused by the next arena_calloc() of the same size.
+ * Other memory in an Arena is only reclaimed by arena_free().  If there's no
+ * Arena, the memory is freed.
+ */
+void arena_release(struct Arena *a, void *ptr, size_t size)
+{
+  if (!ptr)
+    return;
+
+  if (!a)
+  {
+    FREE(ptr);
+    return;
+  }
+
+  void *mem = *(void **) ptr;
+  *(void **) ptr = NULL;
+  if (!mem || (size == 0))
+    return;
+
+  const size_t cls = (ARENA_ROUND(size) / ARENA_ALIGN) - 1;
+  if (cls >= ARENA_FREE_CLASSES)
+    return;
+
+  pthread_mutex_lock(&a->lock);
+  *(void **) mem = a->free[cls];
+  a->free[cls] = mem;
+  pthread_mutex_unlock(&a->lock);
+}
+
+/**
+ * arena_used - How much memory has been handed out?
+ * @param a Arena
+ * @retval num Bytes
+ */
+size_t arena_used(struct Arena *a)
+{
+  if (!a)
+    return 0;
+
+  pthread_mutex_lock(&a->lock);
+  size_t total = a->total;
+  pthread_mutex_unlock(&a->lock);
+  return total;
+}
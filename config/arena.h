@@ -0,0 +1,38 @@
+/**
+ * @file
+ * Region allocator for config data
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_ARENA_H
+#define MUTT_CONFIG_ARENA_H
+
+#include <stddef.h>
+
+struct Arena;
+
+#define ARENA_BLOCK_SIZE (64 * 1024) ///< Default size of an Arena block
+
+struct Arena *arena_new    (size_t block_size);
+void          arena_free   (struct Arena **ptr);
+void *        arena_calloc (struct Arena *a, size_t size);
+void          arena_release(struct Arena *a, void *ptr, size_t size);
+size_t        arena_used   (struct Arena *a);
+
+#endif /* MUTT_CONFIG_ARENA_H */
@@ -0,0 +1,479 @@
+/**
+ * @file
+ * Spot regexes that may be slow to match
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_complexity Spot regexes that may be slow to match
+ *
+ * A (POSIX extended) pattern is analysed, without compiling it, for the
+ * constructs that make matching super-linear in the length of the string.
+ *
+ * - A back-reference, e.g. `(.*)\1`.  glibc's regexec() takes roughly cubic
+ *   time, backtracking engines exponential time.
+ * - A repeated group containing a repetition, e.g. `(a+)+` or `(\w+\s?)*`,
+ *   where the string can be split between the iterations in many ways.
+ *   glibc takes quadratic time, backtracking engines exponential time.
+ *
+ * A nested repetition is safe if each iteration of the group must match a
+ * character that the inner repetitions can't, e.g. the `>` in
+ * `^([ \t]*>)+`.  Counted repetitions larger than #COMPLEXITY_REPEAT_MAX are
+ * treated like `*`.
+ *
+ * The analysis is conservative: character sets are over-estimated, so a
+ * pattern may be flagged unnecessarily, but not the other way round.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "complexity.h"
+
+#define COMPLEXITY_GUARDS 8 ///< Most guards remembered for a sub-expression
+
+/**
+ * struct ComplexityInfo - What's known about a sub-expression
+ *
+ * A guard is the set of bytes of an atom that every match must contain.
+ */
+struct ComplexityInfo
+{
+  uint8_t chars[32];                        ///< Bitmap of the bytes any atom can match
+  uint8_t repeated[32];                     ///< Bitmap of the bytes matched by unbounded repetitions
+  bool has_repeat;                          ///< Contains an unbounded repetition
+  uint8_t guards[COMPLEXITY_GUARDS][32];    ///< Bitmaps of mandatory atoms
+  size_t num_guards;                        ///< Number of guards
+  enum RegexRisk risk;                      ///< Worst construct found
+};
+
+/**
+ * struct ComplexityParser - State of the pattern parser
+ */
+struct ComplexityParser
+{
+  const char *p; ///< Current position in the pattern
+  int depth;     ///< Number of open groups
+};
+
+static void complexity_alt(struct ComplexityParser *ps, struct ComplexityInfo *info);
+
+/**
+ * set_add - Add a byte, and its other case, to a bitmap
+ * @param set Bitmap
+ * @param c   Byte
+ */
+static void set_add(uint8_t *set, unsigned char c)
+{
+  set[c >> 3] |= (1 << (c & 7));
+  if (c < 0x80)
+  {
+    unsigned char o = isupper(c) ? tolower(c) : toupper(c);
+    set[o >> 3] |= (1 << (o & 7));
+  }
+}
+
+/**
+ * set_add_high - Add all the non-ASCII bytes to a bitmap
+ * @param set Bitmap
+ */
+static void set_add_high(uint8_t *set)
+{
+  memset(set + 16, 0xff, 16);
+}
+
+/**
+ * set_union - Add one bitmap to another
+ * @param dst Bitmap to add to
+ * @param src Bitmap to add
+ */
+static void set_union(uint8_t *dst, const uint8_t *src)
+{
+  for (size_t i = 0; i < 32; i++)
+    dst[i] |= src[i];
+}
+
+/**
+ * set_disjoint - Do two bitmaps have no bytes in common?
+ * @param a First bitmap
+ * @param b Second bitmap
+ * @retval true The bitmaps don't overlap
+ */
+static bool set_disjoint(const uint8_t *a, const uint8_t *b)
+{
+  for (size_t i = 0; i < 32; i++)
+    if (a[i] & b[i])
+      return false;
+  return true;
+}
+
+/**
+ * set_empty - Is a bitmap empty?
+ * @param set Bitmap
+ * @retval true No bytes are set
+ */
+static bool set_empty(const uint8_t *set)
+{
+  for (size_t i = 0; i < 32; i++)
+    if (set[i])
+      return false;
+  return true;
+}
+
+/**
+ * info_guard - Add a guard to a sub-expression
+ * @param info Info to update
+ * @param set  Bytes of a mandatory atom
+ */
+static void info_guard(struct ComplexityInfo *info, const uint8_t *set)
+{
+  if ((info->num_guards < COMPLEXITY_GUARDS) && !set_empty(set))
+    memcpy(info->guards[info->num_guards++], set, 32);
+}
+
+/**
+ * info_guarded - Must each match contain a byte the repetitions can't match?
+ * @param info Info about a group
+ * @retval true Iterations of the group can't be split ambiguously
+ */
+static bool info_guarded(const struct ComplexityInfo *info)
+{
+  for (size_t i = 0; i < info->num_guards; i++)
+    if (set_disjoint(info->guards[i], info->repeated))
+      return true;
+  return false;
+}
+
+/**
+ * complexity_bracket - Parse a bracket expression, e.g. `[a-z]`
+ * @param ps  Parser, positioned after the '['
+ * @param set Bitmap to fill
+ *
+ * Ranges and classes depend on the locale, so they also allow every non-ASCII
+ * byte.  A negated bracket matches everything that isn't listed.
+ */
+static void complexity_bracket(struct ComplexityParser *ps, uint8_t *set)
+{
+  bool negate = (*ps->p == '^');
+  if (negate)
+    ps->p++;
+
+  bool first = true;
+  for (; *ps->p && ((*ps->p != ']') || first); ps->p++, first = false)
+  {
+    const char *p = ps->p;
+    if ((p[0] == '[') && ((p[1] == ':') || (p[1] == '.') || (p[1] == '=')))
+    {
+      char close[3] = { p[1], ']', '\0' };
+      const char *end = strstr(p + 2, close);
+      if (!end)
+        break;
+
+      /* Collating elements and classes, like [:alpha:], could be anything */
+      memset(set, 0xff, 32);
+      ps->p = end + 1;
+      continue;
+    }
+
+    unsigned char lo = p[0];
+    unsigned char hi = lo;
+    if ((p[1] == '-') && (p[2] != ']') && (p[2] != '\0'))
+    {
+      hi = p[2];
+      ps->p += 2;
+      set_add_high(set);
+    }
+
+    for (unsigned int c = lo; c <= hi; c++)
+      set_add(set, c);
+    if (lo >= 0x80)
+      set_add_high(set);
+  }
+
+  if (*ps->p == ']')
+    ps->p++;
+
+  if (negate)
+  {
+    for (size_t i = 0; i < 32; i++)
+      set[i] = ~set[i];
+    set_add_high(set);
+  }
+}
+
+/**
+ * complexity_escape - Parse a backslash escape, e.g. `\w`
+ * @param[in]  ps   Parser, positioned after the '\'
+ * @param[out] set  Bitmap to fill
+ * @param[out] risk Set if the escape is a back-reference
+ */
+static void complexity_escape(struct ComplexityParser *ps, uint8_t *set, enum RegexRisk *risk)
+{
+  unsigned char c = *ps->p;
+  if (c == '\0')
+    return;
+  ps->p++;
+
+  if (isdigit(c))
+  {
+    /* A back-reference can match anything */
+    *risk = REGEX_RISK_BACKREF;
+    memset(set, 0xff, 32);
+  }
+  else if (strchr("<>bB`'", c))
+  {
+    /* Zero-width */
+  }
+  else if (c == 'w')
+  {
+    for (unsigned int i = 0; i < 0x80; i++)
+      if (isalnum(i) || (i == '_'))
+        set_add(set, i);
+    set_add_high(set);
+  }
+  else if (strchr("WsS", c))
+  {
+    memset(set, 0xff, 32);
+  }
+  else
+  {
+    set_add(set, c);
+  }
+}
+
+/**
+ * complexity_repeat - Parse the repetitions of an atom
+ * @param[in]  ps  Parser, positioned after the atom
+ * @param[out] min Fewest repetitions
+ * @retval true The atom may be repeated without (a small) limit
+ */
+static bool complexity_repeat(struct ComplexityParser *ps, long *min)
+{
+  bool unbounded = false;
+  long max = 1;
+  *min = 1;
+
+  while (true)
+  {
+    char c = *ps->p;
+    if (c == '*')
+    {
+      *min = 0;
+      unbounded = true;
+    }
+    else if (c == '+')
+    {
+      unbounded = true;
+    }
+    else if (c == '?')
+    {
+      *min = 0;
+    }
+    else if ((c == '{') && isdigit((unsigned char) ps->p[1]))
+    {
+      char *end = NULL;
+      long lo = strtol(ps->p + 1, &end, 10);
+      long hi = lo;
+      if (*end == ',')
+      {
+        end++;
+        if (isdigit((unsigned char) *end))
+          hi = strtol(end, &end, 10);
+        else
+          unbounded = true;
+      }
+      if (*end != '}')
+        break;
+
+      if (lo == 0)
+        *min = 0;
+      max = MIN(max * MIN(hi, COMPLEXITY_REPEAT_MAX + 1), COMPLEXITY_REPEAT_MAX + 1);
+      ps->p = end;
+    }
+    else
+    {
+      break;
+    }
+    ps->p++;
+  }
+
+  return unbounded || (max > COMPLEXITY_REPEAT_MAX);
+}
+
+/**
+ * complexity_seq - Parse a sequence of atoms, e.g. `ab*(c|d)`
+ * @param ps   Parser
+ * @param info Info to fill
+ */
+static void complexity_seq(struct ComplexityParser *ps, struct ComplexityInfo *info)
+{
+  memset(info, 0, sizeof(*info));
+
+  struct ComplexityInfo group;
+  while (*ps->p && (*ps->p != '|') && ((*ps->p != ')') || (ps->depth == 0)))
+  {
+    uint8_t set[32] = { 0 };
+    bool is_group = false;
+    enum RegexRisk risk = REGEX_RISK_NONE;
+
+    unsigned char c = *ps->p++;
+    if ((c == '(') && (ps->depth < 64))
+    {
+      ps->depth++;
+      complexity_alt(ps, &group);
+      ps->depth--;
+      if (*ps->p == ')')
+        ps->p++;
+      is_group = true;
+      memcpy(set, group.chars, sizeof(set));
+      risk = group.risk;
+    }
+    else if (c == '[')
+    {
+      complexity_bracket(ps, set);
+    }
+    else if (c == '\\')
+    {
+      complexity_escape(ps, set, &risk);
+    }
+    else if (c == '.')
+    {
+      memset(set, 0xff, sizeof(set));
+    }
+    else if ((c != '^') && (c != '$'))
+    {
+      set_add(set, c);
+      if (c >= 0x80)
+        set_add_high(set);
+    }
+
+    long min = 1;
+    bool unbounded = complexity_repeat(ps, &min);
+
+    /* An ambiguous group, repeated, can split the string in many ways */
+    if (is_group && unbounded && group.has_repeat && !info_guarded(&group))
+      risk = MAX(risk, REGEX_RISK_NESTED);
+
+    set_union(info->chars, set);
+    if (unbounded)
+    {
+      set_union(info->repeated, set);
+      info->has_repeat = true;
+    }
+    else if (is_group)
+    {
+      set_union(info->repeated, group.repeated);
+      info->has_repeat |= group.has_repeat;
+    }
+
+    if (min > 0)
+    {
+      if (is_group)
+      {
+        for (size_t i = 0; i < group.num_guards; i++)
+          info_guard(info, group.guards[i]);
+      }
+      else
+      {
+        info_guard(info, set);
+      }
+    }
+
+    info->risk = MAX(info->risk, risk);
+  }
+}
+
+/**
+ * complexity_alt - Parse a list of alternatives, e.g. `a|b|c`
+ * @param ps   Parser
+ * @param info Info to fill
+ *
+ * If every branch has a guard, their union guards the alternatives.
+ */
+static void complexity_alt(struct ComplexityParser *ps, struct ComplexityInfo *info)
+{
+  struct ComplexityInfo branch;
+  uint8_t guard[32] = { 0 };
+  bool guarded = true;
+
+  complexity_seq(ps, info);
+  if (*ps->p != '|')
+    return;
+
+  for (const struct ComplexityInfo *b = info; b; b = &branch)
+  {
+    if (b->num_guards > 0)
+      set_union(guard, b->guards[0]);
+    else
+      guarded = false;
+
+    if (*ps->p != '|')
+      break;
+    ps->p++;
+
+    complexity_seq(ps, &branch);
+    set_union(info->chars, branch.chars);
+    set_union(info->repeated, branch.repeated);
+    info->has_repeat |= branch.has_repeat;
+    info->risk = MAX(info->risk, branch.risk);
+  }
+
+  info->num_guards = 0;
+  if (guarded)
+    info_guard(info, guard);
+}
+
+/**
+ * complexity_risk - How slow might a regex be to match?
+ * @param pattern POSIX extended regex, without any '!' prefix
+ * @retval enum Worst construct found, e.g. #REGEX_RISK_BACKREF
+ */
+enum RegexRisk complexity_risk(const char *pattern)
+{
+  if (!pattern)
+    return REGEX_RISK_NONE;
+
+  struct ComplexityParser ps = { pattern, 0 };
+  struct ComplexityInfo info;
+  complexity_alt(&ps, &info);
+  return info.risk;
+}
+
+/**
+ * complexity_risk_name - Describe a risk
+ * @param risk Risk, e.g. #REGEX_RISK_NESTED
+ * @retval ptr Description, e.g. "nested repetition"
+ */
+const char *complexity_risk_name(enum RegexRisk risk)
+{
+  switch (risk)
+  {
+    case REGEX_RISK_NESTED:
+      return "nested repetition";
+    case REGEX_RISK_BACKREF:
+      return "back-reference";
+    default:
+      return "none";
+  }
+}
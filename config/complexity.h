@@ -0,0 +1,43 @@
+/**
+ * @file
+ * Spot regexes that may be slow to match
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_COMPLEXITY_H
+#define MUTT_CONFIG_COMPLEXITY_H
+
+#define COMPLEXITY_REPEAT_MAX 16 ///< Larger counted repetitions are treated like '*'
+
+/**
+ * enum RegexRisk - How slow might a regex be to match?
+ *
+ * The risks are in increasing order.
+ */
+enum RegexRisk
+{
+  REGEX_RISK_NONE = 0, ///< Matching takes time roughly proportional to the string
+  REGEX_RISK_NESTED,   ///< Ambiguous nested repetition, e.g. `(a+)+`
+  REGEX_RISK_BACKREF,  ///< Back-reference, e.g. `(.*)\1`
+};
+
+enum RegexRisk complexity_risk     (const char *pattern);
+const char *   complexity_risk_name(enum RegexRisk risk);
+
+#endif /* MUTT_CONFIG_COMPLEXITY_H */
@@ -37,6 +37,7 @@
 #include "mutt/memory.h"
 #include "mutt/string2.h"
 #include "enum.h"
+#include "lookup.h"
 #include "set.h"
 #include "types.h"
 
@@ -61,7 +62,7 @@ static int enum_string_set(const struct ConfigSet *cs, void *var, struct ConfigD
   if (!ed || !ed->lookup)
     return CSR_ERR_CODE;
 
-  int num = mutt_map_get_value(value, ed->lookup);
+  int num = lookup_get_value(value, ed->lookup);
   if (num < 0)
   {
     mutt_buffer_printf(err, "Invalid enum value: %s", value);
@@ -118,7 +119,7 @@ static int enum_string_get(const struct ConfigSet *cs, void *var,
   if (!ed || !ed->lookup)
     return CSR_ERR_CODE;
 
-  const char *name = mutt_map_get_name(value, ed->lookup);
+  const char *name = lookup_get_name(value, ed->lookup);
   if (!name)
   {
     mutt_debug(1, "Variable has an invalid value: %d\n", value);
@@ -148,7 +149,7 @@ static int enum_native_set(const struct ConfigSet *cs, void *var,
   if (!ed || !ed->lookup)
     return CSR_ERR_CODE;
 
-  const char *name = mutt_map_get_name(value, ed->lookup);
+  const char *name = lookup_get_name(value, ed->lookup);
   if (!name)
   {
     mutt_buffer_printf(err, "Invalid enum value: %ld", value);
@@ -32,7 +32,7 @@ struct EnumDef
 {
   const char *name;
   int count;
-  struct Mapping *lookup;
+  const struct Mapping *lookup; ///< Names and values, static and never changed, see lookup_register()
 };
 
 void enum_init(struct ConfigSet *cs);
@@ -27,12 +27,24 @@
 
 /**
  * struct Inheritance - An inherited config item
+ *
+ * The root of the chain, and the nearest ancestor holding a value, are cached
+ * so that reading an inherited item doesn't need to walk the chain.  They're
+ * kept up to date by the ConfigSet whenever an inherited item is set or reset.
+ *
+ * The item and its name are a single allocation.  The fields used by reads
+ * come first, then the links, which are only used when items change.
  */
 struct Inheritance
 {
-  struct HashElem *parent; ///< HashElem of parent config item
-  const char *name;        ///< Name of this config item
-  intptr_t var;            ///< (Pointer to) value, of config item
+  intptr_t var;             ///< (Pointer to) value, of config item
+  struct HashElem *value;   ///< Nearest ancestor with a value (used when this item has none)
+  struct HashElem *base;    ///< Root config item, holding the ConfigDef
+  struct HashElem *parent;  ///< HashElem of parent config item
+  struct HashElem *child;   ///< First inherited config item that inherits from this one
+  struct HashElem *sibling; ///< Next inherited config item with the same parent
+  struct HashElem *prev;    ///< Previous inherited config item with the same parent
+  char name[];              ///< Name of this config item
 };
 
 #endif /* MUTT_CONFIG_INHERITANCE_H */
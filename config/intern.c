@@ -0,0 +1,323 @@
+/**
+ * @file
+ * Interned, reference-counted strings
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_intern Interned, reference-counted strings
+ *
+ * String config values are interned: a value that's in use by several config
+ * items is only stored once.  Each string is a single allocation, holding its
+ * reference count and its text.
+ *
+ * Short strings, the majority, are stored inline in fixed-size cells.  The
+ * cells are carved out of slabs and recycled through a free list, so changing
+ * a short value doesn't touch the heap.  Longer strings spill to the heap,
+ * even if the ConfigSet has an Arena, so that they can be freed.
+ * Either way, the string's address is stable for as long as it's referenced.
+ *
+ * Interned strings must never be changed, or freed directly.  Drop them with
+ * cs_intern_release().  Because equal strings share storage, two interned
+ * strings are equal if, and only if, their pointers are equal.
+ *
+ * The pool is protected by a lock, so it may be used by several threads that
+ * are only validating config, see cs_validate_files().
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "intern.h"
+#include "arena.h"
+#include "set.h"
+#include "types.h"
+
+/**
+ * struct InternString - An interned string
+ */
+struct InternString
+{
+  size_t refs; ///< Number of references to the string
+  char str[];  ///< The string itself, also the hash key
+};
+
+/* Strings shorter than this are stored in a cell */
+#define INTERN_SHORT_SIZE 24
+#define INTERN_CELL_SIZE (sizeof(struct InternString) + INTERN_SHORT_SIZE)
+#define INTERN_SLAB_CELLS 31
+
+/**
+ * struct InternCells - Storage for short interned strings
+ *
+ * Each slab is an array of cells, the first of which links to the next slab.
+ * Free cells are linked through their first word.
+ */
+struct InternCells
+{
+  void *slabs; ///< Slabs of cells
+  void *free;  ///< Free cells
+};
+
+static pthread_mutex_t InternLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * intern_is_short - Is this string stored in a cell?
+ * @param is InternString
+ * @retval true The string is short
+ */
+static bool intern_is_short(const struct InternString *is)
+{
+  return memchr(is->str, '\0', INTERN_SHORT_SIZE) != NULL;
+}
+
+/**
+ * intern_alloc - Allocate an InternString
+ * @param cs  Config items
+ * @param len Length of the string
+ * @retval ptr Uninitialised InternString
+ *
+ * The lock must be held.
+ */
+static struct InternString *intern_alloc(const struct ConfigSet *cs, size_t len)
+{
+  if (len >= INTERN_SHORT_SIZE)
+    return mutt_mem_calloc(1, sizeof(struct InternString) + len + 1);
+
+  struct InternCells *cells = cs->cells;
+  if (!cells->free)
+  {
+    char *slab = arena_calloc(cs->arena, (INTERN_SLAB_CELLS + 1) * INTERN_CELL_SIZE);
+    *(void **) slab = cells->slabs;
+    cells->slabs = slab;
+
+    for (size_t i = INTERN_SLAB_CELLS; i > 0; i--)
+    {
+      void *cell = slab + (i * INTERN_CELL_SIZE);
+      *(void **) cell = cells->free;
+      cells->free = cell;
+    }
+  }
+
+  struct InternString *is = cells->free;
+  cells->free = *(void **) is;
+  return is;
+}
+
+/**
+ * intern_free - Free an InternString - Implements ::hashelem_free_t
+ * @param type Object type (unused)
+ * @param obj  InternString to free
+ * @param data ConfigSet that owns the string
+ */
+static void intern_free(int type, void *obj, intptr_t data)
+{
+  const struct ConfigSet *cs = (const struct ConfigSet *) data;
+
+  if (intern_is_short(obj))
+  {
+    *(void **) obj = cs->cells->free;
+    cs->cells->free = obj;
+    return;
+  }
+
+  FREE(&obj);
+}
+
+/**
+ * intern_find - Find the InternString for a string
+ * @param cs  Config items
+ * @param str String to look for
+ * @retval ptr  InternString
+ * @retval NULL Not interned
+ *
+ * The lock must be held.
+ */
+static struct InternString *intern_find(const struct ConfigSet *cs, const char *str)
+{
+  return mutt_hash_find(cs->strings, str);
+}
+
+/**
+ * cs_intern_init - Create the string pool
+ * @param cs Config items
+ */
+void cs_intern_init(struct ConfigSet *cs)
+{
+  if (!cs)
+    return;
+
+  cs->strings = mutt_hash_new(256, MUTT_HASH_NO_FLAGS);
+  mutt_hash_set_destructor(cs->strings, intern_free, (intptr_t) cs);
+  cs->cells = mutt_mem_calloc(1, sizeof(*cs->cells));
+}
+
+/**
+ * cs_intern_cleanup - Free the string pool
+ * @param cs Config items
+ *
+ * Any strings that are still referenced are freed.
+ */
+void cs_intern_cleanup(struct ConfigSet *cs)
+{
+  if (!cs)
+    return;
+
+  mutt_hash_free(&cs->strings);
+
+  if (!cs->cells)
+    return;
+
+  void *slab = cs->cells->slabs;
+  while (slab)
+  {
+    void *next = *(void **) slab;
+    arena_release(cs->arena, &slab, (INTERN_SLAB_CELLS + 1) * INTERN_CELL_SIZE);
+    slab = next;
+  }
+  FREE(&cs->cells);
+}
+
+/**
+ * cs_intern - Intern a string
+ * @param cs  Config items
+ * @param str String to intern
+ * @retval ptr  Interned string, with a new reference
+ * @retval NULL str was NULL or empty
+ *
+ * Like mutt_str_strdup(), empty strings become NULL.  If there's no pool, a
+ * plain copy of the string is returned.
+ */
+const char *cs_intern(const struct ConfigSet *cs, const char *str)
+{
+  if (!str || (str[0] == '\0'))
+    return NULL;
+  if (!cs || !cs->strings)
+    return mutt_str_strdup(str);
+
+  pthread_mutex_lock(&InternLock);
+  struct InternString *is = intern_find(cs, str);
+  if (is)
+  {
+    is->refs++;
+  }
+  else
+  {
+    size_t len = strlen(str);
+    is = intern_alloc(cs, len);
+    is->refs = 1;
+    memcpy(is->str, str, len + 1);
+    mutt_hash_insert(cs->strings, is->str, is);
+  }
+  pthread_mutex_unlock(&InternLock);
+
+  return is->str;
+}
+
+/**
+ * cs_intern_release - Drop a reference to an interned string
+ * @param[in]  cs  Config items
+ * @param[out] str String to release
+ * @retval true  Success, str has been set to NULL
+ * @retval false The string isn't interned, the caller must free it
+ *
+ * When the last reference is dropped, the string is freed.
+ */
+bool cs_intern_release(const struct ConfigSet *cs, const char **str)
+{
+  if (!cs || !str || !*str || !cs->strings)
+    return false;
+
+  pthread_mutex_lock(&InternLock);
+  struct InternString *is = intern_find(cs, *str);
+  if (!is || (is->str != *str))
+  {
+    /* An equal string, but not ours */
+    pthread_mutex_unlock(&InternLock);
+    return false;
+  }
+
+  is->refs--;
+  if (is->refs == 0)
+    mutt_hash_delete(cs->strings, is->str, is);
+  pthread_mutex_unlock(&InternLock);
+
+  *str = NULL;
+  return true;
+}
+
+/**
+ * cs_intern_count - How many references are there to an interned string?
+ * @param cs  Config items
+ * @param str String
+ * @retval num Number of references, 0 if the string isn't interned
+ */
+size_t cs_intern_count(const struct ConfigSet *cs, const char *str)
+{
+  if (!cs || !str || !cs->strings)
+    return 0;
+
+  pthread_mutex_lock(&InternLock);
+  struct InternString *is = intern_find(cs, str);
+  size_t refs = (is && (is->str == str)) ? is->refs : 0;
+  pthread_mutex_unlock(&InternLock);
+
+  return refs;
+}
+
+/**
+ * cs_intern_initial - Set the initial value of a config item
+ * @param cs    Config items
+ * @param cdef  Variable definition
+ * @param value Initial value, as a string
+ *
+ * Any previous initial value, that was set at runtime, is released.
+ */
+void cs_intern_initial(const struct ConfigSet *cs, struct ConfigDef *cdef, const char *value)
+{
+  if (!cdef)
+    return;
+
+  cs_intern_initial_free(cs, cdef);
+  cdef->type |= DT_INITIAL_SET;
+  cdef->initial = IP cs_intern(cs, value);
+}
+
+/**
+ * cs_intern_initial_free - Free the initial value of a config item
+ * @param cs   Config items
+ * @param cdef Variable definition
+ *
+ * Only initial values set at runtime, #DT_INITIAL_SET, are freed.
+ */
+void cs_intern_initial_free(const struct ConfigSet *cs, struct ConfigDef *cdef)
+{
+  if (!cdef || !(cdef->type & DT_INITIAL_SET))
+    return;
+
+  const char *initial = (const char *) cdef->initial;
+  if (!cs_intern_release(cs, &initial))
+    FREE(&initial);
+
+  cdef->initial = 0;
+  cdef->type &= ~DT_INITIAL_SET;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * Interned, reference-counted strings
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_INTERN_H
+#define MUTT_CONFIG_INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct ConfigDef;
+struct ConfigSet;
+
+void        cs_intern_init   (struct ConfigSet *cs);
+void        cs_intern_cleanup(struct ConfigSet *cs);
+
+const char *cs_intern        (const struct ConfigSet *cs, const char *str);
+bool        cs_intern_release(const struct ConfigSet *cs, const char **str);
+size_t      cs_intern_count  (const struct ConfigSet *cs, const char *str);
+
+void        cs_intern_initial     (const struct ConfigSet *cs, struct ConfigDef *cdef, const char *value);
+void        cs_intern_initial_free(const struct ConfigSet *cs, struct ConfigDef *cdef);
+
+#endif /* MUTT_CONFIG_INTERN_H */
@@ -28,17 +28,25 @@
  * | File                | Description                |
  * | :------------------ | :------------------------- |
  * | config/address.c    | @subpage config_address    |
+ * | config/arena.c      | @subpage config_arena      |
  * | config/bool.c       | @subpage config_bool       |
+ * | config/complexity.c | @subpage config_complexity |
  * | config/dump.c       | @subpage config_dump       |
  * | config/enum.c       | @subpage config_enum       |
+ * | config/intern.c     | @subpage config_intern     |
  * | config/long.c       | @subpage config_long       |
+ * | config/lookup.c     | @subpage config_lookup     |
  * | config/mbtable.c    | @subpage config_mbtable    |
  * | config/number.c     | @subpage config_number     |
+ * | config/prefilter.c  | @subpage config_prefilter  |
  * | config/quad.c       | @subpage config_quad       |
  * | config/regex.c      | @subpage config_regex      |
+ * | config/regexgroup.c | @subpage config_regexgroup |
  * | config/set.c        | @subpage config_set        |
+ * | config/shared.c     | @subpage config_shared     |
  * | config/slist.c      | @subpage config_slist      |
  * | config/sort.c       | @subpage config_sort       |
+ * | config/source.c     | @subpage config_source     |
  * | config/string.c     | @subpage config_string     |
  * | config/subset.c     | @subpage config_subset     |
  */
@@ -47,18 +55,26 @@
 #define MUTT_CONFIG_LIB_H
 
 #include "address.h"
+#include "arena.h"
 #include "bool.h"
+#include "complexity.h"
 #include "dump.h"
 #include "enum.h"
 #include "inheritance.h"
+#include "intern.h"
 #include "long.h"
+#include "lookup.h"
 #include "mbtable.h"
 #include "number.h"
+#include "prefilter.h"
 #include "quad.h"
 #include "regex2.h"
+#include "regexgroup.h"
 #include "set.h"
+#include "shared.h"
 #include "slist.h"
 #include "sort.h"
+#include "source.h"
 #include "string3.h"
 #include "subset.h"
 #include "types.h"
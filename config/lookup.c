@@ -0,0 +1,322 @@
+/**
+ * @file
+ * Constant-time lookups in Mapping tables
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_lookup Constant-time lookups in Mapping tables
+ *
+ * The enum, quad and sort types turn names into ids, and back again, using
+ * Mapping tables.  mutt_map_get_value() and mutt_map_get_name() scan the
+ * table, comparing every entry.
+ *
+ * A Mapping that's been registered, using lookup_register(), is indexed:
+ * - The names are put in a hash table, case-folded.  Seeds are tried until
+ *   every name has its own slot, so a lookup hashes the name and compares one
+ *   entry.
+ * - The ids, up to #LOOKUP_MAX_ID, are put in an array.  If several names
+ *   have the same id, the first one is used, like mutt_map_get_name().
+ *
+ * The index is kept until the program exits, and is found by the Mapping's
+ * address, so only register a Mapping that's static and never changes, e.g. a
+ * const table.  Other Mappings, e.g. ones on the heap or the stack, or ones
+ * that are edited, are scanned, as before.  So is a Mapping that can't be
+ * indexed.
+ *
+ * The functions are thread-safe.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "lookup.h"
+
+#define LOOKUP_REGISTRY_SIZE 256 ///< Most Mappings that can be indexed
+#define LOOKUP_SEEDS         64  ///< Seeds to try for each size of hash table
+
+/**
+ * struct MappingIndex - Hash table and array for a Mapping
+ */
+struct MappingIndex
+{
+  const struct Mapping *map; ///< Mapping that's been indexed
+  uint32_t seed;             ///< Hash seed that gives every name its own slot
+  uint32_t mask;             ///< Number of slots, minus one
+  uint16_t *slots;           ///< Index into the Mapping, plus one, or 0 if empty
+  bool perfect;              ///< Every name has its own slot
+  const char **names;        ///< First name for each id, up to max_id
+  int max_id;                ///< Largest id in the array
+  bool complete;             ///< The array covers every id in the Mapping
+};
+
+static struct MappingIndex *Registry[LOOKUP_REGISTRY_SIZE]; ///< Indexed Mappings
+static size_t RegistryCount = 0;                         ///< Number of indexed Mappings
+static pthread_mutex_t RegistryLock = PTHREAD_MUTEX_INITIALIZER; ///< Protects new entries
+
+/**
+ * lookup_hash - Hash a name, ignoring case
+ * @param name Name to hash
+ * @param seed Hash seed
+ * @retval num Hash
+ */
+static uint32_t lookup_hash(const char *name, uint32_t seed)
+{
+  uint32_t h = 2166136261U ^ (seed * 0x9e3779b9U);
+  for (const unsigned char *s = (const unsigned char *) name; *s; s++)
+  {
+    unsigned char c = *s;
+    if ((c >= 'A') && (c <= 'Z'))
+      c |= 0x20;
+    h = (h ^ c) * 16777619U;
+  }
+
+  /* Mix the bits, so every seed spreads the names differently */
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35U;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * lookup_fill - Try to put every name in its own slot
+ * @param idx  MappingIndex
+ * @param size Number of slots
+ * @param seed Hash seed
+ * @retval true Success, the hash is perfect
+ *
+ * Duplicate names are skipped, keeping the first, like mutt_map_get_value().
+ */
+static bool lookup_fill(struct MappingIndex *idx, uint32_t size, uint32_t seed)
+{
+  memset(idx->slots, 0, size * sizeof(*idx->slots));
+
+  for (size_t i = 0; idx->map[i].name; i++)
+  {
+    uint32_t slot = lookup_hash(idx->map[i].name, seed) & (size - 1);
+    if (idx->slots[slot] != 0)
+    {
+      if (mutt_str_strcasecmp(idx->map[idx->slots[slot] - 1].name, idx->map[i].name) == 0)
+        continue;
+      return false;
+    }
+    idx->slots[slot] = i + 1;
+  }
+
+  idx->seed = seed;
+  idx->mask = size - 1;
+  return true;
+}
+
+/**
+ * lookup_new - Index a Mapping
+ * @param map Mapping to index
+ * @retval ptr New MappingIndex
+ */
+static struct MappingIndex *lookup_new(const struct Mapping *map)
+{
+  struct MappingIndex *idx = mutt_mem_calloc(1, sizeof(*idx));
+  idx->map = map;
+
+  size_t num = 0;
+  int max_id = -1;
+  idx->complete = true;
+  for (; map[num].name; num++)
+  {
+    if ((map[num].value < 0) || (map[num].value > LOOKUP_MAX_ID))
+      idx->complete = false;
+    else
+      max_id = MAX(max_id, map[num].value);
+  }
+
+  /* Id to name: the first name wins */
+  idx->max_id = max_id;
+  if (max_id >= 0)
+  {
+    idx->names = mutt_mem_calloc(max_id + 1, sizeof(char *));
+    for (size_t i = 0; i < num; i++)
+    {
+      int id = map[i].value;
+      if ((id >= 0) && (id <= max_id) && !idx->names[id])
+        idx->names[id] = map[i].name;
+    }
+  }
+
+  /* Name to id: grow the table until a seed gives every name its own slot */
+  if ((num == 0) || (num >= UINT16_MAX))
+    return idx;
+
+  uint32_t size = 8;
+  while (size < (2 * num))
+    size <<= 1;
+
+  idx->slots = mutt_mem_malloc(LOOKUP_MAX_SLOTS * sizeof(*idx->slots));
+  for (; size <= LOOKUP_MAX_SLOTS; size <<= 1)
+  {
+    for (uint32_t seed = 1; seed <= LOOKUP_SEEDS; seed++)
+    {
+      if (lookup_fill(idx, size, seed))
+      {
+        mutt_mem_realloc(&idx->slots, size * sizeof(*idx->slots));
+        idx->perfect = true;
+        return idx;
+      }
+    }
+  }
+
+  FREE(&idx->slots); /* LCOV_EXCL_LINE */
+  return idx;        /* LCOV_EXCL_LINE */
+}
+
+/**
+ * lookup_find - Find the index for a registered Mapping
+ * @param[in]  map Mapping
+ * @param[out] pos Registry slot where the search stopped, may be NULL
+ * @retval ptr  MappingIndex
+ * @retval NULL The Mapping hasn't been registered
+ */
+static struct MappingIndex *lookup_find(const struct Mapping *map, size_t *pos)
+{
+  size_t i = (((uintptr_t) map >> 4) * 0x9e3779b9U) % LOOKUP_REGISTRY_SIZE;
+  for (size_t n = 0; n < LOOKUP_REGISTRY_SIZE; n++, i = (i + 1) % LOOKUP_REGISTRY_SIZE)
+  {
+    struct MappingIndex *idx = __atomic_load_n(&Registry[i], __ATOMIC_ACQUIRE);
+    if (!idx)
+      break;
+    if (idx->map == map)
+      return idx;
+  }
+
+  if (pos)
+    *pos = i;
+  return NULL;
+}
+
+/**
+ * lookup_register - Index a Mapping, for constant-time lookups
+ * @param map Mapping, which must be static and never change
+ * @retval true  Success, or the Mapping was already registered
+ * @retval false Error, the registry is full
+ *
+ * The Mapping is found by its address, so it must not be freed, reused or
+ * edited afterwards.
+ */
+bool lookup_register(const struct Mapping *map)
+{
+  if (!map)
+    return false;
+
+  if (lookup_find(map, NULL))
+    return true;
+
+  pthread_mutex_lock(&RegistryLock);
+
+  /* Another thread may have registered it */
+  size_t pos = 0;
+  bool found = lookup_find(map, &pos);
+
+  /* Keep one slot empty, so every search stops */
+  if (!found && (RegistryCount < (LOOKUP_REGISTRY_SIZE - 1)))
+  {
+    __atomic_store_n(&Registry[pos], lookup_new(map), __ATOMIC_RELEASE);
+    RegistryCount++;
+    found = true;
+  }
+
+  pthread_mutex_unlock(&RegistryLock);
+  return found;
+}
+
+/**
+ * lookup_get_name - Find the name for an id
+ * @param val Id to find
+ * @param map Mapping to search
+ * @retval ptr  Name, the first one in the Mapping
+ * @retval NULL The id isn't in the Mapping
+ *
+ * This is equivalent to mutt_map_get_name().  It takes constant time if the
+ * Mapping has been registered, see lookup_register().
+ */
+const char *lookup_get_name(int val, const struct Mapping *map)
+{
+  if (!map)
+    return NULL;
+
+  const struct MappingIndex *idx = lookup_find(map, NULL);
+  if (!idx)
+    return mutt_map_get_name(val, map);
+
+  if ((val >= 0) && (val <= idx->max_id) && idx->names[val])
+    return idx->names[val];
+
+  if (idx->complete)
+    return NULL;
+
+  return mutt_map_get_name(val, map);
+}
+
+/**
+ * lookup_get_value - Find the id for a name
+ * @param name Name to find, case-insensitive
+ * @param map  Mapping to search
+ * @retval num Id
+ * @retval -1  The name isn't in the Mapping
+ *
+ * This is equivalent to mutt_map_get_value().  It takes constant time if the
+ * Mapping has been registered, see lookup_register().
+ */
+int lookup_get_value(const char *name, const struct Mapping *map)
+{
+  if (!name || !map)
+    return -1;
+
+  const struct MappingIndex *idx = lookup_find(map, NULL);
+  if (!idx || !idx->perfect)
+    return mutt_map_get_value(name, map);
+
+  uint16_t slot = idx->slots[lookup_hash(name, idx->seed) & idx->mask];
+  if (slot == 0)
+    return -1;
+
+  const struct Mapping *m = &map[slot - 1];
+  if (mutt_str_strcasecmp(m->name, name) != 0)
+    return -1;
+
+  return m->value;
+}
+
+/**
+ * lookup_is_perfect - Does every name in a Mapping have its own hash slot?
+ * @param map Mapping
+ * @retval true The Mapping is registered, and its names can be found in constant time
+ */
+bool lookup_is_perfect(const struct Mapping *map)
+{
+  if (!map)
+    return false;
+
+  const struct MappingIndex *idx = lookup_find(map, NULL);
+  return idx && idx->perfect;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * Constant-time lookups in Mapping tables
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_LOOKUP_H
+#define MUTT_CONFIG_LOOKUP_H
+
+#include <stdbool.h>
+
+struct Mapping;
+
+#define LOOKUP_MAX_ID    255 ///< Larger ids are found by scanning the Mapping
+#define LOOKUP_MAX_SLOTS (1 << 16) ///< Largest hash table for a Mapping's names
+
+const char *lookup_get_name (int val, const struct Mapping *map);
+int         lookup_get_value(const char *name, const struct Mapping *map);
+bool        lookup_is_perfect(const struct Mapping *map);
+bool        lookup_register (const struct Mapping *map);
+
+#endif /* MUTT_CONFIG_LOOKUP_H */
@@ -24,6 +24,10 @@
  * @page config_mbtable Type: Multi-byte character table
  *
  * Type representing a multibyte character table.
+ *
+ * The table is render-ready: each character's bytes, codepoint and display
+ * width are stored when the string is parsed.  ASCII strings, the common
+ * case, skip the multibyte decoding.
  */
 
 #include "config.h"
@@ -33,49 +37,128 @@
 #include <wchar.h>
 #include "mutt/mutt.h"
 #include "mbtable.h"
+#include "intern.h"
 #include "set.h"
+#include "shared.h"
 #include "types.h"
 
+/**
+ * mbtable_alloc - Allocate an MbTable
+ * @param str String of multibyte characters
+ * @param num Number of characters
+ * @retval ptr New, empty, MbTable object
+ *
+ * The per-character arrays share one allocation, owned by chars.
+ */
+static struct MbTable *mbtable_alloc(const char *str, size_t num)
+{
+  struct MbTable *t = mutt_mem_calloc(1, sizeof(struct MbTable));
+
+  t->orig_str = mutt_str_strdup(str);
+  t->chars = mutt_mem_calloc(num, sizeof(char *) + sizeof(wchar_t) + (2 * sizeof(int)));
+  t->wchars = (wchar_t *) (t->chars + num);
+  t->widths = (int *) (t->wchars + num);
+  t->lens = t->widths + num;
+  /* Each character is followed by a NUL */
+  t->segmented_str = mutt_mem_calloc(mutt_str_strlen(str) + num, sizeof(char));
+
+  return t;
+}
+
+/**
+ * mbtable_next - Decode the next character of a string
+ * @param[in]  orig    Whole string, for error messages, NULL for none
+ * @param[in]  s       Remaining multibyte characters
+ * @param[in]  slen    Number of bytes remaining
+ * @param[in]  mbstate Conversion state
+ * @param[out] wc      Character, or #MBTABLE_INVALID
+ * @retval num Length of the character, in bytes
+ *
+ * An invalid byte is a character by itself; an incomplete character takes the
+ * rest of the string.
+ */
+static size_t mbtable_next(const char *orig, const char *s, size_t slen,
+                           mbstate_t *mbstate, wchar_t *wc)
+{
+  size_t k = mbrtowc(wc, s, slen, mbstate);
+  if ((k == (size_t)(-1)) || (k == (size_t)(-2)))
+  {
+    /* XXX put message in err buffer; fail? warning? */
+    if (orig)
+    {
+      mutt_debug(LL_DEBUG1, "mbtable_parse: mbrtowc returned %d converting %s in %s\n",
+                 (k == (size_t)(-1)) ? -1 : -2, s, orig);
+    }
+    if (k == (size_t)(-1))
+      memset(mbstate, 0, sizeof(*mbstate));
+    k = (k == (size_t)(-1)) ? 1 : slen;
+    *wc = MBTABLE_INVALID;
+  }
+
+  return k;
+}
+
 /**
  * mbtable_parse - Parse a multibyte string into a table
  * @param s String of multibyte characters
  * @retval ptr New MbTable object
+ *
+ * An ASCII string isn't decoded at all.  Otherwise, the widths are those of
+ * the current locale.  A character that can't be displayed will be shown as a
+ * single '?'.
  */
 struct MbTable *mbtable_parse(const char *s)
 {
-  struct MbTable *t = NULL;
-  size_t slen, k;
-  mbstate_t mbstate;
-  char *d = NULL;
-
-  slen = mutt_str_strlen(s);
+  size_t slen = mutt_str_strlen(s);
   if (!slen)
     return NULL;
 
-  t = mutt_mem_calloc(1, sizeof(struct MbTable));
-
-  t->orig_str = mutt_str_strdup(s);
-  /* This could be more space efficient.  However, being used on tiny
-   * strings (C_ToChars and C_StatusChars), the overhead is not great. */
-  t->chars = mutt_mem_calloc(slen, sizeof(char *));
-  t->segmented_str = mutt_mem_calloc(slen * 2, sizeof(char));
-  d = t->segmented_str;
+  bool ascii = true;
+  for (const unsigned char *p = (const unsigned char *) s; ascii && *p; p++)
+    ascii = (*p < 0x80);
 
-  memset(&mbstate, 0, sizeof(mbstate));
-  while (slen && (k = mbrtowc(NULL, s, slen, &mbstate)))
+  if (ascii)
   {
-    if ((k == (size_t)(-1)) || (k == (size_t)(-2)))
+    struct MbTable *t = mbtable_alloc(s, slen);
+    t->ascii = true;
+    char *d = t->segmented_str;
+    for (size_t i = 0; i < slen; i++)
     {
-      /* XXX put message in err buffer; fail? warning? */
-      mutt_debug(LL_DEBUG1, "mbtable_parse: mbrtowc returned %d converting %s in %s\n",
-                 (k == (size_t)(-1)) ? -1 : -2, s, t->orig_str);
-      if (k == (size_t)(-1))
-        memset(&mbstate, 0, sizeof(mbstate));
-      k = (k == (size_t)(-1)) ? 1 : slen;
+      t->chars[i] = d;
+      t->wchars[i] = (unsigned char) s[i];
+      t->widths[i] = 1;
+      t->lens[i] = 1;
+      *d++ = s[i];
+      *d++ = '\0';
     }
+    t->len = slen;
+    return t;
+  }
+
+  /* Count the characters first, so nothing is over-allocated */
+  mbstate_t mbstate;
+  memset(&mbstate, 0, sizeof(mbstate));
+  wchar_t wc = 0;
+  size_t num = 0;
+  for (size_t i = 0; i < slen; num++)
+    i += mbtable_next(NULL, s + i, slen - i, &mbstate, &wc);
+
+  struct MbTable *t = mbtable_alloc(s, num);
+  char *d = t->segmented_str;
+
+  memset(&mbstate, 0, sizeof(mbstate));
+  while (slen)
+  {
+    size_t k = mbtable_next(t->orig_str, s, slen, &mbstate, &wc);
+    int width = (wc == MBTABLE_INVALID) ? -1 : wcwidth(wc);
+
+    t->chars[t->len] = d;
+    t->wchars[t->len] = wc;
+    t->widths[t->len] = (width < 0) ? 1 : width;
+    t->lens[t->len] = k;
+    t->len++;
 
     slen -= k;
-    t->chars[t->len++] = d;
     while (k--)
       *d++ = *s++;
     *d++ = '\0';
@@ -84,6 +167,71 @@ struct MbTable *mbtable_parse(const char *s)
   return t;
 }
 
+/**
+ * mbtable_dup - Create a copy of an MbTable object
+ * @param table MbTable to duplicate
+ * @retval ptr New MbTable object
+ *
+ * The parsed form is copied, so the string isn't decoded again.
+ */
+static struct MbTable *mbtable_dup(const struct MbTable *table)
+{
+  if (!table)
+    return NULL; /* LCOV_EXCL_LINE */
+
+  struct MbTable *t = mbtable_alloc(table->orig_str, table->len);
+  t->len = table->len;
+  t->ascii = table->ascii;
+  memcpy(t->wchars, table->wchars, t->len * sizeof(wchar_t));
+  memcpy(t->widths, table->widths, t->len * sizeof(int));
+  memcpy(t->lens, table->lens, t->len * sizeof(int));
+  memcpy(t->segmented_str, table->segmented_str, mutt_str_strlen(t->orig_str) + t->len);
+  for (int i = 0; i < t->len; i++)
+    t->chars[i] = t->segmented_str + (table->chars[i] - table->segmented_str);
+
+  return t;
+}
+
+/**
+ * mbtable_shared_free - Free a shared MbTable - Implements ::shared_free_t
+ */
+static void mbtable_shared_free(void **obj)
+{
+  mbtable_free((struct MbTable **) obj);
+}
+
+/**
+ * mbtable_shared - Get a shared MbTable
+ * @param cs     Config items
+ * @param str    String to parse
+ * @param parsed Table that's already been parsed from str, may be NULL
+ * @retval ptr  Shared MbTable, with a new reference
+ * @retval NULL str is empty
+ *
+ * If the table is already in use, the string won't be parsed again.
+ * Otherwise, a copy of parsed is used, if there is one.
+ */
+static struct MbTable *mbtable_shared(const struct ConfigSet *cs, const char *str,
+                                      const struct MbTable *parsed)
+{
+  if (!str || (str[0] == '\0'))
+    return NULL;
+
+  struct Buffer *key = mutt_buffer_alloc(256);
+  mutt_buffer_printf(key, "mbtable:%s", str);
+
+  struct MbTable *table = cs_shared_find(cs, mutt_b2s(key));
+  if (!table)
+  {
+    table = (parsed && parsed->wchars) ? mbtable_dup(parsed) : mbtable_parse(str);
+    if (table)
+      table = cs_shared_add(cs, mutt_b2s(key), table, mbtable_shared_free);
+  }
+
+  mutt_buffer_free(&key);
+  return table;
+}
+
 /**
  * mbtable_destroy - Destroy an MbTable object - Implements ::cst_destroy()
  */
@@ -96,7 +244,8 @@ static void mbtable_destroy(const struct ConfigSet *cs, void *var, const struct
   if (!*m)
     return;
 
-  mbtable_free(m);
+  if (!cs_shared_release(cs, var))
+    mbtable_free(m);
 }
 
 /**
@@ -121,7 +270,7 @@ static int mbtable_string_set(const struct ConfigSet *cs, void *var, struct Conf
     if (curval && (mutt_str_strcmp(value, curval->orig_str) == 0))
       return CSR_SUCCESS | CSR_SUC_NO_CHANGE;
 
-    table = mbtable_parse(value);
+    table = mbtable_shared(cs, value, NULL);
 
     if (cdef->validator)
     {
@@ -129,7 +278,7 @@ static int mbtable_string_set(const struct ConfigSet *cs, void *var, struct Conf
 
       if (CSR_RESULT(rc) != CSR_SUCCESS)
       {
-        mbtable_free(&table);
+        mbtable_destroy(cs, &table, cdef);
         return rc | CSR_INV_VALIDATOR;
       }
     }
@@ -143,11 +292,7 @@ static int mbtable_string_set(const struct ConfigSet *cs, void *var, struct Conf
   }
   else
   {
-    if (cdef->type & DT_INITIAL_SET)
-      FREE(&cdef->initial);
-
-    cdef->type |= DT_INITIAL_SET;
-    cdef->initial = IP mutt_str_strdup(value);
+    cs_intern_initial(cs, cdef, value);
   }
 
   return rc;
@@ -180,21 +325,6 @@ static int mbtable_string_get(const struct ConfigSet *cs, void *var,
   return CSR_SUCCESS;
 }
 
-/**
- * mbtable_dup - Create a copy of an MbTable object
- * @param table MbTable to duplicate
- * @retval ptr New MbTable object
- */
-static struct MbTable *mbtable_dup(struct MbTable *table)
-{
-  if (!table)
-    return NULL; /* LCOV_EXCL_LINE */
-
-  struct MbTable *m = mutt_mem_calloc(1, sizeof(*m));
-  m->orig_str = mutt_str_strdup(table->orig_str);
-  return m;
-}
-
 /**
  * mbtable_native_set - Set a MbTable config item by MbTable object - Implements ::cst_native_set()
  */
@@ -215,9 +345,11 @@ static int mbtable_native_set(const struct ConfigSet *cs, void *var,
       return rc | CSR_INV_VALIDATOR;
   }
 
-  mbtable_free(var);
+  struct MbTable *table = (struct MbTable *) value;
+  if (table && !cs_shared_ref(cs, table))
+    table = mbtable_shared(cs, table->orig_str, table);
 
-  struct MbTable *table = mbtable_dup((struct MbTable *) value);
+  mbtable_destroy(cs, var, cdef);
 
   rc = CSR_SUCCESS;
   if (!table)
@@ -264,7 +396,7 @@ static int mbtable_reset(const struct ConfigSet *cs, void *var,
     return rc | CSR_SUC_NO_CHANGE;
 
   if (initial)
-    table = mbtable_parse(initial);
+    table = mbtable_shared(cs, initial, NULL);
 
   if (cdef->validator)
   {
@@ -310,6 +442,7 @@ void mbtable_free(struct MbTable **table)
     return;
 
   FREE(&(*table)->orig_str);
+  /* The per-character arrays share this allocation */
   FREE(&(*table)->chars);
   FREE(&(*table)->segmented_str);
   FREE(table);
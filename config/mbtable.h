@@ -23,14 +23,22 @@
 #ifndef MUTT_CONFIG_MBTABLE_H
 #define MUTT_CONFIG_MBTABLE_H
 
+#include <stdbool.h>
+#include <wchar.h>
+
 struct ConfigSet;
 
+#define MBTABLE_INVALID 0xFFFD ///< Character stored for bytes that aren't valid
+
 /**
  * struct MbTable - multibyte character table
  *
  * Allows for direct access to the individual multibyte characters in a string.
  * This is used for the #C_FlagChars, #C_FromChars, #C_StatusChars and #C_ToChars
  * option types.
+ *
+ * Everything needed to render a character is worked out when the string is
+ * parsed, so a caller doesn't need to decode it, or call wcwidth().
  */
 struct MbTable
 {
@@ -38,6 +46,10 @@ struct MbTable
   int len;             /**< Number of characters */
   char **chars;        /**< The array of multibyte character strings */
   char *segmented_str; /**< Each chars entry points inside this string */
+  wchar_t *wchars;     /**< Each character, decoded, or #MBTABLE_INVALID */
+  int *widths;         /**< Display width of each character */
+  int *lens;           /**< Length of each character, in bytes */
+  bool ascii;          /**< Every character is one ASCII byte, one column wide */
 };
 
 void mbtable_init(struct ConfigSet *cs);
@@ -0,0 +1,668 @@
+/**
+ * @file
+ * Cheap tests to avoid running a regex
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_prefilter Cheap tests to avoid running a regex
+ *
+ * When a Regex is created, its (POSIX extended) pattern is analysed once.
+ * Most strings that can't match are then rejected without calling regexec().
+ *
+ * - A literal that every match must contain, e.g. "attach" in
+ *   `\<(attach|attached|attachments?)\>`, found using strstr()
+ * - An anchored pattern's literal prefix, e.g. "From " in `^From `
+ * - The set of bytes that a match can start with, if it's small, found using
+ *   strpbrk()
+ *
+ * The analysis is conservative: a construct that isn't understood gives no
+ * prefilter at all.
+ *
+ * Case-insensitive comparisons are only trusted if the string is ASCII,
+ * because of characters like the Kelvin sign.  The string is only checked when
+ * it's about to be rejected.  Case-insensitive literals are found in the same
+ * pass as the check, which is much faster than strcasestr().
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <ctype.h>
+#include <regex.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "mutt/mutt.h"
+#include "prefilter.h"
+
+/**
+ * struct PrefilterInfo - What's known about a sub-expression
+ *
+ * If the sub-expression matches exactly one string, it's in prefix.
+ */
+struct PrefilterInfo
+{
+  bool nullable;                            ///< Can match the empty string
+  bool exact;                               ///< Only matches the string prefix
+  bool anchored;                            ///< Starts with '^'
+  bool first_any;                           ///< Any byte can start a match
+  uint8_t first[32];                        ///< Bitmap of the bytes that can start a match
+  char prefix[PREFILTER_LITERAL_MAX + 1];   ///< Every match starts with this
+  char suffix[PREFILTER_LITERAL_MAX + 1];   ///< Every match ends with this
+  char required[PREFILTER_LITERAL_MAX + 1]; ///< Every match contains this
+};
+
+/**
+ * struct PrefilterParser - State of the pattern parser
+ */
+struct PrefilterParser
+{
+  const char *p; ///< Current position in the pattern
+  bool icase;    ///< Pattern ignores case
+  bool failed;   ///< Construct wasn't understood
+};
+
+static void prefilter_alt(struct PrefilterParser *ps, struct PrefilterInfo *info);
+
+/**
+ * first_set - Add a byte to a first-byte bitmap
+ * @param first Bitmap
+ * @param c     Byte
+ */
+static void first_set(uint8_t *first, unsigned char c)
+{
+  first[c >> 3] |= (1 << (c & 7));
+}
+
+/**
+ * first_test - Is a byte in a first-byte bitmap?
+ * @param first Bitmap
+ * @param c     Byte
+ * @retval true The byte is in the bitmap
+ */
+static bool first_test(const uint8_t *first, unsigned char c)
+{
+  return first[c >> 3] & (1 << (c & 7));
+}
+
+/**
+ * first_set_high - Add all the non-ASCII bytes to a first-byte bitmap
+ * @param first Bitmap
+ */
+static void first_set_high(uint8_t *first)
+{
+  memset(first + 16, 0xff, 16);
+}
+
+/**
+ * first_set_char - Add a character, and its other case, to a bitmap
+ * @param first Bitmap
+ * @param c     Byte
+ */
+static void first_set_char(uint8_t *first, unsigned char c)
+{
+  first_set(first, c);
+  if (c < 0x80)
+  {
+    first_set(first, tolower(c));
+    first_set(first, toupper(c));
+  }
+}
+
+/**
+ * lit_join - Concatenate two literals
+ * @param dst      Buffer for the result, PREFILTER_LITERAL_MAX + 1 bytes
+ * @param a        First literal
+ * @param b        Second literal
+ * @param keep_end If the result is too long, keep the end, rather than the start
+ * @retval true  The whole result fitted
+ * @retval false The result was truncated
+ */
+static bool lit_join(char *dst, const char *a, const char *b, bool keep_end)
+{
+  char tmp[(2 * PREFILTER_LITERAL_MAX) + 1];
+  size_t len = snprintf(tmp, sizeof(tmp), "%s%s", a, b);
+
+  const char *src = tmp;
+  bool fitted = (len <= PREFILTER_LITERAL_MAX);
+  if (!fitted && keep_end)
+    src += len - PREFILTER_LITERAL_MAX;
+
+  mutt_str_strfcpy(dst, src, PREFILTER_LITERAL_MAX + 1);
+  return fitted;
+}
+
+/**
+ * lit_longest - Keep the longer of two literals
+ * @param dst Current literal, may be replaced
+ * @param src Candidate literal
+ */
+static void lit_longest(char *dst, const char *src)
+{
+  if (strlen(src) > strlen(dst))
+    mutt_str_strfcpy(dst, src, PREFILTER_LITERAL_MAX + 1);
+}
+
+/**
+ * info_empty - Describe a sub-expression that matches the empty string
+ * @param info Info to set
+ *
+ * This is the empty sequence, or a zero-width assertion like `\<`.
+ */
+static void info_empty(struct PrefilterInfo *info)
+{
+  memset(info, 0, sizeof(*info));
+  info->nullable = true;
+  info->exact = true;
+}
+
+/**
+ * info_class - Describe a sub-expression that matches one of a set of bytes
+ * @param info Info to set
+ * @param any  Any byte may match
+ *
+ * The caller sets the bits in info->first.
+ */
+static void info_class(struct PrefilterInfo *info, bool any)
+{
+  memset(info, 0, sizeof(*info));
+  info->first_any = any;
+}
+
+/**
+ * info_literal - Describe a literal byte
+ * @param ps   Parser
+ * @param info Info to set
+ * @param c    Byte
+ *
+ * Case-insensitive non-ASCII bytes can't be treated as literals.
+ */
+static void info_literal(struct PrefilterParser *ps, struct PrefilterInfo *info, unsigned char c)
+{
+  memset(info, 0, sizeof(*info));
+  if (ps->icase && (c >= 0x80))
+  {
+    first_set_high(info->first);
+    return;
+  }
+
+  if (ps->icase)
+  {
+    first_set_char(info->first, c);
+    c = tolower(c);
+  }
+  else
+  {
+    first_set(info->first, c);
+  }
+
+  info->exact = true;
+  info->prefix[0] = c;
+  info->suffix[0] = c;
+  info->required[0] = c;
+}
+
+/**
+ * info_concat - Describe one sub-expression followed by another
+ * @param a Info for the first sub-expression, updated with the result
+ * @param b Info for the second sub-expression
+ */
+static void info_concat(struct PrefilterInfo *a, const struct PrefilterInfo *b)
+{
+  struct PrefilterInfo r = { 0 };
+
+  r.nullable = a->nullable && b->nullable;
+  r.first_any = a->first_any || (a->nullable && b->first_any);
+  for (size_t i = 0; i < sizeof(r.first); i++)
+    r.first[i] = a->first[i] | (a->nullable ? b->first[i] : 0);
+
+  r.anchored = a->anchored || (a->exact && (a->prefix[0] == '\0') && b->anchored);
+
+  if (a->exact)
+    r.exact = lit_join(r.prefix, a->prefix, b->prefix, false) && b->exact;
+  else
+    mutt_str_strfcpy(r.prefix, a->prefix, sizeof(r.prefix));
+
+  if (b->exact)
+    lit_join(r.suffix, a->suffix, b->suffix, true);
+  else
+    mutt_str_strfcpy(r.suffix, b->suffix, sizeof(r.suffix));
+
+  /* The end of a's match is followed by the start of b's */
+  lit_join(r.required, a->suffix, b->prefix, false);
+  lit_longest(r.required, a->required);
+  lit_longest(r.required, b->required);
+  if (r.exact)
+    lit_longest(r.required, r.prefix);
+
+  *a = r;
+}
+
+/**
+ * info_alternate - Describe a choice of two sub-expressions
+ * @param a Info for the first sub-expression, updated with the result
+ * @param b Info for the second sub-expression
+ */
+static void info_alternate(struct PrefilterInfo *a, const struct PrefilterInfo *b)
+{
+  a->nullable = a->nullable || b->nullable;
+  a->first_any = a->first_any || b->first_any;
+  for (size_t i = 0; i < sizeof(a->first); i++)
+    a->first[i] |= b->first[i];
+  a->anchored = a->anchored && b->anchored;
+  a->exact = a->exact && b->exact && (strcmp(a->prefix, b->prefix) == 0);
+
+  size_t i = 0;
+  while ((a->prefix[i] != '\0') && (a->prefix[i] == b->prefix[i]))
+    i++;
+  a->prefix[i] = '\0';
+
+  size_t alen = strlen(a->suffix);
+  size_t blen = strlen(b->suffix);
+  size_t n = 0;
+  while ((n < alen) && (n < blen) && (a->suffix[alen - n - 1] == b->suffix[blen - n - 1]))
+    n++;
+  memmove(a->suffix, a->suffix + alen - n, n + 1);
+
+  a->required[0] = '\0';
+  lit_longest(a->required, a->prefix);
+  lit_longest(a->required, a->suffix);
+}
+
+/**
+ * info_repeat - Describe a repeated sub-expression
+ * @param info Info for the sub-expression, updated with the result
+ * @param min  Minimum number of repetitions
+ */
+static void info_repeat(struct PrefilterInfo *info, int min)
+{
+  info->exact = false;
+  if (min > 0)
+    return;
+
+  info->nullable = true;
+  info->anchored = false;
+  info->prefix[0] = '\0';
+  info->suffix[0] = '\0';
+  info->required[0] = '\0';
+}
+
+/**
+ * prefilter_bracket - Parse a bracket expression, e.g. `[a-z]`
+ * @param ps   Parser, positioned after the '['
+ * @param info Info to set
+ *
+ * Ranges and classes depend on the locale, so they also allow every
+ * non-ASCII byte and both cases of the letters.  A negated bracket matches
+ * (almost) anything.
+ */
+static void prefilter_bracket(struct PrefilterParser *ps, struct PrefilterInfo *info)
+{
+  info_class(info, false);
+
+  bool negate = (*ps->p == '^');
+  if (negate)
+    ps->p++;
+
+  bool first = true;
+  for (; *ps->p && ((*ps->p != ']') || first); ps->p++, first = false)
+  {
+    const char *p = ps->p;
+    if ((p[0] == '[') && ((p[1] == ':') || (p[1] == '.') || (p[1] == '=')))
+    {
+      char close[3] = { p[1], ']', '\0' };
+      const char *end = strstr(p + 2, close);
+      if (!end)
+      {
+        ps->failed = true; /* LCOV_EXCL_LINE */
+        return;            /* LCOV_EXCL_LINE */
+      }
+
+      /* Collating elements and classes, like [:alpha:], could be anything */
+      info->first_any = true;
+      ps->p = end + 1;
+      continue;
+    }
+
+    unsigned char lo = p[0];
+    unsigned char hi = lo;
+    if ((p[1] == '-') && (p[2] != ']') && (p[2] != '\0'))
+    {
+      hi = p[2];
+      ps->p += 2;
+      first_set_high(info->first);
+    }
+
+    for (unsigned int c = lo; c <= hi; c++)
+      first_set_char(info->first, c);
+    if ((lo >= 0x80) || (lo != hi))
+      first_set_high(info->first);
+  }
+
+  if (*ps->p != ']')
+  {
+    ps->failed = true; /* LCOV_EXCL_LINE */
+    return;            /* LCOV_EXCL_LINE */
+  }
+  ps->p++;
+
+  if (negate)
+    info->first_any = true;
+}
+
+/**
+ * prefilter_escape - Parse a backslash escape, e.g. `\<`
+ * @param ps   Parser, positioned after the '\'
+ * @param info Info to set
+ */
+static void prefilter_escape(struct PrefilterParser *ps, struct PrefilterInfo *info)
+{
+  unsigned char c = *ps->p;
+  if ((c == '\0') || isdigit(c))
+  {
+    /* Back-references aren't supported */
+    ps->failed = true;
+    return;
+  }
+  ps->p++;
+
+  if (strchr("<>bB`'", c))
+  {
+    info_empty(info);
+  }
+  else if (c == 'w')
+  {
+    info_class(info, false);
+    for (unsigned int i = 0; i < 0x80; i++)
+      if (isalnum(i) || (i == '_'))
+        first_set(info->first, i);
+    first_set_high(info->first);
+  }
+  else if (strchr("WsS", c))
+  {
+    info_class(info, true);
+  }
+  else
+  {
+    info_literal(ps, info, c);
+  }
+}
+
+/**
+ * prefilter_atom - Parse an atom and any repetitions of it
+ * @param ps   Parser
+ * @param info Info to set
+ */
+static void prefilter_atom(struct PrefilterParser *ps, struct PrefilterInfo *info)
+{
+  unsigned char c = *ps->p++;
+  switch (c)
+  {
+    case '(':
+      prefilter_alt(ps, info);
+      if (*ps->p != ')')
+      {
+        ps->failed = true;
+        return;
+      }
+      ps->p++;
+      break;
+
+    case '^':
+      info_empty(info);
+      info->anchored = true;
+      break;
+
+    case '$':
+      info_empty(info);
+      break;
+
+    case '.':
+      info_class(info, true);
+      break;
+
+    case '[':
+      prefilter_bracket(ps, info);
+      break;
+
+    case '\\':
+      prefilter_escape(ps, info);
+      break;
+
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+      ps->failed = true;
+      return;
+
+    default:
+      info_literal(ps, info, c);
+      /* A multi-byte character is a single atom */
+      while (((unsigned char) *ps->p & 0xC0) == 0x80)
+      {
+        struct PrefilterInfo tail;
+        info_literal(ps, &tail, *ps->p++);
+        info_concat(info, &tail);
+      }
+      break;
+  }
+
+  while (!ps->failed)
+  {
+    c = *ps->p;
+    if ((c == '*') || (c == '?'))
+    {
+      info_repeat(info, 0);
+    }
+    else if (c == '+')
+    {
+      info_repeat(info, 1);
+    }
+    else if (c == '{')
+    {
+      char *end = NULL;
+      long min = strtol(ps->p + 1, &end, 10);
+      end += strspn(end, ",0123456789");
+      if ((*end != '}') || (min < 0))
+      {
+        ps->failed = true;
+        return;
+      }
+      info_repeat(info, min);
+      ps->p = end;
+    }
+    else
+    {
+      break;
+    }
+    ps->p++;
+  }
+}
+
+/**
+ * prefilter_alt - Parse a list of alternatives, e.g. `a|b|c`
+ * @param ps   Parser
+ * @param info Info to set
+ */
+static void prefilter_alt(struct PrefilterParser *ps, struct PrefilterInfo *info)
+{
+  struct PrefilterInfo branch;
+  struct PrefilterInfo atom;
+
+  for (bool first = true; !ps->failed; first = false)
+  {
+    info_empty(&branch);
+    while (*ps->p && (*ps->p != '|') && (*ps->p != ')') && !ps->failed)
+    {
+      prefilter_atom(ps, &atom);
+      info_concat(&branch, &atom);
+    }
+
+    if (first)
+      *info = branch;
+    else
+      info_alternate(info, &branch);
+
+    if (*ps->p != '|')
+      break;
+    ps->p++;
+  }
+}
+
+/**
+ * prefilter_new - Analyse a regex
+ * @param pattern POSIX extended regex
+ * @param rflags  Flags passed to regcomp(), e.g. REG_ICASE
+ * @retval ptr  New Prefilter
+ * @retval NULL The regex can't be prefiltered
+ *
+ * The pattern must already have been compiled by regcomp().
+ */
+struct RegexPrefilter *prefilter_new(const char *pattern, int rflags)
+{
+  if (!pattern)
+    return NULL;
+
+  struct PrefilterParser ps = { pattern, (rflags & REG_ICASE), false };
+  struct PrefilterInfo info;
+  prefilter_alt(&ps, &info);
+  if (ps.failed || (*ps.p != '\0'))
+    return NULL;
+
+  bool use_first = !info.nullable && !info.first_any;
+  if ((info.required[0] == '\0') && !use_first &&
+      !(info.anchored && (info.prefix[0] != '\0')))
+  {
+    return NULL;
+  }
+
+  struct RegexPrefilter *pf = mutt_mem_calloc(1, sizeof(*pf));
+  mutt_str_strfcpy(pf->required, info.required, sizeof(pf->required));
+  if (info.anchored)
+    mutt_str_strfcpy(pf->prefix, info.prefix, sizeof(pf->prefix));
+  pf->anchored = info.anchored;
+  pf->icase = ps.icase;
+  pf->use_first = use_first;
+  memcpy(pf->first, info.first, sizeof(pf->first));
+
+  /* Searching for a few bytes is fast, more isn't worth it */
+  size_t count = 0;
+  for (unsigned int c = 1; use_first && (c < 256) && (count <= PREFILTER_FIRST_MAX); c++)
+    if (first_test(info.first, c))
+      pf->first_list[count++] = c;
+  if (count > PREFILTER_FIRST_MAX)
+    memset(pf->first_list, 0, sizeof(pf->first_list));
+
+  return pf;
+}
+
+/**
+ * prefilter_free - Free a Prefilter
+ * @param[out] ptr Prefilter to free
+ */
+void prefilter_free(struct RegexPrefilter **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  FREE(ptr);
+}
+
+/**
+ * prefilter_is_ascii - Is a string pure ASCII?
+ * @param str String to test
+ * @retval true Every byte is below 0x80
+ */
+static bool prefilter_is_ascii(const char *str)
+{
+  for (const unsigned char *s = (const unsigned char *) str; *s; s++)
+    if (*s >= 0x80)
+      return false;
+
+  return true;
+}
+
+/**
+ * prefilter_lacks_icase - Is a literal missing from a string, ignoring case?
+ * @param str String to search
+ * @param lit Literal, in lower case
+ * @retval true  The string is ASCII and doesn't contain the literal
+ * @retval false The literal was found, or the string isn't ASCII
+ *
+ * The string is searched in one pass, stopping at the first non-ASCII byte.
+ */
+static bool prefilter_lacks_icase(const char *str, const char *lit)
+{
+  const unsigned char first = lit[0];
+  const unsigned char other = toupper(first);
+  const size_t len = strlen(lit + 1);
+
+  for (const unsigned char *s = (const unsigned char *) str; *s; s++)
+  {
+    if (*s >= 0x80)
+      return false;
+    if (((*s == first) || (*s == other)) &&
+        (strncasecmp((const char *) s + 1, lit + 1, len) == 0))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * prefilter_reject - Can a string be ruled out without running the regex?
+ * @param pf  Prefilter, may be NULL
+ * @param str String to test
+ * @retval true  The regex can't match the string
+ * @retval false The regex must be run
+ */
+bool prefilter_reject(const struct RegexPrefilter *pf, const char *str)
+{
+  if (!pf || !str)
+    return false;
+
+  /* Case-insensitive comparisons are only reliable for ASCII */
+  if (pf->anchored)
+  {
+    size_t len = strlen(pf->prefix);
+    bool reject = pf->icase ? (strncasecmp(str, pf->prefix, len) != 0) :
+                              (strncmp(str, pf->prefix, len) != 0);
+    if (!reject && pf->use_first)
+      reject = !first_test(pf->first, *str);
+    if (reject)
+      return !pf->icase || prefilter_is_ascii(str);
+  }
+
+  if (pf->required[0] != '\0')
+  {
+    if (pf->icase)
+      return prefilter_lacks_icase(str, pf->required);
+    return !strstr(str, pf->required);
+  }
+
+  if (!pf->anchored && (pf->first_list[0] != '\0') && !strpbrk(str, pf->first_list))
+    return !pf->icase || prefilter_is_ascii(str);
+
+  return false;
+}
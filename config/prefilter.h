@@ -0,0 +1,50 @@
+/**
+ * @file
+ * Cheap tests to avoid running a regex
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_PREFILTER_H
+#define MUTT_CONFIG_PREFILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PREFILTER_LITERAL_MAX 64 ///< Longest literal that's kept
+#define PREFILTER_FIRST_MAX   16 ///< Most first bytes that are searched for
+
+/**
+ * struct RegexPrefilter - Facts about every string a regex can match
+ */
+struct RegexPrefilter
+{
+  char required[PREFILTER_LITERAL_MAX + 1]; ///< Every match contains this literal
+  char prefix[PREFILTER_LITERAL_MAX + 1];   ///< Anchored matches start with this literal
+  bool anchored;                            ///< Matches must start at the beginning of the string
+  bool icase;                               ///< Literals are lower case and compared ignoring case
+  bool use_first;                           ///< The first byte of a match must be in first
+  uint8_t first[32];                        ///< Bitmap of the possible first bytes of a match
+  char first_list[PREFILTER_FIRST_MAX + 1]; ///< The possible first bytes, if there are few
+};
+
+struct RegexPrefilter *prefilter_new   (const char *pattern, int rflags);
+void                   prefilter_free  (struct RegexPrefilter **ptr);
+bool                   prefilter_reject(const struct RegexPrefilter *pf, const char *str);
+
+#endif /* MUTT_CONFIG_PREFILTER_H */
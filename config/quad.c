@@ -31,6 +31,8 @@
 #include <limits.h>
 #include <stdint.h>
 #include "mutt/mutt.h"
+#include "lookup.h"
+#include "quad.h"
 #include "set.h"
 #include "types.h"
 
@@ -43,6 +45,19 @@ const char *QuadValues[] = {
   "no", "yes", "ask-no", "ask-yes", NULL,
 };
 
+// clang-format off
+/**
+ * QuadMap - Lookup table for QuadValues
+ */
+static const struct Mapping QuadMap[] = {
+  { "no",      MUTT_NO },
+  { "yes",     MUTT_YES },
+  { "ask-no",  MUTT_ASKNO },
+  { "ask-yes", MUTT_ASKYES },
+  { NULL,      0 },
+};
+// clang-format on
+
 /**
  * quad_string_set - Set a Quad-option by string - Implements ::cst_string_set()
  */
@@ -52,16 +67,7 @@ static int quad_string_set(const struct ConfigSet *cs, void *var, struct ConfigD
   if (!cs || !cdef || !value)
     return CSR_ERR_CODE; /* LCOV_EXCL_LINE */
 
-  int num = -1;
-  for (size_t i = 0; QuadValues[i]; i++)
-  {
-    if (mutt_str_strcasecmp(QuadValues[i], value) == 0)
-    {
-      num = i;
-      break;
-    }
-  }
-
+  int num = lookup_get_value(value, QuadMap);
   if (num < 0)
   {
     mutt_buffer_printf(err, "Invalid quad value: %s", value);
@@ -199,6 +205,7 @@ void quad_init(struct ConfigSet *cs)
     NULL,
   };
   cs_register_type(cs, DT_QUAD, &cst_quad);
+  lookup_register(QuadMap);
 }
 
 /**
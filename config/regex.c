@@ -24,19 +24,436 @@
  * @page config_regex Type: Regular expression
  *
  * Type representing a regular expression.
+ *
+ * Every Regex is compiled by POSIX regcomp(), so code that calls regexec()
+ * on its regex_t keeps working.  If another engine has been chosen, using
+ * regex_engine_set(), the Regex is also compiled by that, and regex_exec() and
+ * regex_match() will use it.
+ *
+ * The pattern is translated for the other engine, e.g. `\<` becomes
+ * `\b(?=\w)`.  If the translation or compilation fails, or the subject isn't
+ * valid UTF-8, matching falls back to POSIX.
+ *
+ * PCRE2 finds the leftmost-first match, where POSIX finds the leftmost-longest,
+ * e.g. `a|ab` against "ab".  Whether a string matches is the same, but the
+ * offsets can differ, so callers that ask for sub-matches always get them from
+ * POSIX.
+ *
+ * | Engine | Build option  | Notes                                     |
+ * | :----- | :------------ | :---------------------------------------- |
+ * | posix  |               | The default, always available             |
+ * | pcre2  | `HAVE_PCRE2`  | Only if chosen, only for yes/no matches   |
+ *
+ * A pattern that may be slow to match, see @ref config_complexity, is
+ * flagged with a warning when the config item is set.  It's matched with a
+ * budget, fixed when it's compiled: strings longer than a limit aren't matched
+ * and regex_exec() returns REG_ESPACE.  The same string always gets the same
+ * result.  Validators can reject such patterns using regex_risk().
+ *
+ * PCRE2 backtracks, so a string within the budget can still take it
+ * exponential time.  Its backtracking is limited in proportion to the budget,
+ * and if the limit is reached, the string is matched by POSIX instead.
  */
 
 #include "config.h"
 #include <stddef.h>
+#include <ctype.h>
 #include <limits.h>
+#include <pthread.h>
 #include <regex.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "mutt/mutt.h"
 #include "regex2.h"
+#include "complexity.h"
+#include "intern.h"
+#include "prefilter.h"
 #include "set.h"
+#include "shared.h"
 #include "types.h"
 
+#ifdef HAVE_PCRE2
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+#endif
+
+struct RegexCompiled;
+
+#define REGEX_BUDGET_NESTED  512 ///< Longest string matched by a pattern with nested repetition
+#define REGEX_BUDGET_BACKREF 64  ///< Longest string matched by a pattern with a back-reference
+
+/**
+ * struct RegexEngine - A regular expression engine
+ */
+struct RegexEngine
+{
+  const char *name; ///< Name of the engine, e.g. "pcre2"
+
+  /**
+   * compile - Compile a pattern
+   * @param rc     Regex to compile
+   * @param str    Pattern, without any '!' prefix
+   * @param rflags POSIX flags, e.g. REG_ICASE
+   * @retval true Success, rc->code is set
+   */
+  bool (*compile)(struct RegexCompiled *rc, const char *str, int rflags);
+
+  /**
+   * exec - Match a string
+   * @param rc     Compiled Regex
+   * @param str    String to match
+   * @param nmatch Size of pmatch
+   * @param pmatch Matches, as regexec()
+   * @retval num Result, as regexec(), e.g. REG_NOMATCH
+   */
+  int (*exec)(const struct RegexCompiled *rc, const char *str, size_t nmatch, regmatch_t pmatch[]);
+
+  /**
+   * free - Free the compiled pattern
+   * @param rc Compiled Regex
+   */
+  void (*free)(struct RegexCompiled *rc);
+};
+
+/**
+ * struct RegexCompiled - A Regex, created by regex_new()
+ */
+struct RegexCompiled
+{
+  struct Regex regex;               ///< The Regex (must be first)
+  const struct RegexEngine *engine; ///< Engine that compiled the pattern
+  void *code;                       ///< Engine's compiled pattern
+  bool nosub;                       ///< Compiled with REG_NOSUB
+  struct RegexPrefilter *prefilter; ///< Rule out strings without running the Regex
+  enum RegexRisk risk;              ///< How slow the pattern might be
+  size_t budget;                    ///< Longest string that's matched, 0 for no limit
+};
+
+/**
+ * posix_exec - Match a string using POSIX - Implements RegexEngine::exec()
+ */
+static int posix_exec(const struct RegexCompiled *rc, const char *str,
+                      size_t nmatch, regmatch_t pmatch[])
+{
+  return regexec(rc->regex.regex, str, nmatch, pmatch, 0);
+}
+
+/**
+ * posix_compile - Compile a pattern using POSIX - Implements RegexEngine::compile()
+ *
+ * The regex_t has already been compiled.
+ */
+static bool posix_compile(struct RegexCompiled *rc, const char *str, int rflags)
+{
+  return true;
+}
+
+/**
+ * posix_free - Free a POSIX pattern - Implements RegexEngine::free()
+ */
+static void posix_free(struct RegexCompiled *rc)
+{
+}
+
+static const struct RegexEngine RegexEnginePosix = {
+  "posix", posix_compile, posix_exec, posix_free,
+};
+
+#ifdef HAVE_PCRE2
+#define PCRE2_MATCH_PER_BYTE 1000 ///< Backtracking steps for each byte of a risky pattern's budget
+
+/**
+ * struct Pcre2Thread - PCRE2 state for one thread
+ */
+struct Pcre2Thread
+{
+  pcre2_match_data *match_data; ///< Match data, big enough for a yes/no match
+  pcre2_match_context *limit;   ///< Match context, limiting the work done by risky patterns
+};
+
+static pthread_key_t Pcre2ThreadKey;                  ///< Each thread's Pcre2Thread
+static pthread_once_t Pcre2ThreadOnce = PTHREAD_ONCE_INIT; ///< Creates Pcre2ThreadKey
+
+/**
+ * pcre2_thread_free - Free a thread's PCRE2 state
+ * @param ptr Pcre2Thread to free
+ *
+ * This is called when the thread exits.
+ */
+static void pcre2_thread_free(void *ptr)
+{
+  struct Pcre2Thread *pt = ptr;
+  pcre2_match_data_free(pt->match_data);
+  pcre2_match_context_free(pt->limit);
+  FREE(&pt);
+}
+
+/**
+ * pcre2_thread_key - Create the key for the threads' PCRE2 state
+ */
+static void pcre2_thread_key(void)
+{
+  pthread_key_create(&Pcre2ThreadKey, pcre2_thread_free);
+}
+
+/**
+ * pcre2_thread_get - Get this thread's PCRE2 state
+ * @retval ptr Pcre2Thread, created on first use
+ */
+static struct Pcre2Thread *pcre2_thread_get(void)
+{
+  pthread_once(&Pcre2ThreadOnce, pcre2_thread_key);
+
+  struct Pcre2Thread *pt = pthread_getspecific(Pcre2ThreadKey);
+  if (pt)
+    return pt;
+
+  pt = mutt_mem_calloc(1, sizeof(*pt));
+  pt->match_data = pcre2_match_data_create(1, NULL);
+  pt->limit = pcre2_match_context_create(NULL);
+  pthread_setspecific(Pcre2ThreadKey, pt);
+  return pt;
+}
+
+/**
+ * pcre2_translate - Convert a POSIX extended regex to PCRE2 syntax
+ * @param str POSIX pattern
+ * @param buf Buffer for the PCRE2 pattern
+ * @retval true  Success
+ * @retval false The pattern needs POSIX
+ *
+ * GNU's word boundaries become lookarounds and a backslash in a bracket
+ * expression becomes literal.  Escapes whose meaning differs, or collating
+ * elements, need POSIX.
+ */
+static bool pcre2_translate(const char *str, struct Buffer *buf)
+{
+  for (const char *p = str; *p; p++)
+  {
+    if (*p == '\\')
+    {
+      p++;
+      if (*p == '\0')
+        return false;
+      else if (*p == '<')
+        mutt_buffer_addstr(buf, "\\b(?=\\w)");
+      else if (*p == '>')
+        mutt_buffer_addstr(buf, "\\b(?<=\\w)");
+      else if (strchr("bBwWsS", *p) || (!isalnum((unsigned char) *p) && !strchr("`'", *p)))
+        mutt_buffer_add_printf(buf, "\\%c", *p);
+      else
+        return false;
+      continue;
+    }
+
+    if (*p != '[')
+    {
+      mutt_buffer_addch(buf, *p);
+      continue;
+    }
+
+    /* A bracket expression: a leading ']' is literal, as is a backslash */
+    mutt_buffer_addch(buf, *p++);
+    if (*p == '^')
+      mutt_buffer_addch(buf, *p++);
+    if (*p == ']')
+    {
+      mutt_buffer_addstr(buf, "\\]");
+      p++;
+    }
+
+    for (; *p && (*p != ']'); p++)
+    {
+      if ((p[0] == '[') && (p[1] == ':'))
+      {
+        const char *end = strstr(p + 2, ":]");
+        if (!end)
+          return false;
+        mutt_buffer_addstr_n(buf, p, end + 2 - p);
+        p = end + 1;
+      }
+      else if ((p[0] == '[') && ((p[1] == '.') || (p[1] == '=')))
+      {
+        return false;
+      }
+      else if ((*p == '\\') || (*p == '['))
+      {
+        mutt_buffer_addch(buf, '\\');
+        mutt_buffer_addch(buf, *p);
+      }
+      else
+      {
+        mutt_buffer_addch(buf, *p);
+      }
+    }
+
+    if (*p != ']')
+      return false;
+    mutt_buffer_addch(buf, *p);
+  }
+
+  return true;
+}
+
+/**
+ * pcre2_engine_compile - Compile a pattern using PCRE2 - Implements RegexEngine::compile()
+ *
+ * The options give POSIX's behaviour: '.' matches a newline and '$' only
+ * matches at the end of the string.
+ */
+static bool pcre2_engine_compile(struct RegexCompiled *rc, const char *str, int rflags)
+{
+  struct Buffer *buf = mutt_buffer_pool_get();
+  if (!pcre2_translate(str, buf))
+  {
+    mutt_buffer_pool_release(&buf);
+    return false;
+  }
+
+  uint32_t opts = PCRE2_UTF | PCRE2_UCP | PCRE2_DOTALL | PCRE2_DOLLAR_ENDONLY;
+  if (rflags & REG_ICASE)
+    opts |= PCRE2_CASELESS;
+  if (rflags & REG_NOSUB)
+    opts |= PCRE2_NO_AUTO_CAPTURE;
+
+  int errcode = 0;
+  PCRE2_SIZE erroffset = 0;
+  pcre2_code *code = pcre2_compile((PCRE2_SPTR) mutt_b2s(buf), PCRE2_ZERO_TERMINATED,
+                                   opts, &errcode, &erroffset, NULL);
+  mutt_buffer_pool_release(&buf);
+  if (!code)
+    return false;
+
+  /* Without the JIT, PCRE2 interprets the pattern */
+  pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+  rc->code = code;
+  return true;
+}
+
+/**
+ * pcre2_engine_exec - Match a string using PCRE2 - Implements RegexEngine::exec()
+ *
+ * PCRE2's sub-matches can differ from POSIX's, so if the caller wants them,
+ * POSIX is used.
+ */
+static int pcre2_engine_exec(const struct RegexCompiled *rc, const char *str,
+                             size_t nmatch, regmatch_t pmatch[])
+{
+  if (rc->nosub)
+    nmatch = 0;
+  if (nmatch > 0)
+    return posix_exec(rc, str, nmatch, pmatch);
+
+  struct Pcre2Thread *pt = pcre2_thread_get();
+  pcre2_match_context *mc = NULL;
+  if (rc->risk != REGEX_RISK_NONE)
+  {
+    mc = pt->limit;
+    pcre2_set_match_limit(mc, rc->budget * PCRE2_MATCH_PER_BYTE);
+  }
+
+  int rc_match = pcre2_match(rc->code, (PCRE2_SPTR) str, strlen(str), 0, 0,
+                             pt->match_data, mc);
+
+  if (rc_match >= 0)
+    return 0;
+  if (rc_match == PCRE2_ERROR_NOMATCH)
+    return REG_NOMATCH;
+
+  /* e.g. too much backtracking, or invalid UTF-8.  The string is within the
+   * budget, so POSIX will match it in reasonable time. */
+  return posix_exec(rc, str, 0, NULL);
+}
+
+/**
+ * pcre2_engine_free - Free a PCRE2 pattern - Implements RegexEngine::free()
+ */
+static void pcre2_engine_free(struct RegexCompiled *rc)
+{
+  pcre2_code_free(rc->code);
+  rc->code = NULL;
+}
+
+static const struct RegexEngine RegexEnginePcre2 = {
+  "pcre2", pcre2_engine_compile, pcre2_engine_exec, pcre2_engine_free,
+};
+#endif
+
+/* The available engines */
+static const struct RegexEngine *RegexEngines[] = {
+  &RegexEnginePosix,
+#ifdef HAVE_PCRE2
+  &RegexEnginePcre2,
+#endif
+};
+
+static const struct RegexEngine *RegexEngineCurrent = NULL;
+
+/**
+ * regex_shared_free - Free a shared Regex - Implements ::shared_free_t
+ */
+static void regex_shared_free(void **obj)
+{
+  regex_free((struct Regex **) obj);
+}
+
+/**
+ * regex_shared - Get a shared Regex
+ * @param cs    Config items
+ * @param str   Regular expression
+ * @param flags Type flags, e.g. #DT_REGEX_MATCH_CASE
+ * @param err   Buffer for error messages
+ * @retval ptr  Shared Regex, with a new reference
+ * @retval NULL Error
+ *
+ * If the regex is already in use, it won't be compiled again.
+ */
+static struct Regex *regex_shared(const struct ConfigSet *cs, const char *str,
+                                  int flags, struct Buffer *err)
+{
+  if (!str)
+    return NULL;
+
+  flags &= (DT_REGEX_MATCH_CASE | DT_REGEX_ALLOW_NOT | DT_REGEX_NOSUB);
+
+  struct Buffer *key = mutt_buffer_alloc(256);
+  mutt_buffer_printf(key, "regex:%s:%x:%s", regex_engine_get(), flags, str);
+
+  struct Regex *r = cs_shared_find(cs, mutt_b2s(key));
+  if (!r)
+  {
+    r = regex_new(str, flags, err);
+    if (r)
+      r = cs_shared_add(cs, mutt_b2s(key), r, regex_shared_free);
+  }
+
+  mutt_buffer_free(&key);
+  return r;
+}
+
+/**
+ * regex_warn_risk - Warn the user about a slow pattern
+ * @param cdef Config definition
+ * @param r    Regex
+ * @param err  Buffer for the warning
+ * @retval num Result, #CSR_SUC_WARNING if the pattern is risky
+ */
+static int regex_warn_risk(const struct ConfigDef *cdef, const struct Regex *r,
+                           struct Buffer *err)
+{
+  enum RegexRisk risk = regex_risk(r);
+  if (risk == REGEX_RISK_NONE)
+    return CSR_SUCCESS;
+
+  if (mutt_buffer_is_empty(err))
+  {
+    mutt_buffer_printf(err, "Option %s: '%s' may be slow to match (%s), strings over %zu bytes won't be matched",
+                       cdef->name, r->pattern, complexity_risk_name(risk), regex_budget(r));
+  }
+  return CSR_SUCCESS | CSR_SUC_WARNING;
+}
+
 /**
  * regex_destroy - Destroy a Regex object - Implements ::cst_destroy()
  */
@@ -49,7 +466,8 @@ static void regex_destroy(const struct ConfigSet *cs, void *var, const struct Co
   if (!*r)
     return;
 
-  regex_free(r);
+  if (!cs_shared_release(cs, var))
+    regex_free(r);
 }
 
 /**
@@ -77,7 +495,7 @@ static int regex_string_set(const struct ConfigSet *cs, void *var, struct Config
 
     if (value)
     {
-      r = regex_new(value, cdef->type, err);
+      r = regex_shared(cs, value, cdef->type, err);
       if (!r)
         return CSR_ERR_INVALID;
     }
@@ -88,11 +506,12 @@ static int regex_string_set(const struct ConfigSet *cs, void *var, struct Config
 
       if (CSR_RESULT(rc) != CSR_SUCCESS)
       {
-        regex_free(&r);
+        regex_destroy(cs, &r, cdef);
         return rc | CSR_INV_VALIDATOR;
       }
     }
 
+    rc |= regex_warn_risk(cdef, r, err);
     regex_destroy(cs, var, cdef);
 
     *(struct Regex **) var = r;
@@ -102,11 +521,7 @@ static int regex_string_set(const struct ConfigSet *cs, void *var, struct Config
   }
   else
   {
-    if (cdef->type & DT_INITIAL_SET)
-      FREE(&cdef->initial);
-
-    cdef->type |= DT_INITIAL_SET;
-    cdef->initial = IP mutt_str_strdup(value);
+    cs_intern_initial(cs, cdef, value);
   }
 
   return rc;
@@ -164,10 +579,12 @@ static int regex_native_set(const struct ConfigSet *cs, void *var,
   struct Regex *orig = (struct Regex *) value;
   struct Regex *r = NULL;
 
+  /* Compile with this item's flags.  If orig is shared and was compiled with
+   * the same flags, it's found by its key and reused. */
   if (orig && orig->pattern)
   {
-    const int flags = orig->not? DT_REGEX_ALLOW_NOT : 0;
-    r = regex_new(orig->pattern, flags, err);
+    const int flags = (orig->not ? DT_REGEX_ALLOW_NOT : 0) | cdef->type;
+    r = regex_shared(cs, orig->pattern, flags, err);
     if (!r)
       rc = CSR_ERR_INVALID;
   }
@@ -178,7 +595,8 @@ static int regex_native_set(const struct ConfigSet *cs, void *var,
 
   if (CSR_RESULT(rc) == CSR_SUCCESS)
   {
-    regex_free(var);
+    rc |= regex_warn_risk(cdef, r, err);
+    regex_destroy(cs, var, cdef);
     *(struct Regex **) var = r;
   }
 
@@ -223,7 +641,7 @@ static int regex_reset(const struct ConfigSet *cs, void *var,
 
   if (initial)
   {
-    r = regex_new(initial, cdef->type, err);
+    r = regex_shared(cs, initial, cdef->type, err);
     if (!r)
       return CSR_ERR_CODE;
   }
@@ -242,6 +660,7 @@ static int regex_reset(const struct ConfigSet *cs, void *var,
   if (!r)
     rc |= CSR_SUC_EMPTY;
 
+  rc |= regex_warn_risk(cdef, r, err);
   regex_destroy(cs, var, cdef);
 
   *(struct Regex **) var = r;
@@ -275,7 +694,8 @@ struct Regex *regex_new(const char *str, int flags, struct Buffer *err)
     return NULL;
 
   int rflags = 0;
-  struct Regex *reg = mutt_mem_calloc(1, sizeof(struct Regex));
+  struct RegexCompiled *rc = mutt_mem_calloc(1, sizeof(*rc));
+  struct Regex *reg = &rc->regex;
 
   reg->regex = mutt_mem_calloc(1, sizeof(regex_t));
   reg->pattern = mutt_str_strdup(str);
@@ -294,14 +714,28 @@ struct Regex *regex_new(const char *str, int flags, struct Buffer *err)
     str++;
   }
 
-  int rc = REG_COMP(reg->regex, str, rflags);
-  if ((rc != 0) && err)
+  int rc_comp = REG_COMP(reg->regex, str, rflags);
+  if ((rc_comp != 0) && err)
   {
-    regerror(rc, reg->regex, err->data, err->dsize);
+    regerror(rc_comp, reg->regex, err->data, err->dsize);
     regex_free(&reg);
     return NULL;
   }
 
+  rc->engine = RegexEngineCurrent ? RegexEngineCurrent : &RegexEnginePosix;
+  rc->nosub = (rflags & REG_NOSUB);
+  if (!rc->engine->compile(rc, str, rflags))
+    rc->engine = &RegexEnginePosix;
+
+  if (rc_comp == 0)
+    rc->prefilter = prefilter_new(str, rflags);
+
+  rc->risk = complexity_risk(str);
+  if (rc->risk == REGEX_RISK_BACKREF)
+    rc->budget = REGEX_BUDGET_BACKREF;
+  else if (rc->risk == REGEX_RISK_NESTED)
+    rc->budget = REGEX_BUDGET_NESTED;
+
   return reg;
 }
 
@@ -314,9 +748,224 @@ void regex_free(struct Regex **r)
   if (!r || !*r)
     return;
 
+  struct RegexCompiled *rc = (struct RegexCompiled *) *r;
+  if (rc->engine)
+    rc->engine->free(rc);
+  prefilter_free(&rc->prefilter);
+
   FREE(&(*r)->pattern);
   if ((*r)->regex)
     regfree((*r)->regex);
   FREE(&(*r)->regex);
   FREE(r);
 }
+
+/**
+ * regex_engine_set - Choose the engine for new Regexes
+ * @param name Name of the engine, e.g. "pcre2", NULL for the default, "posix"
+ * @retval true  Success
+ * @retval false The engine isn't available
+ *
+ * Regexes that have already been compiled are unaffected.
+ */
+bool regex_engine_set(const char *name)
+{
+  if (!name)
+  {
+    RegexEngineCurrent = NULL;
+    return true;
+  }
+
+  for (size_t i = 0; i < mutt_array_size(RegexEngines); i++)
+  {
+    if (mutt_str_strcmp(name, RegexEngines[i]->name) == 0)
+    {
+      RegexEngineCurrent = RegexEngines[i];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * regex_engine_get - Get the name of the engine for new Regexes
+ * @retval ptr Name of the engine, e.g. "posix"
+ */
+const char *regex_engine_get(void)
+{
+  if (RegexEngineCurrent)
+    return RegexEngineCurrent->name;
+
+  return RegexEnginePosix.name;
+}
+
+/**
+ * regex_engine_name - Which engine compiled a Regex?
+ * @param r Regex, created by regex_new()
+ * @retval ptr  Name of the engine, e.g. "posix"
+ * @retval NULL r is NULL
+ */
+const char *regex_engine_name(const struct Regex *r)
+{
+  if (!r)
+    return NULL;
+
+  const struct RegexCompiled *rc = (const struct RegexCompiled *) r;
+  return rc->engine->name;
+}
+
+/**
+ * regex_prefilter - Get a Regex's prefilter
+ * @param r Regex, created by regex_new()
+ * @retval ptr  Prefilter
+ * @retval NULL The Regex has no prefilter
+ */
+const struct RegexPrefilter *regex_prefilter(const struct Regex *r)
+{
+  if (!r)
+    return NULL;
+
+  const struct RegexCompiled *rc = (const struct RegexCompiled *) r;
+  return rc->prefilter;
+}
+
+/**
+ * regex_risk - How slow might a Regex be to match?
+ * @param r Regex, created by regex_new()
+ * @retval enum Risk, e.g. #REGEX_RISK_NESTED
+ */
+enum RegexRisk regex_risk(const struct Regex *r)
+{
+  if (!r)
+    return REGEX_RISK_NONE;
+
+  const struct RegexCompiled *rc = (const struct RegexCompiled *) r;
+  return rc->risk;
+}
+
+/**
+ * regex_budget - Get the longest string a Regex will match
+ * @param r Regex, created by regex_new()
+ * @retval num Length, in bytes, 0 if there's no limit
+ */
+size_t regex_budget(const struct Regex *r)
+{
+  if (!r)
+    return 0;
+
+  const struct RegexCompiled *rc = (const struct RegexCompiled *) r;
+  return rc->budget;
+}
+
+/**
+ * regex_bounded_exec - Match a string against a risky Regex
+ * @param rc     Compiled Regex
+ * @param str    String to match
+ * @param nmatch Size of pmatch
+ * @param pmatch Matches, as regexec()
+ * @retval num Result, as regexec(), REG_ESPACE if the string is too long
+ *
+ * The time taken by a risky pattern grows faster than the length of the
+ * string, so limiting the length limits the time.
+ */
+static int regex_bounded_exec(const struct RegexCompiled *rc, const char *str,
+                              size_t nmatch, regmatch_t pmatch[])
+{
+  if (strnlen(str, rc->budget + 1) > rc->budget)
+    return REG_ESPACE;
+
+  return rc->engine->exec(rc, str, nmatch, pmatch);
+}
+
+/**
+ * regex_exec - Match a string against a Regex
+ * @param r      Regex, created by regex_new()
+ * @param str    String to match
+ * @param nmatch Size of pmatch
+ * @param pmatch Matches, as regexec()
+ * @retval 0           Match
+ * @retval REG_NOMATCH No match
+ * @retval REG_ESPACE  The string is longer than a risky Regex's budget
+ *
+ * This is regexec(), using the engine that compiled the Regex.  The Regex's
+ * "not" flag is ignored.  Strings that the Regex's prefilter rules out aren't
+ * matched at all.
+ *
+ * If the pattern is risky, see regex_risk(), strings longer than its budget
+ * aren't matched.  Callers that need to tell these from strings that don't
+ * match should check for REG_ESPACE.
+ */
+int regex_exec(const struct Regex *r, const char *str, size_t nmatch, regmatch_t pmatch[])
+{
+  if (!r || !str)
+    return REG_NOMATCH;
+
+  const struct RegexCompiled *rc = (const struct RegexCompiled *) r;
+  if (prefilter_reject(rc->prefilter, str))
+    return REG_NOMATCH;
+
+  if (rc->risk != REGEX_RISK_NONE)
+    return regex_bounded_exec(rc, str, nmatch, pmatch);
+
+  return rc->engine->exec(rc, str, nmatch, pmatch);
+}
+
+/**
+ * regex_match_result - Turn the result of a match into a yes/no answer
+ * @param r   Regex
+ * @param str String that was matched
+ * @param rc  Result, as regex_exec()
+ * @retval true The string matches, or doesn't, if the Regex has a '!' prefix
+ */
+static bool regex_match_result(const struct Regex *r, const char *str, int rc)
+{
+  if (rc == REG_ESPACE)
+  {
+    mutt_debug(LL_DEBUG1, "'%s' wasn't matched, %zu bytes is over its budget of %zu\n",
+               r->pattern, strlen(str), regex_budget(r));
+    return false;
+  }
+  if ((rc != 0) && (rc != REG_NOMATCH))
+    return false;
+
+  return (rc == 0) ^ r->not;
+}
+
+/**
+ * regex_match - Does a string match a Regex?
+ * @param r   Regex, created by regex_new()
+ * @param str String to match
+ * @retval true The string matches, or doesn't, if the Regex has a '!' prefix
+ *
+ * A string that's too long for a risky Regex isn't matched, so the result is
+ * false, whatever the prefix.  This is logged; callers that need to know
+ * should use regex_exec().
+ */
+bool regex_match(const struct Regex *r, const char *str)
+{
+  if (!r || !str)
+    return false;
+
+  return regex_match_result(r, str, regex_exec(r, str, 0, NULL));
+}
+
+/**
+ * regex_match_unfiltered - Does a string match a Regex, skipping its prefilter?
+ * @param r   Regex, created by regex_new()
+ * @param str String to match
+ * @retval true The string matches, or doesn't, if the Regex has a '!' prefix
+ *
+ * This is regex_match() for a caller that has already done the prefilter's
+ * work, e.g. a RegexGroup that has found the Regex's required literal.
+ */
+bool regex_match_unfiltered(const struct Regex *r, const char *str)
+{
+  if (!r || !str)
+    return false;
+
+  const struct RegexCompiled *rc = (const struct RegexCompiled *) r;
+  int rc_exec = (rc->risk != REGEX_RISK_NONE) ? regex_bounded_exec(rc, str, 0, NULL) :
+                                                rc->engine->exec(rc, str, 0, NULL);
+  return regex_match_result(r, str, rc_exec);
+}
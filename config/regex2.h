@@ -24,13 +24,27 @@
 #define MUTT_CONFIG_REGEX_H
 
 #include <regex.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "complexity.h"
 
 struct Buffer;
 struct ConfigSet;
 struct Regex;
+struct RegexPrefilter;
 
 void regex_init(struct ConfigSet *cs);
 struct Regex *regex_new(const char *str, int flags, struct Buffer *err);
 void regex_free(struct Regex **regex);
 
+bool                         regex_engine_set      (const char *name);
+const char *                 regex_engine_get      (void);
+const char *                 regex_engine_name     (const struct Regex *r);
+const struct RegexPrefilter *regex_prefilter       (const struct Regex *r);
+int                          regex_exec            (const struct Regex *r, const char *str, size_t nmatch, regmatch_t pmatch[]);
+bool                         regex_match           (const struct Regex *r, const char *str);
+bool                         regex_match_unfiltered(const struct Regex *r, const char *str);
+enum RegexRisk               regex_risk            (const struct Regex *r);
+size_t                       regex_budget          (const struct Regex *r);
+
 #endif /* MUTT_CONFIG_REGEX_H */
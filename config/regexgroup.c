@@ -0,0 +1,343 @@
+/**
+ * @file
+ * Match a string against several Regex config items at once
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_regexgroup Match a string against several Regexes at once
+ *
+ * A RegexGroup is a set of Regex config items, e.g. the patterns of several
+ * hooks, that are all tested against the same strings.
+ *
+ * Most patterns contain a literal that every match must contain, see
+ * @ref config_prefilter.  Matching the Regexes separately searches the string
+ * once for each literal.  The group searches for all of them in one pass:
+ * a table, indexed by byte, lists the members whose literal starts with it,
+ * and only those literals are compared.  Only the members whose literal was
+ * found are then matched, without repeating the search.
+ *
+ * Members without a literal, or that are anchored, or that have a '!' prefix,
+ * are matched individually, using their own prefilter.
+ *
+ * Case-insensitive comparisons are only trusted for ASCII, so a non-ASCII
+ * byte makes every case-insensitive member a candidate.
+ *
+ * The group observes the ConfigSet.  If a member, or any config item it
+ * inherits from, changes, the table is rebuilt the next time it's needed.
+ * A RegexGroup isn't thread-safe.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include "mutt/mutt.h"
+#include "regexgroup.h"
+#include "inheritance.h"
+#include "prefilter.h"
+#include "regex2.h"
+#include "set.h"
+#include "types.h"
+
+/**
+ * struct RegexGroupLiteral - A literal that a member's matches must contain
+ */
+struct RegexGroupLiteral
+{
+  const char *str; ///< Literal, owned by the member's prefilter
+  size_t len;      ///< Length of the literal
+  bool icase;      ///< Compare ignoring case, the literal is lower case
+};
+
+/**
+ * struct RegexGroup - A set of Regex config items, matched together
+ */
+struct RegexGroup
+{
+  const struct ConfigSet *cs;         ///< Config items
+  size_t num;                         ///< Number of members
+  char **names;                       ///< Names of the members
+  struct HashElem **hes;              ///< Members' config items
+  const struct Regex **regexes;       ///< Members' current values
+  struct RegexGroupLiteral *literals; ///< Members' required literals
+  RegexGroupMatches first[256];       ///< Members whose literal can start with each byte
+  RegexGroupMatches scanned;          ///< Members whose literal is searched for
+  RegexGroupMatches icase;            ///< Scanned members that ignore case
+  RegexGroupMatches always;           ///< Members that are always matched individually
+  bool dirty;                         ///< A member has changed, rebuild before matching
+};
+
+/**
+ * regex_group_clear - Forget the members' values
+ * @param group RegexGroup
+ */
+static void regex_group_clear(struct RegexGroup *group)
+{
+  memset(group->regexes, 0, group->num * sizeof(*group->regexes));
+  memset(group->hes, 0, group->num * sizeof(*group->hes));
+  memset(group->literals, 0, group->num * sizeof(*group->literals));
+  memset(group->first, 0, sizeof(group->first));
+  group->scanned = 0;
+  group->icase = 0;
+  group->always = 0;
+  group->dirty = true;
+}
+
+/**
+ * regex_group_rebuild - Rebuild the table of literals
+ * @param group RegexGroup
+ */
+static void regex_group_rebuild(struct RegexGroup *group)
+{
+  regex_group_clear(group);
+
+  for (size_t i = 0; i < group->num; i++)
+  {
+    group->hes[i] = cs_get_elem(group->cs, group->names[i]);
+    if (!group->hes[i])
+      continue;
+
+    const struct Regex *r = (const struct Regex *) cs_he_native_get(group->cs, group->hes[i], NULL);
+    group->regexes[i] = r;
+    if (!r)
+      continue;
+
+    const RegexGroupMatches bit = (1U << i);
+    const struct RegexPrefilter *pf = regex_prefilter(r);
+    if (!pf || (pf->required[0] == '\0') || pf->anchored || r->not)
+    {
+      group->always |= bit;
+      continue;
+    }
+
+    struct RegexGroupLiteral *lit = &group->literals[i];
+    lit->str = pf->required;
+    lit->len = strlen(pf->required);
+    lit->icase = pf->icase;
+
+    const unsigned char c = lit->str[0];
+    group->first[c] |= bit;
+    if (lit->icase)
+    {
+      group->first[toupper(c)] |= bit;
+      group->icase |= bit;
+    }
+    group->scanned |= bit;
+  }
+
+  group->dirty = false;
+}
+
+/**
+ * regex_group_scan - Find the members whose literals a string contains
+ * @param group RegexGroup
+ * @param str   String to search
+ * @retval num Members whose literal was found
+ */
+static RegexGroupMatches regex_group_scan(const struct RegexGroup *group, const char *str)
+{
+  RegexGroupMatches found = 0;
+  for (const unsigned char *s = (const unsigned char *) str; *s && (found != group->scanned); s++)
+  {
+    if (*s >= 0x80)
+      found |= group->icase;
+
+    RegexGroupMatches m = group->first[*s] & ~found;
+    for (size_t i = 0; m != 0; i++, m >>= 1)
+    {
+      if ((m & 1) == 0)
+        continue;
+
+      const struct RegexGroupLiteral *lit = &group->literals[i];
+      const char *rest = (const char *) s + 1;
+      if (lit->icase ? (strncasecmp(rest, lit->str + 1, lit->len - 1) == 0) :
+                       (strncmp(rest, lit->str + 1, lit->len - 1) == 0))
+      {
+        found |= (1U << i);
+      }
+    }
+  }
+
+  return found;
+}
+
+/**
+ * regex_group_depends - Does a member depend on a config item?
+ * @param he     Member's config item
+ * @param target Config item that has changed
+ * @retval true The member is the item, or inherits from it
+ *
+ * An inherited item may read its value from any of its ancestors.
+ */
+static bool regex_group_depends(struct HashElem *he, const struct HashElem *target)
+{
+  while (he)
+  {
+    if (he == target)
+      return true;
+    if (!(he->type & DT_INHERITED))
+      return false;
+    he = ((struct Inheritance *) he->data)->parent;
+  }
+
+  return false; /* LCOV_EXCL_LINE */
+}
+
+/**
+ * regex_group_observer - Listen for changes to the members - Implements ::observer_t
+ */
+static int regex_group_observer(struct NotifyCallback *nc)
+{
+  if (!nc || (nc->event_type != NT_CONFIG))
+    return -1;
+
+  struct RegexGroup *group = (struct RegexGroup *) nc->data;
+  if (group->dirty)
+    return 0;
+
+  struct EventConfig *ec = (struct EventConfig *) nc->event;
+
+  /* Inherited items may have been deleted */
+  if (nc->event_subtype == NT_CONFIG_DELETED)
+  {
+    regex_group_clear(group);
+    return 0;
+  }
+
+  if (!ec->he)
+    return 0;
+
+  for (size_t i = 0; i < group->num; i++)
+  {
+    /* A member that's been deleted may have been recreated */
+    struct HashElem *he = group->hes[i];
+    if ((he && regex_group_depends(he, ec->he)) ||
+        (!he && (mutt_str_strcmp(ec->he->key.strkey, group->names[i]) == 0)))
+    {
+      group->dirty = true;
+      break;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * cs_regex_group_new - Create a RegexGroup
+ * @param cs    Config items
+ * @param names Names of the Regex config items, NULL-terminated
+ * @retval ptr  New RegexGroup
+ * @retval NULL Error, too many names, or one isn't a Regex config item
+ *
+ * The config items may be inherited, e.g. "account:quote_regex".  If one is
+ * deleted, it doesn't match.  The result of cs_regex_group_match() has one bit
+ * for each name, in order.
+ */
+struct RegexGroup *cs_regex_group_new(const struct ConfigSet *cs, const char *names[])
+{
+  if (!cs || !names)
+    return NULL;
+
+  size_t num = 0;
+  for (; names[num]; num++)
+  {
+    struct HashElem *he = cs_get_elem(cs, names[num]);
+    if (!he || (DTYPE(cs_he_base(he)->type) != DT_REGEX))
+      return NULL;
+  }
+
+  if ((num == 0) || (num > REGEX_GROUP_MAX))
+    return NULL;
+
+  struct RegexGroup *group = mutt_mem_calloc(1, sizeof(*group));
+  group->cs = cs;
+  group->num = num;
+  group->names = mutt_mem_calloc(num, sizeof(char *));
+  group->hes = mutt_mem_calloc(num, sizeof(struct HashElem *));
+  group->regexes = mutt_mem_calloc(num, sizeof(struct Regex *));
+  group->literals = mutt_mem_calloc(num, sizeof(struct RegexGroupLiteral));
+  for (size_t i = 0; i < num; i++)
+    group->names[i] = mutt_str_strdup(names[i]);
+  group->dirty = true;
+
+  notify_observer_add(cs->notify, NT_CONFIG, 0, regex_group_observer, IP group);
+  return group;
+}
+
+/**
+ * cs_regex_group_free - Free a RegexGroup
+ * @param[out] ptr RegexGroup to free
+ */
+void cs_regex_group_free(struct RegexGroup **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct RegexGroup *group = *ptr;
+  notify_observer_remove(group->cs->notify, regex_group_observer, IP group);
+
+  for (size_t i = 0; i < group->num; i++)
+    FREE(&group->names[i]);
+  FREE(&group->names);
+  FREE(&group->hes);
+  FREE(&group->regexes);
+  FREE(&group->literals);
+  FREE(ptr);
+}
+
+/**
+ * cs_regex_group_match - Which members match a string?
+ * @param group RegexGroup
+ * @param str   String to match
+ * @retval num Members that matched, e.g. bit 0 for the first name
+ *
+ * Like regex_match(), a member with a '!' prefix matches strings that its
+ * pattern doesn't.
+ */
+RegexGroupMatches cs_regex_group_match(struct RegexGroup *group, const char *str)
+{
+  if (!group || !str)
+    return 0;
+
+  if (group->dirty)
+    regex_group_rebuild(group);
+
+  /* One pass finds the members whose literal is present */
+  RegexGroupMatches found = (group->scanned != 0) ? regex_group_scan(group, str) : 0;
+
+  RegexGroupMatches matches = 0;
+  RegexGroupMatches candidates = group->always | found;
+  for (size_t i = 0; candidates != 0; i++, candidates >>= 1)
+  {
+    if ((candidates & 1) == 0)
+      continue;
+
+    const RegexGroupMatches bit = (1U << i);
+    const bool match = (found & bit) ? regex_match_unfiltered(group->regexes[i], str) :
+                                       regex_match(group->regexes[i], str);
+    if (match)
+      matches |= bit;
+  }
+
+  return matches;
+}
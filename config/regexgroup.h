@@ -0,0 +1,38 @@
+/**
+ * @file
+ * Match a string against several Regex config items at once
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_REGEXGROUP_H
+#define MUTT_CONFIG_REGEXGROUP_H
+
+#include <stdint.h>
+
+struct ConfigSet;
+struct RegexGroup;
+
+typedef uint32_t RegexGroupMatches; ///< Members that matched, bit N is the Nth name passed to cs_regex_group_new()
+#define REGEX_GROUP_MAX 32          ///< Most members in a RegexGroup
+
+struct RegexGroup *cs_regex_group_new  (const struct ConfigSet *cs, const char *names[]);
+void               cs_regex_group_free (struct RegexGroup **ptr);
+RegexGroupMatches  cs_regex_group_match(struct RegexGroup *group, const char *str);
+
+#endif /* MUTT_CONFIG_REGEXGROUP_H */
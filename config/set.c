@@ -33,7 +33,12 @@
 #include <string.h>
 #include "mutt/mutt.h"
 #include "set.h"
+#include "arena.h"
+#include "enum.h"
 #include "inheritance.h"
+#include "intern.h"
+#include "lookup.h"
+#include "shared.h"
 #include "types.h"
 
 struct ConfigSetType RegisteredTypes[18] = {
@@ -41,20 +46,92 @@ struct ConfigSetType RegisteredTypes[18] = {
 };
 
 /**
- * get_base - Find the root Config Item
+ * cs_he_base - Find the root Config Item
  * @param he Config Item to examine
  * @retval ptr Root Config Item
  *
  * Given an inherited HashElem, find the HashElem representing the original
  * Config Item.
  */
-struct HashElem *get_base(struct HashElem *he)
+struct HashElem *cs_he_base(struct HashElem *he)
 {
   if (!(he->type & DT_INHERITED))
     return he;
 
   struct Inheritance *i = he->data;
-  return get_base(i->parent);
+  return i->base;
+}
+
+/**
+ * inherit_update - Update the cached values of an item's descendants
+ * @param he    Inherited config item that has been set, reset or removed
+ * @param value Config item that its descendants should read from
+ *
+ * Only the descendants that don't have a value of their own are affected
+ * (beyond their own cache).
+ */
+static void inherit_update(struct HashElem *he, struct HashElem *value)
+{
+  struct Inheritance *i = he->data;
+
+  for (struct HashElem *child = i->child; child;)
+  {
+    struct Inheritance *ic = child->data;
+    ic->value = value;
+    if (DTYPE(child->type) == 0)
+      inherit_update(child, value);
+    child = ic->sibling;
+  }
+}
+
+/**
+ * inherit_unlink - Detach an inherited config item from its relatives
+ * @param i    Inheritance being destroyed
+ * @param type Type of the config item, e.g. #DT_INHERITED
+ *
+ * The item's children are given to its parent, so that they can outlive it.
+ */
+static void inherit_unlink(struct Inheritance *i, int type)
+{
+  struct Inheritance *ip = NULL;
+  if (i->parent != i->base)
+  {
+    ip = i->parent->data;
+
+    if (i->prev)
+      ((struct Inheritance *) i->prev->data)->sibling = i->sibling;
+    else
+      ip->child = i->sibling;
+    if (i->sibling)
+      ((struct Inheritance *) i->sibling->data)->prev = i->prev;
+  }
+
+  struct HashElem *child = i->child;
+  while (child)
+  {
+    struct Inheritance *ic = child->data;
+    struct HashElem *next = ic->sibling;
+
+    ic->parent = i->parent;
+    if (DTYPE(type) != 0)
+    {
+      /* The children were reading this item's value */
+      ic->value = i->value;
+      if (DTYPE(child->type) == 0)
+        inherit_update(child, i->value);
+    }
+
+    ic->sibling = NULL;
+    ic->prev = NULL;
+    if (ip)
+    {
+      ic->sibling = ip->child;
+      if (ip->child)
+        ((struct Inheritance *) ip->child->data)->prev = child;
+      ip->child = child;
+    }
+    child = next;
+  }
 }
 
 /**
@@ -76,15 +153,16 @@ static void destroy(int type, void *obj, intptr_t data)
   {
     struct Inheritance *i = obj;
 
-    struct HashElem *he_base = get_base(i->parent);
+    inherit_unlink(i, type);
+
+    struct HashElem *he_base = i->base;
     struct ConfigDef *cdef = he_base->data;
 
     cst = cs_get_type_def(cs, he_base->type);
     if (cst && cst->destroy)
       cst->destroy(cs, (void **) &i->var, cdef);
 
-    FREE(&i->name);
-    FREE(&i);
+    arena_release(cs->arena, &i, sizeof(*i) + strlen(i->name) + 1);
   }
   else
   {
@@ -95,8 +173,7 @@ static void destroy(int type, void *obj, intptr_t data)
       cst->destroy(cs, cdef->var, cdef);
 
     /* If we allocated the initial value, clean it up */
-    if (cdef->type & DT_INITIAL_SET)
-      FREE(&cdef->initial);
+    cs_intern_initial_free(cs, cdef);
   }
 }
 
@@ -158,6 +235,10 @@ static struct HashElem *reg_one_var(const struct ConfigSet *cs,
   if (!he)
     return NULL; /* LCOV_EXCL_LINE */
 
+  /* Like the ConfigDef, an enum's Mapping is static, so it can be indexed */
+  if ((DTYPE(cdef->type) == DT_ENUM) && cdef->data)
+    lookup_register(((const struct EnumDef *) cdef->data)->lookup);
+
   if (cst && cst->reset)
     cst->reset(cs, cdef->var, cdef, err);
 
@@ -170,9 +251,25 @@ static struct HashElem *reg_one_var(const struct ConfigSet *cs,
  * @retval ptr New ConfigSet object
  */
 struct ConfigSet *cs_new(size_t size)
+{
+  return cs_new_flags(size, CS_NO_FLAGS);
+}
+
+/**
+ * cs_new_flags - Create a new Config Set, with options
+ * @param size  Number of expected config items
+ * @param flags Flags, e.g. #CS_ARENA
+ * @retval ptr New ConfigSet object
+ *
+ * #CS_FAST_EXIT may also be set later, just before calling cs_free().
+ */
+struct ConfigSet *cs_new_flags(size_t size, ConfigSetFlags flags)
 {
   struct ConfigSet *cs = mutt_mem_malloc(sizeof(*cs));
   cs_init(cs, size);
+  cs->flags = flags;
+  if (flags & CS_ARENA)
+    cs->arena = arena_new(0);
   return cs;
 }
 
@@ -190,6 +287,8 @@ void cs_init(struct ConfigSet *cs, size_t size)
   cs->hash = mutt_hash_new(size, MUTT_HASH_NO_FLAGS);
   mutt_hash_set_destructor(cs->hash, destroy, (intptr_t) cs);
   cs->notify = notify_new(cs, NT_CONFIG);
+  cs_shared_init(cs);
+  cs_intern_init(cs);
 }
 
 /**
@@ -201,8 +300,20 @@ void cs_free(struct ConfigSet **cs)
   if (!cs || !*cs)
     return;
 
+  if ((*cs)->flags & CS_FAST_EXIT)
+  {
+    /* Drop the tables without destroying the items.  Anything outside the
+     * Arena, e.g. compiled Regexes, is left for the OS to reclaim. */
+    mutt_hash_set_destructor((*cs)->hash, NULL, 0);
+    mutt_hash_set_destructor((*cs)->shared_addrs, NULL, 0);
+    mutt_hash_set_destructor((*cs)->strings, NULL, 0);
+  }
+
   mutt_hash_free(&(*cs)->hash);
+  cs_shared_cleanup(*cs);
+  cs_intern_cleanup(*cs);
   notify_free(&(*cs)->notify);
+  arena_free(&(*cs)->arena);
   FREE(cs);
 }
 
@@ -320,15 +431,37 @@ struct HashElem *cs_inherit_variable(const struct ConfigSet *cs,
   if (!cs || !parent)
     return NULL;
 
-  struct Inheritance *i = mutt_mem_calloc(1, sizeof(*i));
+  size_t len = mutt_str_strlen(name);
+  struct Inheritance *i = arena_calloc(cs->arena, sizeof(*i) + len + 1);
   i->parent = parent;
-  i->name = mutt_str_strdup(name);
+  memcpy(i->name, name, len);
+
+  struct Inheritance *ip = NULL;
+  if (parent->type & DT_INHERITED)
+  {
+    ip = parent->data;
+    i->base = ip->base;
+    i->value = (DTYPE(parent->type) == 0) ? ip->value : parent;
+  }
+  else
+  {
+    i->base = parent;
+    i->value = parent;
+  }
 
   struct HashElem *he = mutt_hash_typed_insert(cs->hash, i->name, DT_INHERITED, i);
   if (!he)
   {
-    FREE(&i->name);
-    FREE(&i);
+    arena_release(cs->arena, &i, sizeof(*i) + len + 1);
+    return NULL;
+  }
+
+  if (ip)
+  {
+    i->sibling = ip->child;
+    if (ip->child)
+      ((struct Inheritance *) ip->child->data)->prev = he;
+    ip->child = he;
   }
 
   return he;
@@ -347,6 +480,47 @@ void cs_uninherit_variable(const struct ConfigSet *cs, const char *name)
   mutt_hash_delete(cs->hash, name, NULL);
 }
 
+/**
+ * cs_he_delete_many - Delete a batch of inherited config items
+ * @param cs   Config items
+ * @param hes  Array of inherited config items
+ * @param num  Number of config items
+ * @param name Name of the batch, e.g. the Account, for the notification
+ * @retval num Number of config items deleted
+ *
+ * The HashElems are unlinked and destroyed directly, without building or
+ * looking up their names.  NULL entries and non-inherited items are skipped.
+ * If anything was deleted, the observers are sent one #NT_CONFIG_DELETED.
+ */
+size_t cs_he_delete_many(const struct ConfigSet *cs, struct HashElem *hes[],
+                         size_t num, const char *name)
+{
+  if (!cs || !hes)
+    return 0;
+
+  size_t count = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    struct HashElem *he = hes[i];
+    if (!he || !(he->type & DT_INHERITED))
+      continue;
+
+    /* Matching the data means the key, which belongs to the Inheritance,
+     * won't be compared once it's been freed */
+    mutt_hash_delete(cs->hash, he->key.strkey, he->data);
+    hes[i] = NULL;
+    count++;
+  }
+
+  if ((count > 0) && name)
+  {
+    struct EventConfig ec = { cs, NULL, name };
+    notify_send(cs->notify, NT_CONFIG, NT_CONFIG_DELETED, IP & ec);
+  }
+
+  return count;
+}
+
 /**
  * cs_notify_observers - Notify all observers of an event
  * @param cs   Config items
@@ -360,7 +534,7 @@ void cs_notify_observers(const struct ConfigSet *cs, struct HashElem *he,
   if (!cs || !he || !name)
     return;
 
-  struct EventConfig ec = { cs, he, name };
+  struct EventConfig ec = { cs, he, name, NULL };
   notify_send(cs->notify, NT_CONFIG, ev, IP & ec);
 }
 
@@ -389,7 +563,7 @@ int cs_he_reset(const struct ConfigSet *cs, struct HashElem *he, struct Buffer *
   if (he->type & DT_INHERITED)
   {
     struct Inheritance *i = he->data;
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     cst = cs_get_type_def(cs, he_base->type);
 
@@ -397,6 +571,7 @@ int cs_he_reset(const struct ConfigSet *cs, struct HashElem *he, struct Buffer *
       cst->destroy(cs, (void **) &i->var, cdef);
 
     he->type = DT_INHERITED;
+    inherit_update(he, i->value);
   }
   else
   {
@@ -453,7 +628,7 @@ int cs_he_initial_set(const struct ConfigSet *cs, struct HashElem *he,
 
   if (he->type & DT_INHERITED)
   {
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     mutt_debug(LL_DEBUG1, "Variable '%s' is inherited type\n", cdef->name);
     return CSR_ERR_CODE;
@@ -519,7 +694,7 @@ int cs_he_initial_get(const struct ConfigSet *cs, struct HashElem *he, struct Bu
 
   if (he->type & DT_INHERITED)
   {
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     cst = cs_get_type_def(cs, he_base->type);
   }
@@ -585,7 +760,7 @@ int cs_he_string_set(const struct ConfigSet *cs, struct HashElem *he,
   if (he->type & DT_INHERITED)
   {
     struct Inheritance *i = he->data;
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     cst = cs_get_type_def(cs, he_base->type);
     var = &i->var;
@@ -607,8 +782,11 @@ int cs_he_string_set(const struct ConfigSet *cs, struct HashElem *he,
   if (CSR_RESULT(rc) != CSR_SUCCESS)
     return rc;
 
-  if (he->type & DT_INHERITED)
+  if ((he->type & DT_INHERITED) && (DTYPE(he->type) == 0))
+  {
     he->type = cdef->type | DT_INHERITED;
+    inherit_update(he, he);
+  }
 
   if (!(rc & CSR_SUC_NO_CHANGE))
     cs_notify_observers(cs, he, he->key.strkey, NT_CONFIG_SET);
@@ -659,12 +837,12 @@ int cs_he_string_get(const struct ConfigSet *cs, struct HashElem *he, struct Buf
   {
     struct Inheritance *i = he->data;
 
-    // inherited, value not set
+    // inherited, value not set: read the nearest ancestor that has one
     if (DTYPE(he->type) == 0)
-      return cs_he_string_get(cs, i->parent, result);
+      return cs_he_string_get(cs, i->value, result);
 
     // inherited, value set
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     cst = cs_get_type_def(cs, he_base->type);
     var = &i->var;
@@ -719,6 +897,25 @@ int cs_str_string_get(const struct ConfigSet *cs, const char *name, struct Buffe
  */
 int cs_he_native_set(const struct ConfigSet *cs, struct HashElem *he,
                      intptr_t value, struct Buffer *err)
+{
+  return cs_he_native_delta(cs, he, value, NT_CONFIG_SET, NULL, err);
+}
+
+/**
+ * cs_he_native_delta - Natively set a config item, describing the change
+ * @param cs      Config items
+ * @param he      HashElem representing config item
+ * @param value   Native pointer/value to set
+ * @param ev      Event to send, e.g. #NT_CONFIG_SLIST_ADD
+ * @param element Part of the value that changed, passed to the observers
+ * @param err     Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ *
+ * This is cs_he_native_set(), but the observers are told what changed, so
+ * they can update themselves incrementally.
+ */
+int cs_he_native_delta(const struct ConfigSet *cs, struct HashElem *he, intptr_t value,
+                       enum NotifyConfig ev, const char *element, struct Buffer *err)
 {
   if (!cs || !he)
     return CSR_ERR_CODE;
@@ -730,7 +927,7 @@ int cs_he_native_set(const struct ConfigSet *cs, struct HashElem *he,
   if (he->type & DT_INHERITED)
   {
     struct Inheritance *i = he->data;
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     cst = cs_get_type_def(cs, he_base->type);
     var = &i->var;
@@ -752,11 +949,17 @@ int cs_he_native_set(const struct ConfigSet *cs, struct HashElem *he,
   if (CSR_RESULT(rc) != CSR_SUCCESS)
     return rc;
 
-  if (he->type & DT_INHERITED)
+  if ((he->type & DT_INHERITED) && (DTYPE(he->type) == 0))
+  {
     he->type = cdef->type | DT_INHERITED;
+    inherit_update(he, he);
+  }
 
   if (!(rc & CSR_SUC_NO_CHANGE))
-    cs_notify_observers(cs, he, cdef->name, NT_CONFIG_SET);
+  {
+    struct EventConfig ec = { cs, he, cdef->name, element };
+    notify_send(cs->notify, NT_CONFIG, ev, IP & ec);
+  }
   return rc;
 }
 
@@ -788,7 +991,7 @@ int cs_str_native_set(const struct ConfigSet *cs, const char *name,
   if (he->type & DT_INHERITED)
   {
     struct Inheritance *i = he->data;
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     cst = cs_get_type_def(cs, he_base->type);
     var = &i->var;
@@ -807,8 +1010,11 @@ int cs_str_native_set(const struct ConfigSet *cs, const char *name,
   if (CSR_RESULT(rc) != CSR_SUCCESS)
     return rc;
 
-  if (he->type & DT_INHERITED)
+  if ((he->type & DT_INHERITED) && (DTYPE(he->type) == 0))
+  {
     he->type = cdef->type | DT_INHERITED;
+    inherit_update(he, he);
+  }
 
   if (!(rc & CSR_SUC_NO_CHANGE))
     cs_notify_observers(cs, he, cdef->name, NT_CONFIG_SET);
@@ -836,12 +1042,12 @@ intptr_t cs_he_native_get(const struct ConfigSet *cs, struct HashElem *he, struc
   {
     struct Inheritance *i = he->data;
 
-    // inherited, value not set
+    // inherited, value not set: read the nearest ancestor that has one
     if (DTYPE(he->type) == 0)
-      return cs_he_native_get(cs, i->parent, err);
+      return cs_he_native_get(cs, i->value, err);
 
     // inherited, value set
-    struct HashElem *he_base = get_base(he);
+    struct HashElem *he_base = cs_he_base(he);
     cdef = he_base->data;
     cst = cs_get_type_def(cs, he_base->type);
     var = &i->var;
@@ -27,19 +27,25 @@
 #include <stdint.h>
 #include <stdio.h>
 
+struct Arena;
 struct Buffer;
 struct ConfigSet;
 struct HashElem;
 struct ConfigDef;
+struct InternCells;
+struct SharedCache;
 
 /**
  * enum NotifyConfig - Config notification types
  */
 enum NotifyConfig
 {
-  NT_CONFIG_SET = 1,     ///< Config item has been set
-  NT_CONFIG_RESET,       ///< Config item has been reset to initial, or parent, value
-  NT_CONFIG_INITIAL_SET, ///< Config item's initial value has been set
+  NT_CONFIG_SET = 1,      ///< Config item has been set
+  NT_CONFIG_RESET,        ///< Config item has been reset to initial, or parent, value
+  NT_CONFIG_INITIAL_SET,  ///< Config item's initial value has been set
+  NT_CONFIG_DELETED,      ///< A batch of inherited config items has been deleted, see cs_he_delete_many()
+  NT_CONFIG_SLIST_ADD,    ///< An item has been added to a list, see cs_slist_add()
+  NT_CONFIG_SLIST_REMOVE, ///< An item has been removed from a list, see cs_slist_remove()
 };
 
 /* Config Set Results */
@@ -143,6 +149,11 @@ typedef void    (*cst_destroy)   (const struct ConfigSet *cs, void *var, const s
 
 #define IP (intptr_t)
 
+typedef uint8_t ConfigSetFlags;   ///< Flags for cs_new_flags(), e.g. #CS_ARENA
+#define CS_NO_FLAGS        0      ///< No flags are set
+#define CS_ARENA     (1 << 0)     ///< Allocate metadata and immutable values from an Arena
+#define CS_FAST_EXIT (1 << 1)     ///< cs_free() doesn't destroy the config items
+
 #define CS_REG_DISABLED (1 << 0)
 
 /**
@@ -186,34 +197,51 @@ struct ConfigSetType
  */
 struct ConfigSet
 {
-  struct Hash *hash;              ///< HashTable storing the config items
-  struct ConfigSetType types[18]; ///< All the defined config types
-  struct Notify *notify;          ///< Notifications system
+  struct Hash *hash;                ///< HashTable storing the config items
+  struct ConfigSetType types[18];   ///< All the defined config types
+  struct Notify *notify;            ///< Notifications system
+  struct Hash *shared_keys;         ///< Shared config values, by key, see cs_shared_add()
+  struct Hash *shared_addrs;        ///< Shared config values, by address
+  struct SharedCache *shared_cache; ///< Released shared values, kept for reuse
+  struct Hash *strings;             ///< Interned strings, see cs_intern()
+  struct InternCells *cells;        ///< Storage for short interned strings
+  ConfigSetFlags flags;             ///< Flags, e.g. #CS_ARENA
+  struct Arena *arena;              ///< Arena for metadata and immutable values, see #CS_ARENA
 };
 
 /**
  * struct EventConfig - A config-change event
  *
  * Events such as #NT_CONFIG_SET
+ *
+ * For #NT_CONFIG_DELETED, he is NULL and name is the name of the batch, e.g.
+ * the Account.
+ *
+ * For #NT_CONFIG_SLIST_ADD and #NT_CONFIG_SLIST_REMOVE, element is the list
+ * item that was added or removed.  It's NULL for an empty item.
  */
 struct EventConfig
 {
   const struct ConfigSet *cs; ///< Config set
   struct HashElem *he;        ///< Config item that changed
   const char *name;           ///< Name of config item that changed
+  const char *element;        ///< Part of the value that changed
 };
 
 struct ConfigSet *cs_new(size_t size);
+struct ConfigSet *cs_new_flags(size_t size, ConfigSetFlags flags);
 void              cs_init(struct ConfigSet *cs, size_t size);
 void              cs_free(struct ConfigSet **cs);
 
 struct HashElem *           cs_get_elem(const struct ConfigSet *cs, const char *name);
 const struct ConfigSetType *cs_get_type_def(const struct ConfigSet *cs, unsigned int type);
+struct HashElem *           cs_he_base(struct HashElem *he);
 
 bool             cs_register_type(struct ConfigSet *cs, unsigned int type, const struct ConfigSetType *cst);
 bool             cs_register_variables(const struct ConfigSet *cs, struct ConfigDef vars[], int flags);
 struct HashElem *cs_inherit_variable(const struct ConfigSet *cs, struct HashElem *parent, const char *name);
 void             cs_uninherit_variable(const struct ConfigSet *cs, const char *name);
+size_t           cs_he_delete_many(const struct ConfigSet *cs, struct HashElem *hes[], size_t num, const char *name);
 
 void cs_notify_observers(const struct ConfigSet *cs, struct HashElem *he, const char *name, enum NotifyConfig ev);
 
@@ -221,6 +249,7 @@ int      cs_he_initial_get (const struct ConfigSet *cs, struct HashElem *he,
 int      cs_he_initial_set (const struct ConfigSet *cs, struct HashElem *he, const char *value, struct Buffer *err);
 intptr_t cs_he_native_get  (const struct ConfigSet *cs, struct HashElem *he,                    struct Buffer *err);
 int      cs_he_native_set  (const struct ConfigSet *cs, struct HashElem *he, intptr_t value,    struct Buffer *err);
+int      cs_he_native_delta(const struct ConfigSet *cs, struct HashElem *he, intptr_t value, enum NotifyConfig ev, const char *element, struct Buffer *err);
 int      cs_he_reset       (const struct ConfigSet *cs, struct HashElem *he,                    struct Buffer *err);
 int      cs_he_string_get  (const struct ConfigSet *cs, struct HashElem *he,                    struct Buffer *result);
 int      cs_he_string_set  (const struct ConfigSet *cs, struct HashElem *he, const char *value, struct Buffer *err);
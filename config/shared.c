@@ -0,0 +1,436 @@
+/**
+ * @file
+ * Shared, reference-counted config values
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_shared Shared, reference-counted config values
+ *
+ * The heap-backed config types (Address, MbTable, Regex, Slist) store their
+ * values as shared, immutable objects.
+ *
+ * Each object is registered with the ConfigSet under a key that describes its
+ * value, e.g. the flags and pattern of a Regex.  When a config item is set to
+ * a value that's already in use, it takes a reference to the existing object,
+ * rather than parsing (or compiling) a new one.  Destroying a value just drops
+ * a reference; the object is freed when the last one goes.
+ *
+ * Because the objects are shared, they must never be changed in place.  To
+ * change a value, build a new object and set that.
+ *
+ * When the last reference is dropped, the object isn't freed immediately.
+ * The most recently released objects are kept in an LRU cache, so setting a
+ * value back again, e.g. a folder-hook resetting reply_regex on every folder
+ * change, finds the object rather than compiling it again.  See
+ * cs_shared_cache_limit() and cs_shared_stats().
+ *
+ * The registry is protected by a lock, so it may be used by several threads
+ * that are only validating config, see cs_validate_files().
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "shared.h"
+#include "set.h"
+
+/**
+ * struct SharedValue - A shared config value
+ */
+struct SharedValue
+{
+  char *key;                ///< Description of the value
+  void *obj;                ///< Shared object
+  int refs;                 ///< Number of references to the object
+  shared_free_t free_fn;    ///< Function to free the object
+  struct SharedValue *prev; ///< More recently released object, while cached
+  struct SharedValue *next; ///< Less recently released object, while cached
+};
+
+/**
+ * struct SharedCache - Released objects, kept for reuse
+ */
+struct SharedCache
+{
+  struct SharedValue *head; ///< Most recently released object
+  struct SharedValue *tail; ///< Least recently released object, evicted first
+  size_t num;               ///< Number of cached objects
+  size_t max;               ///< Most objects to keep
+  struct SharedStats stats; ///< Hit and miss counters
+};
+
+static pthread_mutex_t SharedLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * shared_free - Free a SharedValue - Implements ::hashelem_free_t
+ * @param type Object type (unused)
+ * @param obj  SharedValue to free
+ * @param data Unused
+ *
+ * Only called for objects that are still referenced when the ConfigSet is
+ * freed.
+ */
+static void shared_free(int type, void *obj, intptr_t data)
+{
+  struct SharedValue *sv = obj;
+  if (!sv)
+    return; /* LCOV_EXCL_LINE */
+
+  sv->free_fn(&sv->obj);
+  FREE(&sv->key);
+  FREE(&sv);
+}
+
+/**
+ * addr_key - Turn an object's address into a hash key
+ * @param obj Object
+ * @retval num Hash key
+ *
+ * The key is folded to fit, so two objects may have the same key.
+ */
+static unsigned int addr_key(const void *obj)
+{
+  const uint64_t addr = (uintptr_t) obj;
+  return (unsigned int) ((addr >> 4) ^ (addr >> 36));
+}
+
+/**
+ * find_addr - Find the SharedValue for an object
+ * @param cs  Config items
+ * @param obj Object to look for
+ * @retval ptr  SharedValue
+ * @retval NULL The object isn't shared
+ *
+ * The lock must be held.
+ */
+static struct SharedValue *find_addr(const struct ConfigSet *cs, void *obj)
+{
+  struct SharedValue *sv = mutt_hash_int_find(cs->shared_addrs, addr_key(obj));
+  if (!sv || (sv->obj == obj))
+    return sv;
+
+  /* Another object has the same key.  This is very rare, so just search. */
+  struct HashWalkState state = { 0 };
+  struct HashElem *he = NULL;
+  while ((he = mutt_hash_walk(cs->shared_addrs, &state)))
+  {
+    sv = he->data;
+    if (sv->obj == obj)
+      return sv;
+  }
+
+  return NULL;
+}
+
+/**
+ * shared_delete - Remove a SharedValue from the registry and free it
+ * @param cs Config items
+ * @param sv SharedValue to free
+ *
+ * The lock must be held.
+ */
+static void shared_delete(const struct ConfigSet *cs, struct SharedValue *sv)
+{
+  /* Deleting from shared_addrs frees sv, so do it last */
+  mutt_hash_delete(cs->shared_keys, sv->key, sv);
+  mutt_hash_int_delete(cs->shared_addrs, addr_key(sv->obj), sv);
+}
+
+/**
+ * cache_unlink - Take a released object out of the cache
+ * @param cache Cache
+ * @param sv    SharedValue, which is about to be referenced again
+ *
+ * The lock must be held.
+ */
+static void cache_unlink(struct SharedCache *cache, struct SharedValue *sv)
+{
+  if (sv->prev)
+    sv->prev->next = sv->next;
+  else
+    cache->head = sv->next;
+
+  if (sv->next)
+    sv->next->prev = sv->prev;
+  else
+    cache->tail = sv->prev;
+
+  sv->prev = NULL;
+  sv->next = NULL;
+  cache->num--;
+  cache->stats.revived++;
+}
+
+/**
+ * cache_evict - Free the least recently released objects
+ * @param cs  Config items
+ * @param max Number of objects to keep
+ *
+ * The lock must be held.
+ */
+static void cache_evict(const struct ConfigSet *cs, size_t max)
+{
+  struct SharedCache *cache = cs->shared_cache;
+  while (cache->num > max)
+  {
+    struct SharedValue *sv = cache->tail;
+    cache->tail = sv->prev;
+    if (cache->tail)
+      cache->tail->next = NULL;
+    else
+      cache->head = NULL;
+    cache->num--;
+    cache->stats.evicted++;
+    shared_delete(cs, sv);
+  }
+}
+
+/**
+ * cs_shared_init - Create the shared value registry
+ * @param cs Config items
+ */
+void cs_shared_init(struct ConfigSet *cs)
+{
+  if (!cs)
+    return;
+
+  cs->shared_keys = mutt_hash_new(64, MUTT_HASH_NO_FLAGS);
+  cs->shared_addrs = mutt_hash_int_new(64, MUTT_HASH_ALLOW_DUPS);
+  mutt_hash_set_destructor(cs->shared_addrs, shared_free, 0);
+  cs->shared_cache = mutt_mem_calloc(1, sizeof(struct SharedCache));
+  cs->shared_cache->max = SHARED_CACHE_MAX;
+}
+
+/**
+ * cs_shared_cleanup - Free the shared value registry
+ * @param cs Config items
+ *
+ * Any objects that are still referenced, or cached, are freed.
+ */
+void cs_shared_cleanup(struct ConfigSet *cs)
+{
+  if (!cs)
+    return;
+
+  mutt_hash_free(&cs->shared_keys);
+  mutt_hash_free(&cs->shared_addrs);
+  FREE(&cs->shared_cache);
+}
+
+/**
+ * cs_shared_find - Find a shared object by its key
+ * @param cs  Config items
+ * @param key Description of the value
+ * @retval ptr  Object, with a new reference
+ * @retval NULL No such object
+ *
+ * A released object that's still in the cache is found, too.
+ */
+void *cs_shared_find(const struct ConfigSet *cs, const char *key)
+{
+  if (!cs || !key || !cs->shared_keys)
+    return NULL;
+
+  pthread_mutex_lock(&SharedLock);
+  void *obj = NULL;
+  struct SharedValue *sv = mutt_hash_find(cs->shared_keys, key);
+  if (sv)
+  {
+    if (sv->refs == 0)
+      cache_unlink(cs->shared_cache, sv);
+    sv->refs++;
+    obj = sv->obj;
+    cs->shared_cache->stats.hits++;
+  }
+  else
+  {
+    cs->shared_cache->stats.misses++;
+  }
+  pthread_mutex_unlock(&SharedLock);
+
+  return obj;
+}
+
+/**
+ * cs_shared_add - Share an object
+ * @param cs      Config items
+ * @param key     Description of the value
+ * @param obj     Object to share
+ * @param free_fn Function to free the object
+ * @retval ptr Shared object, with a new reference
+ *
+ * The registry takes ownership of obj.  If another object with the same key has
+ * been added in the meantime, obj is freed and the other object is returned.
+ */
+void *cs_shared_add(const struct ConfigSet *cs, const char *key, void *obj,
+                    shared_free_t free_fn)
+{
+  if (!cs || !key || !obj || !free_fn || !cs->shared_keys)
+    return obj;
+
+  pthread_mutex_lock(&SharedLock);
+  struct SharedValue *sv = mutt_hash_find(cs->shared_keys, key);
+  if (sv)
+  {
+    if (sv->refs == 0)
+      cache_unlink(cs->shared_cache, sv); /* LCOV_EXCL_LINE */
+    sv->refs++;
+    pthread_mutex_unlock(&SharedLock);
+    free_fn(&obj);
+    return sv->obj;
+  }
+
+  sv = mutt_mem_calloc(1, sizeof(*sv));
+  sv->key = mutt_str_strdup(key);
+  sv->obj = obj;
+  sv->refs = 1;
+  sv->free_fn = free_fn;
+  mutt_hash_insert(cs->shared_keys, sv->key, sv);
+  mutt_hash_int_insert(cs->shared_addrs, addr_key(obj), sv);
+  pthread_mutex_unlock(&SharedLock);
+
+  return obj;
+}
+
+/**
+ * cs_shared_ref - Take another reference to a shared object
+ * @param cs  Config items
+ * @param obj Object
+ * @retval true  Success
+ * @retval false The object isn't shared
+ */
+bool cs_shared_ref(const struct ConfigSet *cs, void *obj)
+{
+  if (!cs || !obj || !cs->shared_addrs)
+    return false;
+
+  pthread_mutex_lock(&SharedLock);
+  struct SharedValue *sv = find_addr(cs, obj);
+  if (sv)
+  {
+    if (sv->refs == 0)
+      cache_unlink(cs->shared_cache, sv);
+    sv->refs++;
+  }
+  pthread_mutex_unlock(&SharedLock);
+
+  return sv;
+}
+
+/**
+ * cs_shared_release - Drop a reference to a shared object
+ * @param[in]  cs  Config items
+ * @param[out] obj Object to release
+ * @retval true  Success, obj has been set to NULL
+ * @retval false The object isn't shared, the caller must free it
+ *
+ * When the last reference is dropped, the object is cached.  If the cache is
+ * full, the least recently released object is freed.
+ */
+bool cs_shared_release(const struct ConfigSet *cs, void **obj)
+{
+  if (!cs || !obj || !*obj || !cs->shared_addrs)
+    return false;
+
+  pthread_mutex_lock(&SharedLock);
+  struct SharedValue *sv = find_addr(cs, *obj);
+  if (!sv)
+  {
+    pthread_mutex_unlock(&SharedLock);
+    return false;
+  }
+
+  sv->refs--;
+  if (sv->refs == 0)
+  {
+    struct SharedCache *cache = cs->shared_cache;
+    sv->next = cache->head;
+    if (cache->head)
+      cache->head->prev = sv;
+    else
+      cache->tail = sv;
+    cache->head = sv;
+    cache->num++;
+    cache_evict(cs, cache->max);
+  }
+  pthread_mutex_unlock(&SharedLock);
+
+  *obj = NULL;
+  return true;
+}
+
+/**
+ * cs_shared_count - How many references are there to a shared object?
+ * @param cs  Config items
+ * @param obj Object
+ * @retval num Number of references, 0 if the object isn't shared
+ */
+int cs_shared_count(const struct ConfigSet *cs, void *obj)
+{
+  if (!cs || !obj || !cs->shared_addrs)
+    return 0;
+
+  pthread_mutex_lock(&SharedLock);
+  struct SharedValue *sv = find_addr(cs, obj);
+  int refs = sv ? sv->refs : 0;
+  pthread_mutex_unlock(&SharedLock);
+
+  return refs;
+}
+
+/**
+ * cs_shared_cache_limit - Set the number of released objects to keep
+ * @param cs  Config items
+ * @param max Most objects to keep, 0 to free objects as soon as they're released
+ */
+void cs_shared_cache_limit(const struct ConfigSet *cs, size_t max)
+{
+  if (!cs || !cs->shared_cache)
+    return;
+
+  pthread_mutex_lock(&SharedLock);
+  cs->shared_cache->max = max;
+  cache_evict(cs, max);
+  pthread_mutex_unlock(&SharedLock);
+}
+
+/**
+ * cs_shared_stats - Get the registry's counters
+ * @param[in]  cs    Config items
+ * @param[out] stats Counters
+ */
+void cs_shared_stats(const struct ConfigSet *cs, struct SharedStats *stats)
+{
+  if (!stats)
+    return;
+
+  memset(stats, 0, sizeof(*stats));
+  if (!cs || !cs->shared_cache)
+    return;
+
+  pthread_mutex_lock(&SharedLock);
+  *stats = cs->shared_cache->stats;
+  stats->cached = cs->shared_cache->num;
+  pthread_mutex_unlock(&SharedLock);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file
+ * Shared, reference-counted config values
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_SHARED_H
+#define MUTT_CONFIG_SHARED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct ConfigSet;
+
+#define SHARED_CACHE_MAX 32 ///< Default number of released objects to keep, see cs_shared_cache_limit()
+
+/**
+ * struct SharedStats - Counters for the shared value registry
+ */
+struct SharedStats
+{
+  size_t hits;    ///< Lookups that found an object, live or cached
+  size_t misses;  ///< Lookups that found nothing, so the value was parsed
+  size_t revived; ///< Released objects that were taken from the cache
+  size_t evicted; ///< Released objects that were freed to make room
+  size_t cached;  ///< Released objects in the cache now
+};
+
+/**
+ * typedef shared_free_t - Free a shared config value
+ * @param obj Object to free
+ */
+typedef void (*shared_free_t)(void **obj);
+
+void  cs_shared_init   (struct ConfigSet *cs);
+void  cs_shared_cleanup(struct ConfigSet *cs);
+
+void *cs_shared_find   (const struct ConfigSet *cs, const char *key);
+void *cs_shared_add    (const struct ConfigSet *cs, const char *key, void *obj, shared_free_t free_fn);
+bool  cs_shared_ref    (const struct ConfigSet *cs, void *obj);
+bool  cs_shared_release(const struct ConfigSet *cs, void **obj);
+int   cs_shared_count  (const struct ConfigSet *cs, void *obj);
+
+void  cs_shared_cache_limit(const struct ConfigSet *cs, size_t max);
+void  cs_shared_stats      (const struct ConfigSet *cs, struct SharedStats *stats);
+
+#endif /* MUTT_CONFIG_SHARED_H */
@@ -24,17 +24,238 @@
  * @page config_slist Type: List of strings
  *
  * Type representing a list of strings.
+ *
+ * The value of an Slist config item is packed into a single allocation: the
+ * Slist, an array of its ListNodes and, back to back, its strings.  Code that
+ * walks the list sees an ordinary STAILQ, but the list can also be indexed in
+ * O(1), see cs_slist_get().  For long lists, a hash of the strings is built,
+ * on demand, to speed up cs_slist_is_member().
+ *
+ * Parsing and rendering use the library's rules, e.g. #SLIST_SEP_COLON.
+ *
+ * Single items can be added to, or removed from, a list without rendering and
+ * reparsing it, see cs_slist_add().  Values may be shared, so the list is
+ * copied (with one allocation) and the observers are told which item changed.
  */
 
 #include "config.h"
 #include <stddef.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include "mutt/mutt.h"
+#include "slist.h"
+#include "intern.h"
 #include "set.h"
+#include "shared.h"
 #include "types.h"
 
+/* Lists with this many items get a hash for cs_slist_is_member() */
+#define SLIST_HASH_MIN 16
+
+/**
+ * struct SlistPacked - An Slist in a single allocation
+ */
+struct SlistPacked
+{
+  struct Slist list;       ///< The list (must be first)
+  struct Hash *members;    ///< Set of the strings, built on demand
+  struct ListNode nodes[]; ///< The list's nodes, followed by their strings
+};
+
+static pthread_mutex_t SlistLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * slist_pack_node - Copy a string into a packed Slist
+ * @param sp   Packed Slist
+ * @param node Next free node
+ * @param str  String to copy, may be NULL
+ * @param buf  Next free byte of string storage
+ * @retval ptr Next free byte of string storage
+ */
+static char *slist_pack_node(struct SlistPacked *sp, struct ListNode *node,
+                             const char *str, char *buf)
+{
+  if (str)
+  {
+    size_t len = strlen(str) + 1;
+    memcpy(buf, str, len);
+    node->data = buf;
+    buf += len;
+  }
+
+  STAILQ_INSERT_TAIL(&sp->list.head, node, entries);
+  return buf;
+}
+
+/**
+ * slist_pack_edit - Copy an Slist into a single allocation, changing one item
+ * @param list   Slist to copy, may be NULL
+ * @param flags  Flags for a new list, e.g. #SLIST_SEP_COLON
+ * @param skip   Index of an item to leave out, or SIZE_MAX
+ * @param add    Item to append, if append is true
+ * @param append If true, append add to the list
+ * @retval ptr Packed copy of the list
+ */
+static struct Slist *slist_pack_edit(const struct Slist *list, int flags,
+                                     size_t skip, const char *add, bool append)
+{
+  size_t count = 0;
+  size_t len = 0;
+  struct ListNode *np = NULL;
+  if (list)
+  {
+    flags = list->flags;
+    STAILQ_FOREACH(np, &list->head, entries)
+    {
+      count++;
+      if (np->data)
+        len += strlen(np->data) + 1;
+    }
+  }
+
+  if (append)
+  {
+    count++;
+    if (add)
+      len += strlen(add) + 1;
+  }
+
+  struct SlistPacked *sp =
+      mutt_mem_calloc(1, sizeof(*sp) + (count * sizeof(struct ListNode)) + len);
+  sp->list.flags = flags;
+  STAILQ_INIT(&sp->list.head);
+
+  char *buf = (char *) &sp->nodes[count];
+  size_t i = 0;
+  if (list)
+  {
+    size_t index = 0;
+    STAILQ_FOREACH(np, &list->head, entries)
+    {
+      if (index++ != skip)
+        buf = slist_pack_node(sp, &sp->nodes[i++], np->data, buf);
+    }
+  }
+
+  if (append)
+    buf = slist_pack_node(sp, &sp->nodes[i++], add, buf);
+
+  sp->list.count = i;
+  return &sp->list;
+}
+
+/**
+ * slist_pack - Copy an Slist into a single allocation
+ * @param list Slist to copy
+ * @retval ptr  Packed copy of the list
+ * @retval NULL list was NULL
+ */
+static struct Slist *slist_pack(const struct Slist *list)
+{
+  if (!list)
+    return NULL;
+
+  return slist_pack_edit(list, list->flags, SIZE_MAX, NULL, false);
+}
+
+/**
+ * slist_find - Find an item in a packed Slist
+ * @param[in]  list  Packed Slist, may be NULL
+ * @param[in]  str   String to find, NULL for an empty item
+ * @param[in]  flags Flags, e.g. #SLIST_CASE_SENSITIVE
+ * @param[out] index Index of the item
+ * @retval true The item was found
+ */
+static bool slist_find(const struct Slist *list, const char *str, int flags, size_t *index)
+{
+  if (!list)
+    return false;
+
+  const struct SlistPacked *sp = (const struct SlistPacked *) list;
+  const bool sensitive = (flags & SLIST_CASE_SENSITIVE);
+
+  for (size_t i = 0; i < list->count; i++)
+  {
+    const char *data = sp->nodes[i].data;
+    if ((sensitive ? mutt_str_strcmp(data, str) : mutt_str_strcasecmp(data, str)) == 0)
+    {
+      *index = i;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * slist_packed_free - Free a packed Slist
+ * @param ptr Slist to free
+ */
+static void slist_packed_free(struct Slist **ptr)
+{
+  if (!ptr || !*ptr)
+    return;
+
+  struct SlistPacked *sp = (struct SlistPacked *) *ptr;
+  mutt_hash_free(&sp->members);
+  FREE(&sp);
+  *ptr = NULL;
+}
+
+/**
+ * slist_parse_packed - Parse a string into a packed Slist
+ * @param str   String to parse
+ * @param flags Flags, e.g. #SLIST_SEP_COLON
+ * @retval ptr Packed Slist
+ */
+static struct Slist *slist_parse_packed(const char *str, int flags)
+{
+  struct Slist *list = slist_parse(str, flags);
+  struct Slist *packed = slist_pack(list);
+  slist_free(&list);
+  return packed;
+}
+
+/**
+ * slist_shared_free - Free a shared Slist - Implements ::shared_free_t
+ */
+static void slist_shared_free(void **obj)
+{
+  slist_packed_free((struct Slist **) obj);
+}
+
+/**
+ * slist_shared - Share an Slist
+ * @param cs   Config items
+ * @param list Slist to share (the caller's reference is taken over)
+ * @retval ptr Shared Slist, with a new reference
+ *
+ * If an identical list is already in use, list is freed and the existing one
+ * is returned.
+ */
+static struct Slist *slist_shared(const struct ConfigSet *cs, struct Slist *list)
+{
+  if (!list)
+    return NULL;
+
+  /* The items are separated by a control character that can't be parsed */
+  struct Buffer *key = mutt_buffer_alloc(256);
+  mutt_buffer_printf(key, "slist:%x:", list->flags);
+  struct ListNode *np = NULL;
+  STAILQ_FOREACH(np, &list->head, entries)
+  {
+    mutt_buffer_addstr(key, NONULL(np->data));
+    mutt_buffer_addch(key, '\x1f');
+  }
+
+  list = cs_shared_add(cs, mutt_b2s(key), list, slist_shared_free);
+  mutt_buffer_free(&key);
+  return list;
+}
+
 /**
  * slist_destroy - Destroy an Slist object
  * @param cs   Config items
@@ -50,7 +271,8 @@ static void slist_destroy(const struct ConfigSet *cs, void *var, const struct Co
   if (!*l)
     return;
 
-  slist_free(l);
+  if (!cs_shared_release(cs, var))
+    slist_packed_free(l);
 }
 
 /**
@@ -80,7 +302,7 @@ static int slist_string_set(const struct ConfigSet *cs, void *var, struct Config
 
   if (var)
   {
-    list = slist_parse(value, cdef->type);
+    list = slist_shared(cs, slist_parse_packed(value, cdef->type));
 
     if (cdef->validator)
     {
@@ -88,7 +310,7 @@ static int slist_string_set(const struct ConfigSet *cs, void *var, struct Config
 
       if (CSR_RESULT(rc) != CSR_SUCCESS)
       {
-        slist_free(&list);
+        slist_destroy(cs, &list, cdef);
         return (rc | CSR_INV_VALIDATOR);
       }
     }
@@ -102,11 +324,7 @@ static int slist_string_set(const struct ConfigSet *cs, void *var, struct Config
   }
   else
   {
-    if (cdef->type & DT_INITIAL_SET)
-      FREE(&cdef->initial);
-
-    cdef->type |= DT_INITIAL_SET;
-    cdef->initial = IP mutt_str_strdup(value);
+    cs_intern_initial(cs, cdef, value);
   }
 
   return CSR_SUCCESS;
@@ -187,9 +405,11 @@ static int slist_native_set(const struct ConfigSet *cs, void *var,
       return (rc | CSR_INV_VALIDATOR);
   }
 
-  slist_free(var);
+  struct Slist *list = (struct Slist *) value;
+  if (!cs_shared_ref(cs, list))
+    list = slist_shared(cs, slist_pack(list));
 
-  struct Slist *list = slist_dup((struct Slist *) value);
+  slist_destroy(cs, var, cdef);
 
   rc = CSR_SUCCESS;
   if (!list)
@@ -236,7 +456,7 @@ static int slist_reset(const struct ConfigSet *cs, void *var,
   const char *initial = (const char *) cdef->initial;
 
   if (initial)
-    list = slist_parse(initial, cdef->type);
+    list = slist_shared(cs, slist_parse_packed(initial, cdef->type));
 
   int rc = CSR_SUCCESS;
 
@@ -272,3 +492,203 @@ void slist_init(struct ConfigSet *cs)
   };
   cs_register_type(cs, DT_SLIST, &cst_slist);
 }
+
+/**
+ * cs_slist_get - Get one string from an Slist config value
+ * @param list  Slist, the value of a config item
+ * @param index Index of the string
+ * @retval ptr  String
+ * @retval NULL Index out of range, or the string is empty
+ *
+ * This is O(1).  The list must have come from the config system, e.g. by
+ * cs_str_native_get().
+ */
+const char *cs_slist_get(const struct Slist *list, size_t index)
+{
+  if (!list || (index >= list->count))
+    return NULL;
+
+  const struct SlistPacked *sp = (const struct SlistPacked *) list;
+  return sp->nodes[index].data;
+}
+
+/**
+ * cs_slist_is_member - Is a string a member of an Slist config value?
+ * @param list Slist, the value of a config item
+ * @param str  String to find
+ * @retval true The string is in the list
+ *
+ * This has the same rules as slist_is_member().  The first time a long list
+ * is searched, its strings are hashed, so later searches are O(1).  The list
+ * must have come from the config system, e.g. by cs_str_native_get().
+ */
+bool cs_slist_is_member(const struct Slist *list, const char *str)
+{
+  if (!list)
+    return false;
+
+  /* Empty strings aren't hashed */
+  if (!str || (str[0] == '\0') || (list->count < SLIST_HASH_MIN))
+    return slist_is_member(list, str);
+
+  struct SlistPacked *sp = (struct SlistPacked *) list;
+
+  pthread_mutex_lock(&SlistLock);
+  if (!sp->members)
+  {
+    sp->members = mutt_hash_new(list->count * 2, MUTT_HASH_NO_FLAGS);
+    for (size_t i = 0; i < list->count; i++)
+    {
+      const char *data = sp->nodes[i].data;
+      if (data && !mutt_hash_find(sp->members, data))
+        mutt_hash_insert(sp->members, data, (void *) data);
+    }
+  }
+  bool found = mutt_hash_find(sp->members, str);
+  pthread_mutex_unlock(&SlistLock);
+
+  return found;
+}
+
+/**
+ * slist_he_get - Get the value and definition of an Slist config item
+ * @param[in]  cs   Config items
+ * @param[in]  he   HashElem representing config item
+ * @param[out] cdef Variable definition
+ * @retval ptr  Current list, may be NULL
+ * @retval NULL Not an Slist config item; cdef is NULL
+ */
+static struct Slist *slist_he_get(const struct ConfigSet *cs, struct HashElem *he,
+                                  const struct ConfigDef **cdef)
+{
+  *cdef = NULL;
+  if (!cs || !he)
+    return NULL;
+
+  struct HashElem *he_base = (he->type & DT_INHERITED) ? cs_he_base(he) : he;
+  if (DTYPE(he_base->type) != DT_SLIST)
+    return NULL;
+
+  *cdef = he_base->data;
+  return (struct Slist *) cs_he_native_get(cs, he, NULL);
+}
+
+/**
+ * slist_he_change - Set an Slist config item to an edited list
+ * @param cs      Config items
+ * @param he      HashElem representing config item
+ * @param cdef    Variable definition
+ * @param list    New list, packed (the caller's reference is taken over)
+ * @param ev      Event to send, e.g. #NT_CONFIG_SLIST_ADD
+ * @param element Item that was added or removed
+ * @param err     Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ */
+static int slist_he_change(const struct ConfigSet *cs, struct HashElem *he,
+                           const struct ConfigDef *cdef, struct Slist *list,
+                           enum NotifyConfig ev, const char *element, struct Buffer *err)
+{
+  /* Like slist_string_set(), an empty list is stored as NULL */
+  if (list && (list->count == 0))
+    slist_destroy(cs, &list, cdef);
+
+  list = slist_shared(cs, list);
+  int rc = cs_he_native_delta(cs, he, (intptr_t) list, ev, element, err);
+  slist_destroy(cs, &list, cdef);
+  return rc;
+}
+
+/**
+ * cs_slist_add - Add an item to an Slist config item
+ * @param cs  Config items
+ * @param he  HashElem representing config item
+ * @param str Item to add, NULL or "" for an empty item
+ * @param err Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ *
+ * The item is appended, following the config item's #SLIST_ALLOW_DUPES,
+ * #SLIST_ALLOW_EMPTY and #SLIST_CASE_SENSITIVE flags.  The validator is run
+ * and the observers are sent #NT_CONFIG_SLIST_ADD.
+ */
+int cs_slist_add(const struct ConfigSet *cs, struct HashElem *he, const char *str,
+                 struct Buffer *err)
+{
+  const struct ConfigDef *cdef = NULL;
+  struct Slist *list = slist_he_get(cs, he, &cdef);
+  if (!cdef)
+    return CSR_ERR_CODE;
+
+  if (str && (str[0] == '\0'))
+    str = NULL;
+
+  if (!str && !(cdef->type & SLIST_ALLOW_EMPTY))
+  {
+    mutt_buffer_printf(err, "Option %s may not contain empty items", cdef->name);
+    return CSR_ERR_INVALID | CSR_INV_TYPE;
+  }
+
+  size_t index = 0;
+  if (!(cdef->type & SLIST_ALLOW_DUPES) && slist_find(list, str, cdef->type, &index))
+    return CSR_SUCCESS | CSR_SUC_NO_CHANGE;
+
+  list = slist_pack_edit(list, cdef->type, SIZE_MAX, str, true);
+  return slist_he_change(cs, he, cdef, list, NT_CONFIG_SLIST_ADD, str, err);
+}
+
+/**
+ * cs_slist_remove - Remove an item from an Slist config item
+ * @param cs  Config items
+ * @param he  HashElem representing config item
+ * @param str Item to remove, NULL or "" for an empty item
+ * @param err Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ *
+ * The first matching item is removed, following the config item's
+ * #SLIST_CASE_SENSITIVE flag.  The validator is run and the observers are sent
+ * #NT_CONFIG_SLIST_REMOVE.
+ */
+int cs_slist_remove(const struct ConfigSet *cs, struct HashElem *he,
+                    const char *str, struct Buffer *err)
+{
+  const struct ConfigDef *cdef = NULL;
+  struct Slist *list = slist_he_get(cs, he, &cdef);
+  if (!cdef)
+    return CSR_ERR_CODE;
+
+  if (str && (str[0] == '\0'))
+    str = NULL;
+
+  size_t index = 0;
+  if (!slist_find(list, str, cdef->type, &index))
+    return CSR_SUCCESS | CSR_SUC_NO_CHANGE;
+
+  list = slist_pack_edit(list, cdef->type, index, NULL, false);
+  return slist_he_change(cs, he, cdef, list, NT_CONFIG_SLIST_REMOVE, str, err);
+}
+
+/**
+ * cs_slist_contains - Is a string in an Slist config item?
+ * @param cs  Config items
+ * @param he  HashElem representing config item
+ * @param str String to find, NULL or "" for an empty item
+ * @retval true The string is in the list
+ *
+ * Unless the config item is #SLIST_CASE_SENSITIVE, case is ignored.
+ */
+bool cs_slist_contains(const struct ConfigSet *cs, struct HashElem *he, const char *str)
+{
+  const struct ConfigDef *cdef = NULL;
+  struct Slist *list = slist_he_get(cs, he, &cdef);
+  if (!list)
+    return false;
+
+  if (str && (str[0] == '\0'))
+    str = NULL;
+
+  /* Long lists have a hash of their strings */
+  if (str && (cdef->type & SLIST_CASE_SENSITIVE))
+    return cs_slist_is_member(list, str);
+
+  size_t index = 0;
+  return slist_find(list, str, cdef->type, &index);
+}
@@ -23,8 +23,21 @@
 #ifndef MUTT_CONFIG_SLIST_H
 #define MUTT_CONFIG_SLIST_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
+struct Buffer;
 struct ConfigSet;
+struct HashElem;
+struct Slist;
+
+void        slist_init(struct ConfigSet *cs);
+
+const char *cs_slist_get      (const struct Slist *list, size_t index);
+bool        cs_slist_is_member(const struct Slist *list, const char *str);
 
-void slist_init(struct ConfigSet *cs);
+int         cs_slist_add      (const struct ConfigSet *cs, struct HashElem *he, const char *str, struct Buffer *err);
+int         cs_slist_remove   (const struct ConfigSet *cs, struct HashElem *he, const char *str, struct Buffer *err);
+bool        cs_slist_contains (const struct ConfigSet *cs, struct HashElem *he, const char *str);
 
 #endif /* MUTT_CONFIG_SLIST_H */
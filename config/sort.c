@@ -32,6 +32,7 @@
 #include <string.h>
 #include "mutt/mutt.h"
 #include "sort.h"
+#include "lookup.h"
 #include "set.h"
 #include "types.h"
 
@@ -164,22 +165,22 @@ static int sort_string_set(const struct ConfigSet *cs, void *var, struct ConfigD
   switch (cdef->type & DT_SUBTYPE_MASK)
   {
     case DT_SORT_INDEX:
-      id = mutt_map_get_value(value, SortMethods);
+      id = lookup_get_value(value, SortMethods);
       break;
     case DT_SORT_ALIAS:
-      id = mutt_map_get_value(value, SortAliasMethods);
+      id = lookup_get_value(value, SortAliasMethods);
       break;
     case DT_SORT_AUX:
-      id = mutt_map_get_value(value, SortAuxMethods);
+      id = lookup_get_value(value, SortAuxMethods);
       break;
     case DT_SORT_BROWSER:
-      id = mutt_map_get_value(value, SortBrowserMethods);
+      id = lookup_get_value(value, SortBrowserMethods);
       break;
     case DT_SORT_KEYS:
-      id = mutt_map_get_value(value, SortKeyMethods);
+      id = lookup_get_value(value, SortKeyMethods);
       break;
     case DT_SORT_SIDEBAR:
-      id = mutt_map_get_value(value, SortSidebarMethods);
+      id = lookup_get_value(value, SortSidebarMethods);
       break;
     default:
       mutt_debug(LL_DEBUG1, "Invalid sort type: %u\n", cdef->type & DT_SUBTYPE_MASK);
@@ -246,22 +247,22 @@ static int sort_string_get(const struct ConfigSet *cs, void *var,
   switch (cdef->type & DT_SUBTYPE_MASK)
   {
     case DT_SORT_INDEX:
-      str = mutt_map_get_name(sort, SortMethods);
+      str = lookup_get_name(sort, SortMethods);
       break;
     case DT_SORT_ALIAS:
-      str = mutt_map_get_name(sort, SortAliasMethods);
+      str = lookup_get_name(sort, SortAliasMethods);
       break;
     case DT_SORT_AUX:
-      str = mutt_map_get_name(sort, SortAuxMethods);
+      str = lookup_get_name(sort, SortAuxMethods);
       break;
     case DT_SORT_BROWSER:
-      str = mutt_map_get_name(sort, SortBrowserMethods);
+      str = lookup_get_name(sort, SortBrowserMethods);
       break;
     case DT_SORT_KEYS:
-      str = mutt_map_get_name(sort, SortKeyMethods);
+      str = lookup_get_name(sort, SortKeyMethods);
       break;
     case DT_SORT_SIDEBAR:
-      str = mutt_map_get_name(sort, SortSidebarMethods);
+      str = lookup_get_name(sort, SortSidebarMethods);
       break;
     default:
       mutt_debug(LL_DEBUG1, "Invalid sort type: %u\n", cdef->type & DT_SUBTYPE_MASK);
@@ -294,22 +295,22 @@ static int sort_native_set(const struct ConfigSet *cs, void *var,
   switch (cdef->type & DT_SUBTYPE_MASK)
   {
     case DT_SORT_INDEX:
-      str = mutt_map_get_name((value & SORT_MASK), SortMethods);
+      str = lookup_get_name((value & SORT_MASK), SortMethods);
       break;
     case DT_SORT_ALIAS:
-      str = mutt_map_get_name((value & SORT_MASK), SortAliasMethods);
+      str = lookup_get_name((value & SORT_MASK), SortAliasMethods);
       break;
     case DT_SORT_AUX:
-      str = mutt_map_get_name((value & SORT_MASK), SortAuxMethods);
+      str = lookup_get_name((value & SORT_MASK), SortAuxMethods);
       break;
     case DT_SORT_BROWSER:
-      str = mutt_map_get_name((value & SORT_MASK), SortBrowserMethods);
+      str = lookup_get_name((value & SORT_MASK), SortBrowserMethods);
       break;
     case DT_SORT_KEYS:
-      str = mutt_map_get_name((value & SORT_MASK), SortKeyMethods);
+      str = lookup_get_name((value & SORT_MASK), SortKeyMethods);
       break;
     case DT_SORT_SIDEBAR:
-      str = mutt_map_get_name((value & SORT_MASK), SortSidebarMethods);
+      str = lookup_get_name((value & SORT_MASK), SortSidebarMethods);
       break;
     default:
       mutt_debug(LL_DEBUG1, "Invalid sort type: %u\n", cdef->type & DT_SUBTYPE_MASK);
@@ -390,4 +391,11 @@ void sort_init(struct ConfigSet *cs)
     NULL,
   };
   cs_register_type(cs, DT_SORT, &cst_sort);
+
+  lookup_register(SortAliasMethods);
+  lookup_register(SortAuxMethods);
+  lookup_register(SortBrowserMethods);
+  lookup_register(SortKeyMethods);
+  lookup_register(SortMethods);
+  lookup_register(SortSidebarMethods);
 }
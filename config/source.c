@@ -0,0 +1,768 @@
+/**
+ * @file
+ * Read config commands from a file
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @page config_source Read config commands from a file
+ *
+ * Read config commands from a file.
+ *
+ * The file is memory-mapped (privately) and each line is tokenised in place,
+ * so sourcing a file doesn't allocate any memory per line.
+ *
+ * The config commands understood are:
+ * - `set name = value`, `set name`, `set noname`, `set invname`
+ * - `unset name`
+ * - `reset name`
+ * - `toggle name`
+ *
+ * Each command may take several names.  Several commands may be put on one
+ * line, separated by `;`.  A `#` starts a comment.
+ *
+ * Files can also be validated without changing the config, see
+ * cs_validate_file().  Many files can be validated in parallel, see
+ * cs_validate_files().
+ *
+ * Validating doesn't change any config item, but it isn't read-only.  Each
+ * value is parsed into a scratch variable, which interns strings, registers
+ * shared objects (Regex, Address, ...) and allocates from the ConfigSet's
+ * Arena.  The string pool, the shared value registry and the Arena each have
+ * a lock, so the workers may run at the same time.
+ */
+
+#include "config.h"
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mutt/mutt.h"
+#include "source.h"
+#include "lookup.h"
+#include "set.h"
+#include "types.h"
+
+/**
+ * enum RcCommand - Config commands understood by cs_source_file()
+ */
+enum RcCommand
+{
+  RC_SET = 1, ///< Set a config item, e.g. `set name = value`
+  RC_UNSET,   ///< Unset a config item, e.g. `unset name`
+  RC_RESET,   ///< Reset a config item to its initial value
+  RC_TOGGLE,  ///< Toggle a bool or quad config item
+};
+
+/**
+ * RcCommands - Names of the config commands
+ */
+static const struct Mapping RcCommands[] = {
+  { "reset",  RC_RESET },
+  { "set",    RC_SET },
+  { "toggle", RC_TOGGLE },
+  { "unset",  RC_UNSET },
+  { NULL,     0 },
+};
+
+typedef uint8_t RcSourceFlags;     ///< Flags for rc_source(), e.g. #RC_SOURCE_VALIDATE
+#define RC_SOURCE_NO_FLAGS        0  ///< No flags are set
+#define RC_SOURCE_VALIDATE  (1 << 0) ///< Check the commands, but don't change the config
+
+typedef uint8_t RcTokenFlags;     ///< Flags for rc_next_token(), e.g. #RC_TOK_EQUALS
+#define RC_TOK_NO_FLAGS        0  ///< No flags are set
+#define RC_TOK_EQUALS    (1 << 0) ///< An '=' ends the token
+
+/**
+ * struct RcLine - A line of a config file being tokenised in place
+ */
+struct RcLine
+{
+  char *pos; ///< Next character to parse
+  char *end; ///< NUL at the end of the line
+};
+
+/**
+ * rc_next_token - Extract the next token from a line, in place
+ * @param[in]  line  Line being parsed
+ * @param[in]  flags Flags, e.g. #RC_TOK_EQUALS
+ * @param[out] delim Character that ended the token: ' ', '=', ';' or '\0'
+ * @param[out] tok   NUL-terminated token, or NULL if the command has ended
+ * @retval true  Success
+ * @retval false The token has an unterminated quote
+ *
+ * Quotes are removed and escape sequences are expanded by overwriting the
+ * line.  The unescaped token is never longer than the original, so it's safe
+ * to terminate it in place.
+ */
+static bool rc_next_token(struct RcLine *line, RcTokenFlags flags, char *delim, char **tok)
+{
+  char *p = line->pos;
+  while ((*p == ' ') || (*p == '\t'))
+    p++;
+
+  *tok = NULL;
+  *delim = '\0';
+
+  if ((*p == '\0') || (*p == '#'))
+  {
+    line->pos = line->end;
+    return true;
+  }
+
+  if (*p == ';')
+  {
+    line->pos = p + 1;
+    *delim = ';';
+    return true;
+  }
+
+  char *w = p;
+  char quote = '\0';
+  *tok = p;
+
+  for (; *p; p++)
+  {
+    if (quote)
+    {
+      if (*p == quote)
+      {
+        quote = '\0';
+      }
+      else if ((quote == '"') && (p[0] == '\\') && (p[1] != '\0'))
+      {
+        p++;
+        switch (*p)
+        {
+          case 'n':
+            *w++ = '\n';
+            break;
+          case 'r':
+            *w++ = '\r';
+            break;
+          case 't':
+            *w++ = '\t';
+            break;
+          default:
+            *w++ = *p;
+        }
+      }
+      else
+      {
+        *w++ = *p;
+      }
+      continue;
+    }
+
+    if ((*p == '"') || (*p == '\''))
+    {
+      quote = *p;
+      continue;
+    }
+
+    if ((p[0] == '\\') && (p[1] != '\0'))
+    {
+      p++;
+      *w++ = *p;
+      continue;
+    }
+
+    if ((*p == ' ') || (*p == '\t') || (*p == ';') || (*p == '#') ||
+        ((*p == '=') && (flags & RC_TOK_EQUALS)))
+    {
+      break;
+    }
+
+    *w++ = *p;
+  }
+
+  if (quote)
+    return false;
+
+  if ((*p == '\0') || (*p == '#'))
+  {
+    line->pos = line->end;
+  }
+  else
+  {
+    *delim = (*p == '\t') ? ' ' : *p;
+    line->pos = p + 1;
+  }
+
+  *w = '\0';
+  return true;
+}
+
+/**
+ * rc_toggle - Toggle a bool or quad config item
+ * @param cs   Config items
+ * @param he   HashElem representing config item
+ * @param type Data type of the config item, e.g. #DT_BOOL
+ * @param err  Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ *
+ * Unlike bool_he_toggle(), this works on inherited config items, too.
+ */
+static int rc_toggle(const struct ConfigSet *cs, struct HashElem *he, int type,
+                     struct Buffer *err)
+{
+  intptr_t value = cs_he_native_get(cs, he, err);
+  if (value == INT_MIN)
+    return CSR_ERR_CODE;
+
+  /* Toggling the low bit of a quad swaps no/yes and ask-no/ask-yes */
+  if (type == DT_BOOL)
+    value = !value;
+  else
+    value ^= 1;
+
+  return cs_he_native_set(cs, he, value, err);
+}
+
+/**
+ * union RcScratch - Somewhere to store any type of config value
+ */
+union RcScratch
+{
+  bool b;     ///< DT_BOOL
+  char c;     ///< DT_QUAD
+  short s;    ///< DT_NUMBER
+  long l;     ///< DT_LONG
+  void *ptr;  ///< DT_ADDRESS, DT_MBTABLE, DT_REGEX, DT_SLIST, DT_STRING
+  intptr_t ip;
+};
+
+/**
+ * rc_check - Check a value against a config item, without changing it
+ * @param cs        Config items
+ * @param he        HashElem representing config item
+ * @param by_string If true, check str, otherwise check value
+ * @param str       String value to check
+ * @param value     Native value to check
+ * @param err       Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ *
+ * The value is parsed into a scratch variable, using the type's own code, so
+ * the type-checks and validator are identical to setting the item for real.
+ */
+static int rc_check(const struct ConfigSet *cs, struct HashElem *he, bool by_string,
+                    const char *str, intptr_t value, struct Buffer *err)
+{
+  struct HashElem *he_base = cs_he_base(he);
+  struct ConfigDef *cdef = he_base->data;
+  const struct ConfigSetType *cst = cs_get_type_def(cs, he_base->type);
+  if (!cst)
+    return CSR_ERR_CODE; /* LCOV_EXCL_LINE */
+
+  union RcScratch scratch;
+  memset(&scratch, 0, sizeof(scratch));
+
+  int rc;
+  if (by_string)
+    rc = cst->string_set(cs, &scratch, cdef, str, err);
+  else
+    rc = cst->native_set(cs, &scratch, cdef, value, err);
+
+  /* The types skip the validator if the value matches the (empty) scratch */
+  if ((CSR_RESULT(rc) == CSR_SUCCESS) && (rc & CSR_SUC_NO_CHANGE) && cdef->validator)
+  {
+    rc = cdef->validator(cs, cdef, cst->native_get(cs, &scratch, cdef, err), err);
+    if (CSR_RESULT(rc) != CSR_SUCCESS)
+      rc |= CSR_INV_VALIDATOR;
+  }
+
+  if (cst->destroy)
+    cst->destroy(cs, &scratch, cdef);
+
+  return rc;
+}
+
+/**
+ * rc_apply - Apply one config command to one config item
+ * @param cs    Config items
+ * @param flags Flags, e.g. #RC_SOURCE_VALIDATE
+ * @param cmd   Command, e.g. #RC_SET
+ * @param name  Name of the config item
+ * @param value Value to set (#RC_SET only), may be NULL
+ * @param err   Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ *
+ * If #RC_SOURCE_VALIDATE is set, the command is only checked.  'reset' and
+ * 'toggle' can't fail for a known item, so they're accepted as they are.
+ */
+static int rc_apply(const struct ConfigSet *cs, RcSourceFlags flags, enum RcCommand cmd,
+                    const char *name, const char *value, struct Buffer *err)
+{
+  struct HashElem *he = cs_get_elem(cs, name);
+
+  /* 'set noname' and 'set invname' for bools and quads */
+  if (!he && (cmd == RC_SET) && !value)
+  {
+    size_t plen = mutt_str_startswith(name, "no", CASE_MATCH);
+    if (plen != 0)
+    {
+      cmd = RC_UNSET;
+    }
+    else
+    {
+      plen = mutt_str_startswith(name, "inv", CASE_MATCH);
+      if (plen != 0)
+        cmd = RC_TOGGLE;
+    }
+
+    if (plen != 0)
+    {
+      he = cs_get_elem(cs, name + plen);
+      if (he)
+      {
+        const int type = DTYPE(cs_he_base(he)->type);
+        if ((type != DT_BOOL) && (type != DT_QUAD))
+          he = NULL;
+      }
+    }
+  }
+
+  if (!he)
+  {
+    mutt_buffer_printf(err, "Unknown var '%s'", name);
+    return CSR_ERR_UNKNOWN;
+  }
+
+  const int type = DTYPE(cs_he_base(he)->type);
+  const bool yes_no = (type == DT_BOOL) || (type == DT_QUAD);
+  const bool validate = (flags & RC_SOURCE_VALIDATE);
+
+  switch (cmd)
+  {
+    case RC_SET:
+      if (value && validate)
+        return rc_check(cs, he, true, value, 0, err);
+      if (value)
+        return cs_he_string_set(cs, he, value, err);
+      if (yes_no && validate)
+        return rc_check(cs, he, false, NULL, 1, err);
+      if (yes_no)
+        return cs_he_native_set(cs, he, 1, err);
+      mutt_buffer_printf(err, "Missing value for '%s'", name);
+      return CSR_ERR_INVALID | CSR_INV_TYPE;
+
+    case RC_UNSET:
+      if (validate)
+        return rc_check(cs, he, !yes_no, NULL, 0, err);
+      if (yes_no)
+        return cs_he_native_set(cs, he, 0, err);
+      return cs_he_string_set(cs, he, NULL, err);
+
+    case RC_RESET:
+      if (validate)
+        return CSR_SUCCESS;
+      return cs_he_reset(cs, he, err);
+
+    case RC_TOGGLE:
+      if (yes_no && validate)
+        return CSR_SUCCESS;
+      if (yes_no)
+        return rc_toggle(cs, he, type, err);
+      mutt_buffer_printf(err, "Can't toggle '%s', it isn't a bool or quad", name);
+      return CSR_ERR_INVALID | CSR_INV_TYPE;
+  }
+
+  return CSR_ERR_CODE; /* LCOV_EXCL_LINE */
+}
+
+/**
+ * rc_command - Parse and apply the arguments of a config command
+ * @param cs    Config items
+ * @param flags Flags, e.g. #RC_SOURCE_VALIDATE
+ * @param line  Line being parsed, positioned after the command name
+ * @param cmd   Command, e.g. #RC_SET
+ * @param err   Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ *
+ * The arguments end at the end of the line, or at a ';'.
+ */
+static int rc_command(const struct ConfigSet *cs, RcSourceFlags flags,
+                      struct RcLine *line, enum RcCommand cmd, struct Buffer *err)
+{
+  const RcTokenFlags tok_flags = (cmd == RC_SET) ? RC_TOK_EQUALS : RC_TOK_NO_FLAGS;
+  int rc = CSR_SUCCESS;
+  char delim = '\0';
+  char *name = NULL;
+
+  do
+  {
+    if (!rc_next_token(line, tok_flags, &delim, &name))
+      goto unterminated;
+    if (!name)
+      break;
+
+    char *value = NULL;
+    if (cmd == RC_SET)
+    {
+      /* Allow spaces around the '=' */
+      if (delim == ' ')
+      {
+        while ((*line->pos == ' ') || (*line->pos == '\t'))
+          line->pos++;
+        if (*line->pos == '=')
+        {
+          line->pos++;
+          delim = '=';
+        }
+      }
+
+      if (delim == '=')
+      {
+        if (!rc_next_token(line, RC_TOK_NO_FLAGS, &delim, &value))
+          goto unterminated;
+        if (!value)
+          value = line->end; /* set name = */
+      }
+    }
+
+    rc = rc_apply(cs, flags, cmd, name, value, err);
+    if (CSR_RESULT(rc) != CSR_SUCCESS)
+      return rc;
+  } while ((delim != ';') && (line->pos < line->end));
+
+  return rc;
+
+unterminated:
+  mutt_buffer_printf(err, "Unterminated quote");
+  return CSR_ERR_INVALID | CSR_INV_TYPE;
+}
+
+/**
+ * rc_parse_line - Parse and apply one line of a config file
+ * @param cs    Config items
+ * @param flags Flags, e.g. #RC_SOURCE_VALIDATE
+ * @param line  Line to parse
+ * @param err   Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
+ */
+static int rc_parse_line(const struct ConfigSet *cs, RcSourceFlags flags,
+                         struct RcLine *line, struct Buffer *err)
+{
+  int rc = CSR_SUCCESS;
+  char delim = '\0';
+  char *word = NULL;
+
+  while (line->pos < line->end)
+  {
+    if (!rc_next_token(line, RC_TOK_NO_FLAGS, &delim, &word))
+    {
+      mutt_buffer_printf(err, "Unterminated quote");
+      return CSR_ERR_INVALID | CSR_INV_TYPE;
+    }
+
+    if (!word)
+    {
+      if (delim == ';')
+        continue;
+      break;
+    }
+
+    int cmd = lookup_get_value(word, RcCommands);
+    if (cmd < 0)
+    {
+      mutt_buffer_printf(err, "Unknown command: %s", word);
+      return CSR_ERR_UNKNOWN;
+    }
+
+    if (delim == ';')
+      continue;
+
+    rc = rc_command(cs, flags, line, cmd, err);
+    if (CSR_RESULT(rc) != CSR_SUCCESS)
+      return rc;
+  }
+
+  return rc;
+}
+
+/**
+ * rc_source - Read config commands from a file
+ * @param[in]  cs    Config items
+ * @param[in]  path  Path of the file
+ * @param[in]  flags Flags, e.g. #RC_SOURCE_VALIDATE
+ * @param[out] lines Number of lines read, may be NULL
+ * @param[in]  err   Buffer for error messages
+ * @retval  0 Success, every line was applied
+ * @retval >0 Number of lines that failed
+ * @retval -1 The file couldn't be read
+ *
+ * Normally, each failure is reported using mutt_error() and the first one is
+ * written to err.  With #RC_SOURCE_VALIDATE, every failure is appended to err,
+ * one per line, and nothing else is reported.
+ */
+static int rc_source(const struct ConfigSet *cs, const char *path,
+                     RcSourceFlags flags, size_t *lines, struct Buffer *err)
+{
+  if (lines)
+    *lines = 0;
+  if (!cs || !path)
+    return -1;
+
+  lookup_register(RcCommands);
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    mutt_buffer_printf(err, "%s: %s", path, strerror(errno));
+    return -1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0)
+  {
+    mutt_buffer_printf(err, "%s: %s", path, strerror(errno));
+    close(fd);
+    return -1;
+  }
+
+  const size_t size = st.st_size;
+  if (size == 0)
+  {
+    close(fd);
+    return 0;
+  }
+
+  /* A private, writable mapping lets us tokenise in place.
+   * The changes are never written back to the file. */
+  char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    mutt_buffer_printf(err, "%s: %s", path, strerror(errno));
+    return -1;
+  }
+  madvise(map, size, MADV_SEQUENTIAL);
+
+  struct Buffer *msg = mutt_buffer_alloc(256);
+  struct Buffer *last = NULL;
+  const char *map_end = map + size;
+  char *next = map;
+  int errors = 0;
+  int lineno = 0;
+
+  while (next < map_end)
+  {
+    struct RcLine line = { next, NULL };
+    lineno++;
+
+    char *eol = memchr(next, '\n', map_end - next);
+    if (eol)
+    {
+      line.end = eol;
+      next = eol + 1;
+    }
+    else
+    {
+      /* The last line has no newline and there may be no room to
+       * terminate it inside the mapping, so work on a copy. */
+      last = mutt_buffer_alloc(map_end - next + 1);
+      mutt_buffer_addstr_n(last, next, map_end - next);
+      line.pos = last->data;
+      line.end = last->dptr;
+      next = (char *) map_end;
+    }
+
+    if ((line.end > line.pos) && (line.end[-1] == '\r'))
+      line.end--;
+    *line.end = '\0';
+
+    mutt_buffer_reset(msg);
+    int rc = rc_parse_line(cs, flags, &line, msg);
+    if (CSR_RESULT(rc) == CSR_SUCCESS)
+      continue;
+
+    if (flags & RC_SOURCE_VALIDATE)
+    {
+      mutt_buffer_add_printf(err, "%s:%d: %s\n", path, lineno, mutt_b2s(msg));
+    }
+    else
+    {
+      mutt_error("Error in %s, line %d: %s", path, lineno, mutt_b2s(msg));
+      if (errors == 0)
+        mutt_buffer_printf(err, "%s:%d: %s", path, lineno, mutt_b2s(msg));
+    }
+    errors++;
+  }
+
+  mutt_buffer_free(&last);
+  mutt_buffer_free(&msg);
+  munmap(map, size);
+
+  if (lines)
+    *lines = lineno;
+  return errors;
+}
+
+/**
+ * cs_source_file - Read config commands from a file
+ * @param cs   Config items
+ * @param path Path of the file
+ * @param err  Buffer for error messages
+ * @retval  0 Success, every line was applied
+ * @retval >0 Number of lines that failed
+ * @retval -1 The file couldn't be read
+ *
+ * Every line is applied, even if earlier lines failed.  Each failure is
+ * reported, with its line number, using mutt_error().  The first failure is
+ * also written to err.
+ */
+int cs_source_file(const struct ConfigSet *cs, const char *path, struct Buffer *err)
+{
+  return rc_source(cs, path, RC_SOURCE_NO_FLAGS, NULL, err);
+}
+
+/**
+ * cs_validate_file - Check the config commands in a file
+ * @param cs   Config items
+ * @param path Path of the file
+ * @param err  Buffer for error messages
+ * @retval  0 Success, every line is valid
+ * @retval >0 Number of lines that are invalid
+ * @retval -1 The file couldn't be read
+ *
+ * Every line is parsed and type-checked, and the values are passed to the
+ * validators, exactly as cs_source_file() would, but the ConfigSet isn't
+ * changed and no notifications are sent.  Every failure is appended to err,
+ * as "path:line: message", one per line.
+ *
+ * The config items aren't changed, but the values are parsed, so the string
+ * pool, the shared value registry and the Arena are used.  These are locked,
+ * so this may be called from several threads at once, as long as nothing is
+ * changing the config items.
+ */
+int cs_validate_file(const struct ConfigSet *cs, const char *path, struct Buffer *err)
+{
+  return rc_source(cs, path, RC_SOURCE_VALIDATE, NULL, err);
+}
+
+/**
+ * struct ValidatePool - Work shared by the validation threads
+ */
+struct ValidatePool
+{
+  const struct ConfigSet *cs;   ///< Config items
+  struct ValidateResult *files; ///< Files to validate
+  size_t num_files;             ///< Number of files
+  size_t next;                  ///< Next file to be claimed (atomic)
+};
+
+/**
+ * validate_worker - Validate files until there are none left
+ * @param data ValidatePool
+ * @retval NULL Always
+ */
+static void *validate_worker(void *data)
+{
+  struct ValidatePool *pool = data;
+
+  while (true)
+  {
+    size_t i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+    if (i >= pool->num_files)
+      break;
+
+    struct ValidateResult *vr = &pool->files[i];
+    vr->err = mutt_buffer_alloc(256);
+    vr->errors = rc_source(pool->cs, vr->path, RC_SOURCE_VALIDATE, &vr->lines, vr->err);
+    if (vr->errors < 0)
+      mutt_buffer_addch(vr->err, '\n');
+  }
+
+  return NULL;
+}
+
+/**
+ * cs_validate_files - Check the config commands in many files, in parallel
+ * @param cs      Config items
+ * @param files   Files to validate
+ * @param num     Number of files
+ * @param threads Number of threads to use, 0 means one per CPU
+ * @retval num Total number of invalid lines
+ *
+ * Each file is checked by cs_validate_file().  The caller fills in the path of
+ * each ValidateResult; the rest is filled in here.  Files that couldn't be read
+ * have errors set to -1.  The caller must free the err Buffers, see
+ * cs_validate_free().
+ */
+size_t cs_validate_files(const struct ConfigSet *cs, struct ValidateResult *files,
+                         size_t num, int threads)
+{
+  if (!cs || !files || (num == 0))
+    return 0;
+
+  if (threads <= 0)
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads <= 0)
+    threads = 1;
+  if ((size_t) threads > num)
+    threads = num;
+
+  struct ValidatePool pool = { cs, files, num, 0 };
+
+  pthread_t *tids = mutt_mem_calloc(threads, sizeof(pthread_t));
+  int started = 0;
+  for (; started < threads; started++)
+  {
+    if (pthread_create(&tids[started], NULL, validate_worker, &pool) != 0)
+      break; /* LCOV_EXCL_LINE */
+  }
+
+  /* If no threads could be started, do the work ourselves */
+  if (started == 0)
+    validate_worker(&pool); /* LCOV_EXCL_LINE */
+
+  for (int i = 0; i < started; i++)
+    pthread_join(tids[i], NULL);
+  FREE(&tids);
+
+  size_t total = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    if (files[i].errors > 0)
+      total += files[i].errors;
+  }
+
+  return total;
+}
+
+/**
+ * cs_validate_free - Free the results of cs_validate_files()
+ * @param files Files that were validated
+ * @param num   Number of files
+ */
+void cs_validate_free(struct ValidateResult *files, size_t num)
+{
+  if (!files)
+    return;
+
+  for (size_t i = 0; i < num; i++)
+    mutt_buffer_free(&files[i].err);
+}
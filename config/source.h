@@ -0,0 +1,47 @@
+/**
+ * @file
+ * Read config commands from a file
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUTT_CONFIG_SOURCE_H
+#define MUTT_CONFIG_SOURCE_H
+
+#include <stddef.h>
+
+struct Buffer;
+struct ConfigSet;
+
+/**
+ * struct ValidateResult - The result of validating one config file
+ */
+struct ValidateResult
+{
+  const char *path;   ///< Path of the file
+  int errors;         ///< Number of invalid lines, or -1 if the file couldn't be read
+  size_t lines;       ///< Number of lines read
+  struct Buffer *err; ///< All the errors, one per line
+};
+
+int    cs_source_file   (const struct ConfigSet *cs, const char *path, struct Buffer *err);
+int    cs_validate_file (const struct ConfigSet *cs, const char *path, struct Buffer *err);
+size_t cs_validate_files(const struct ConfigSet *cs, struct ValidateResult *files, size_t num, int threads);
+void   cs_validate_free (struct ValidateResult *files, size_t num);
+
+#endif /* MUTT_CONFIG_SOURCE_H */
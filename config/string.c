@@ -31,6 +31,7 @@
 #include <limits.h>
 #include <stdint.h>
 #include "mutt/mutt.h"
+#include "intern.h"
 #include "set.h"
 #include "types.h"
 
@@ -47,13 +48,14 @@ static void string_destroy(const struct ConfigSet *cs, void *var, const struct C
     return;
 
   /* Don't free strings from the var definition */
-  if (*(char **) var == (char *) cdef->initial)
+  if (!(cdef->type & DT_INITIAL_SET) && (*(char **) var == (char *) cdef->initial))
   {
     *(char **) var = NULL;
     return;
   }
 
-  FREE(var);
+  if (!cs_intern_release(cs, str))
+    FREE(var);
 }
 
 /**
@@ -92,7 +94,7 @@ static int string_string_set(const struct ConfigSet *cs, void *var, struct Confi
 
     string_destroy(cs, var, cdef);
 
-    const char *str = mutt_str_strdup(value);
+    const char *str = cs_intern(cs, value);
     if (!str)
       rc |= CSR_SUC_EMPTY;
 
@@ -100,15 +102,11 @@ static int string_string_set(const struct ConfigSet *cs, void *var, struct Confi
   }
   else
   {
-    /* we're already using the initial value */
-    if (*(char **) cdef->var == (char *) cdef->initial)
-      *(char **) cdef->var = mutt_str_strdup((char *) cdef->initial);
+    /* we're borrowing the initial value from the var definition */
+    if (!(cdef->type & DT_INITIAL_SET) && (*(char **) cdef->var == (char *) cdef->initial))
+      *(const char **) cdef->var = cs_intern(cs, (const char *) cdef->initial);
 
-    if (cdef->type & DT_INITIAL_SET)
-      FREE(&cdef->initial);
-
-    cdef->type |= DT_INITIAL_SET;
-    cdef->initial = IP mutt_str_strdup(value);
+    cs_intern_initial(cs, cdef, value);
   }
 
   return rc;
@@ -174,7 +172,7 @@ static int string_native_set(const struct ConfigSet *cs, void *var,
 
   string_destroy(cs, var, cdef);
 
-  str = mutt_str_strdup(str);
+  str = cs_intern(cs, str);
   rc = CSR_SUCCESS;
   if (!str)
     rc |= CSR_SUC_EMPTY;
@@ -228,6 +226,11 @@ static int string_reset(const struct ConfigSet *cs, void *var,
   if (!str)
     rc |= CSR_SUC_EMPTY;
 
+  /* An initial value that was set at runtime can be replaced, so take a
+   * reference.  One from the var definition can be borrowed. */
+  if (cdef->type & DT_INITIAL_SET)
+    str = cs_intern(cs, str);
+
   *(const char **) var = str;
   return rc;
 }
@@ -24,17 +24,52 @@
  * @page config_subset Subset of Config Items
  *
  * Subset of Config Items
+ *
+ * A Subset can be created in one of two ways:
+ *
+ * - cs_subset_new() creates an inherited config item for every name, up front.
+ * - cs_subset_new_sparse() creates nothing until a value is set.  Until then,
+ *   reads fall through to the parent Subset, or the base ConfigSet.  The items
+ *   of a sparse Subset are only visible by name ("scope:name") once they've
+ *   been set.  The parent Subset must outlive its children.
+ *
+ * Either way, the Subset keeps its value IDs sorted by name, so that
+ * cs_subset_lookup() is a binary search.  The native and string functions
+ * then use the HashElems directly, without building "scope:name" keys.
+ *
+ * Subsets that use the same var_names array share one sorted index.  It's
+ * counted, and freed with the last Subset that uses it.
  */
 
 #include "config.h"
 #include <stddef.h>
 #include <limits.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
 #include "mutt/mutt.h"
 #include "subset.h"
 #include "set.h"
 #include "types.h"
 
+/**
+ * struct SubsetIndex - Value IDs of a var_names array, sorted by name
+ */
+struct SubsetIndex
+{
+  const char **var_names;   ///< Array of config item names
+  size_t num_vars;          ///< Number of names
+  int *sorted;              ///< Value IDs, sorted by name
+  int refs;                 ///< Number of Subsets using the index
+  struct SubsetIndex *next; ///< Next index in the list
+};
+
+static struct SubsetIndex *SubsetIndexes = NULL; ///< Sorted indexes in use
+static pthread_mutex_t SubsetIndexLock = PTHREAD_MUTEX_INITIALIZER; ///< Protects SubsetIndexes
+
+static void subset_release_names(struct ConfigSubset *sub);
+
 /**
  * cs_subset_free - XXX
  * @param sub XXX
@@ -47,8 +82,11 @@ void cs_subset_free(struct ConfigSubset **ptr)
   struct ConfigSubset *sub = *ptr;
 
   char scope[128];
-  for (size_t i = 0; i < sub->num_vars; i++)
+  for (size_t i = 0; sub->vars && (i < sub->num_vars); i++)
   {
+    if (sub->sparse && !sub->vars[i])
+      continue;
+
     if (sub->scope)
       snprintf(scope, sizeof(scope), "%s:%s", sub->scope, sub->var_names[i]);
     else
@@ -61,9 +99,103 @@ void cs_subset_free(struct ConfigSubset **ptr)
   // sub->var_names isn't ours to free
   FREE(&sub->scope);
   FREE(&sub->vars);
+  subset_release_names(sub);
   FREE(ptr);
 }
 
+/**
+ * subset_sort_cb - Compare two config item names for qsort()
+ * @param a First pointer into a Subset's var_names
+ * @param b Second pointer into a Subset's var_names
+ * @retval <0 a precedes b
+ * @retval  0 a and b are identical
+ * @retval >0 b precedes a
+ */
+static int subset_sort_cb(const void *a, const void *b)
+{
+  const char *const *x = *(const char *const *const *) a;
+  const char *const *y = *(const char *const *const *) b;
+  return mutt_str_strcmp(*x, *y);
+}
+
+/**
+ * subset_sort_names - Sort the Subset's value IDs by name
+ * @param sub Subset
+ *
+ * If another Subset uses the same var_names, its index is shared.
+ */
+static void subset_sort_names(struct ConfigSubset *sub)
+{
+  if (sub->num_vars == 0)
+    return;
+
+  pthread_mutex_lock(&SubsetIndexLock);
+
+  struct SubsetIndex *idx = SubsetIndexes;
+  for (; idx; idx = idx->next)
+  {
+    if ((idx->var_names == sub->var_names) && (idx->num_vars == sub->num_vars))
+      break;
+  }
+
+  if (!idx)
+  {
+    const char ***ptrs = mutt_mem_calloc(sub->num_vars, sizeof(const char **));
+    for (size_t i = 0; i < sub->num_vars; i++)
+      ptrs[i] = &sub->var_names[i];
+
+    qsort(ptrs, sub->num_vars, sizeof(ptrs[0]), subset_sort_cb);
+
+    idx = mutt_mem_calloc(1, sizeof(*idx));
+    idx->var_names = sub->var_names;
+    idx->num_vars = sub->num_vars;
+    idx->sorted = mutt_mem_calloc(sub->num_vars, sizeof(int));
+    for (size_t i = 0; i < sub->num_vars; i++)
+      idx->sorted[i] = ptrs[i] - sub->var_names;
+
+    FREE(&ptrs);
+    idx->next = SubsetIndexes;
+    SubsetIndexes = idx;
+  }
+
+  idx->refs++;
+  sub->sorted = idx->sorted;
+
+  pthread_mutex_unlock(&SubsetIndexLock);
+}
+
+/**
+ * subset_release_names - Release the Subset's sorted value IDs
+ * @param sub Subset
+ *
+ * The index is freed when the last Subset using it is freed.
+ */
+static void subset_release_names(struct ConfigSubset *sub)
+{
+  if (!sub->sorted)
+    return;
+
+  pthread_mutex_lock(&SubsetIndexLock);
+
+  for (struct SubsetIndex **pp = &SubsetIndexes; *pp; pp = &(*pp)->next)
+  {
+    struct SubsetIndex *idx = *pp;
+    if (idx->sorted != sub->sorted)
+      continue;
+
+    if (--idx->refs == 0)
+    {
+      *pp = idx->next;
+      FREE(&idx->sorted);
+      FREE(&idx);
+    }
+    break;
+  }
+
+  pthread_mutex_unlock(&SubsetIndexLock);
+  sub->sorted = NULL;
+}
+
 /**
  * cs_subset_new - XXX
  */
@@ -89,6 +221,7 @@ struct ConfigSubset *cs_subset_new(const struct ConfigSet *cs,
   sub->var_names = var_names;
   sub->vars = mutt_mem_calloc(count, sizeof(struct HashElem *));
   sub->num_vars = count;
+  subset_sort_names(sub);
 
   char tmp[130];
   for (size_t i = 0; i < sub->num_vars; i++)
@@ -124,36 +257,193 @@ struct ConfigSubset *cs_subset_new(const struct ConfigSet *cs,
 }
 
 /**
- * cs_subset_lookup - XXX
+ * cs_subset_new_sparse - Create a Subset that only stores overridden values
+ * @param cs        Config items
+ * @param name      Name of the Subset, e.g. "mbox"
+ * @param parent    Parent Subset, or NULL to inherit from the ConfigSet
+ * @param var_names Names of the config items, NULL-terminated
+ * @retval ptr  New Subset
+ * @retval NULL Error, one of the config items doesn't exist
+ *
+ * Nothing is added to the ConfigSet until a value is set.  The var_names
+ * array must outlive the Subset.
+ */
+struct ConfigSubset *cs_subset_new_sparse(const struct ConfigSet *cs, const char *name,
+                                          struct ConfigSubset *parent,
+                                          const char *var_names[])
+{
+  if (!cs || !name || !var_names)
+    return NULL;
+
+  size_t count = 0;
+  for (; var_names[count]; count++)
+  {
+    if (!cs_get_elem(cs, var_names[count]))
+    {
+      mutt_debug(LL_DEBUG1, "%s doesn't exist\n", var_names[count]);
+      return NULL;
+    }
+  }
+
+  char scope[128];
+  if (parent)
+    snprintf(scope, sizeof(scope), "%s:%s", parent->scope, name);
+  else
+    mutt_str_strfcpy(scope, name, sizeof(scope));
+
+  struct ConfigSubset *sub = mutt_mem_calloc(1, sizeof(*sub));
+  sub->scope = mutt_str_strdup(scope);
+  sub->cs = cs;
+  sub->var_names = var_names;
+  sub->num_vars = count;
+  sub->parent = parent;
+  sub->sparse = true;
+  subset_sort_names(sub);
+
+  return sub;
+}
+
+/**
+ * subset_find_name - Find the index of a config item in a Subset
+ * @param sub  Subset
+ * @param name Name of the config item
+ * @retval num Index of the config item
+ * @retval -1  Not found
+ */
+static int subset_find_name(const struct ConfigSubset *sub, const char *name)
+{
+  size_t lo = 0;
+  size_t hi = sub->num_vars;
+  while (lo < hi)
+  {
+    size_t mid = lo + ((hi - lo) / 2);
+    int vid = sub->sorted[mid];
+    int cmp = mutt_str_strcmp(name, sub->var_names[vid]);
+    if (cmp == 0)
+      return vid;
+    if (cmp < 0)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  return -1;
+}
+
+/**
+ * subset_get_he - Find the config item to read for a Subset value
+ * @param sub Subset
+ * @param vid Value ID (index into Subset's HashElem's)
+ * @retval ptr HashElem of the Subset, or of the nearest ancestor that has one
  */
-int cs_subset_lookup(struct ConfigSubset *sub, const char *name)
+static struct HashElem *subset_get_he(const struct ConfigSubset *sub, int vid)
+{
+  if (sub->vars && sub->vars[vid])
+    return sub->vars[vid];
+
+  const char *name = sub->var_names[vid];
+  for (const struct ConfigSubset *p = sub->parent; p; p = p->parent)
+  {
+    if (!p->vars)
+      continue;
+
+    int pvid = subset_find_name(p, name);
+    if ((pvid >= 0) && p->vars[pvid])
+      return p->vars[pvid];
+  }
+
+  return cs_get_elem(sub->cs, name);
+}
+
+/**
+ * subset_create_he - Create the config item for a Subset value
+ * @param sub Subset
+ * @param vid Value ID (index into Subset's HashElem's)
+ * @retval ptr  HashElem of the Subset
+ * @retval NULL Error
+ *
+ * If the parent Subsets don't have an item of this name, yet, they're created
+ * (inheriting, without a value) so that the chain of inheritance is complete.
+ */
+static struct HashElem *subset_create_he(struct ConfigSubset *sub, int vid)
+{
+  if (sub->vars && sub->vars[vid])
+    return sub->vars[vid];
+
+  if (!sub->vars)
+    sub->vars = mutt_mem_calloc(sub->num_vars, sizeof(struct HashElem *));
+
+  const char *name = sub->var_names[vid];
+  struct HashElem *parent = NULL;
+  for (struct ConfigSubset *p = sub->parent; p && !parent; p = p->parent)
+  {
+    int pvid = subset_find_name(p, name);
+    if (pvid >= 0)
+      parent = subset_create_he(p, pvid);
+  }
+
+  if (!parent)
+    parent = cs_get_elem(sub->cs, name);
+
+  char tmp[130];
+  snprintf(tmp, sizeof(tmp), "%s:%s", sub->scope, name);
+  sub->vars[vid] = cs_inherit_variable(sub->cs, parent, tmp);
+  return sub->vars[vid];
+}
+
+/**
+ * cs_subset_lookup - Find the Value ID of a config item
+ * @param sub  Subset
+ * @param name Name of the config item, without the scope
+ * @retval num Value ID (index into Subset's HashElem's)
+ * @retval -1  Not found
+ */
+int cs_subset_lookup(const struct ConfigSubset *sub, const char *name)
 {
   if (!sub || !name)
     return -1;
 
-  return -1;
+  return subset_find_name(sub, name);
 }
 
 /**
- * cs_subset_native_get - XXX
+ * cs_subset_native_get - Natively get the value of a Subset config item
+ * @param sub Subset
+ * @param vid Value ID (index into Subset's HashElem's)
+ * @param err Buffer for error messages
+ * @retval intptr_t Native value
+ * @retval INT_MIN  Error
+ *
+ * If the Subset's item has no value, the nearest ancestor's is returned.
  */
 intptr_t cs_subset_native_get(const struct ConfigSubset *sub, int vid, struct Buffer *err)
 {
   if (!sub || (vid < 0) || (vid >= sub->num_vars))
     return INT_MIN;
 
-  return INT_MIN;
+  struct HashElem *he = subset_get_he(sub, vid);
+
+  return cs_he_native_get(sub->cs, he, err);
 }
 
 /**
- * cs_subset_native_set - XXX
+ * cs_subset_native_set - Natively set the value of a Subset config item
+ * @param sub   Subset
+ * @param vid   Value ID (index into Subset's HashElem's)
+ * @param value Native pointer/value to set
+ * @param err   Buffer for error messages
+ * @retval num Result, e.g. #CSR_SUCCESS
  */
-int cs_subset_native_set(const struct ConfigSubset *sub, int vid, intptr_t value, struct Buffer *err)
+int cs_subset_native_set(struct ConfigSubset *sub, int vid, intptr_t value, struct Buffer *err)
 {
   if (!sub || (vid < 0) || (vid >= sub->num_vars))
     return CSR_ERR_CODE;
 
-  return CSR_ERR_INVALID;
+  struct HashElem *he = subset_create_he(sub, vid);
+  if (!he)
+    return CSR_ERR_CODE; /* LCOV_EXCL_LINE */
+
+  return cs_he_native_set(sub->cs, he, value, err);
 }
 
 /**
@@ -164,7 +454,10 @@ int cs_subset_reset(const struct ConfigSubset *sub, int vid, struct Buffer *err)
   if (!sub || (vid < 0) || (vid >= sub->num_vars))
     return CSR_ERR_CODE;
 
-  struct HashElem *he = sub->vars[vid];
+  /* A sparse Subset with no value of its own has nothing to reset */
+  struct HashElem *he = sub->vars ? sub->vars[vid] : NULL;
+  if (!he)
+    return CSR_SUCCESS;
 
   return cs_he_reset(sub->cs, he, err);
 }
@@ -177,7 +470,7 @@ int cs_subset_string_get(const struct ConfigSubset *sub, int vid, struct Buffer
   if (!sub || (vid < 0) || (vid >= sub->num_vars))
     return CSR_ERR_CODE;
 
-  struct HashElem *he = sub->vars[vid];
+  struct HashElem *he = subset_get_he(sub, vid);
 
   return cs_he_string_get(sub->cs, he, result);
 }
@@ -185,12 +478,14 @@ int cs_subset_string_get(const struct ConfigSubset *sub, int vid, struct Buffer
 /**
  * cs_subset_string_set - XXX
  */
-int cs_subset_string_set(const struct ConfigSubset *sub, int vid, const char *value, struct Buffer *err)
+int cs_subset_string_set(struct ConfigSubset *sub, int vid, const char *value, struct Buffer *err)
 {
   if (!sub || (vid < 0) || (vid >= sub->num_vars))
     return INT_MIN;
 
-  struct HashElem *he = sub->vars[vid];
+  struct HashElem *he = subset_create_he(sub, vid);
+  if (!he)
+    return CSR_ERR_CODE; /* LCOV_EXCL_LINE */
 
   return cs_he_string_set(sub->cs, he, value, err);
 }
@@ -23,6 +23,7 @@
 #ifndef MUTT_CONFIG_SUBSET_H
 #define MUTT_CONFIG_SUBSET_H
 
+#include <stdbool.h>
 #include <stdio.h>
 #include "set.h"
 
@@ -31,21 +32,25 @@
  */
 struct ConfigSubset
 {
-  char *scope;                ///< Scope name of Subset
-  const struct ConfigSet *cs; ///< Parent ConfigSet
-  size_t num_vars;            ///< Number of local config items
-  const char **var_names;     ///< Array of the names of local config items
-  struct HashElem **vars;     ///< Array of the HashElems of Subset config items
+  char *scope;                  ///< Scope name of Subset
+  const struct ConfigSet *cs;   ///< Parent ConfigSet
+  size_t num_vars;              ///< Number of local config items
+  const char **var_names;       ///< Array of the names of local config items
+  struct HashElem **vars;       ///< Array of the HashElems of Subset config items
+  const int *sorted;            ///< Value IDs, sorted by name, shared by Subsets with the same var_names
+  struct ConfigSubset *parent;  ///< Parent Subset (sparse Subsets only)
+  bool sparse;                  ///< Only create config items when they're set
 };
 
 struct ConfigSubset *cs_subset_new(const struct ConfigSet *cs, const char *name, const char *parent_name, const char *var_names[]);
+struct ConfigSubset *cs_subset_new_sparse(const struct ConfigSet *cs, const char *name, struct ConfigSubset *parent, const char *var_names[]);
 void                 cs_subset_free(struct ConfigSubset **sub);
-int                  cs_subset_lookup(struct ConfigSubset *sub, const char *name);
+int                  cs_subset_lookup(const struct ConfigSubset *sub, const char *name);
 
 intptr_t cs_subset_native_get(const struct ConfigSubset *sub, int vid,                    struct Buffer *err);
-int      cs_subset_native_set(const struct ConfigSubset *sub, int vid, intptr_t value,    struct Buffer *err);
+int      cs_subset_native_set(      struct ConfigSubset *sub, int vid, intptr_t value,    struct Buffer *err);
 int      cs_subset_reset     (const struct ConfigSubset *sub, int vid,                    struct Buffer *err);
 int      cs_subset_string_get(const struct ConfigSubset *sub, int vid,                    struct Buffer *result);
-int      cs_subset_string_set(const struct ConfigSubset *sub, int vid, const char *value, struct Buffer *err);
+int      cs_subset_string_set(      struct ConfigSubset *sub, int vid, const char *value, struct Buffer *err);
 
 #endif /* MUTT_CONFIG_SUBSET_H */
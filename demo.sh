@@ -5,7 +5,7 @@ _demo_complete()
     local cur
     _get_comp_words_by_ref cur
 
-    COMPREPLY=( $( compgen -W 'account address bool deep dump enum inherit initial long mbtable number quad regex set slist sort string synonym' -- "$cur" ) )
+    COMPREPLY=( $( compgen -W 'account address arena bench_inherit bench_regex bench_source bench_string bench_subset bench_validate bool complexity deep dump enum inherit initial intern long lookup mailbox mbtable number prefilter quad regex regexgroup set shared slist sort source string synonym' -- "$cur" ) )
 }
 
 complete -F _demo_complete demo
@@ -25,445 +25,913 @@
 
 #include <stdbool.h>
 
-extern bool            C_Allow8bit;
-extern bool            C_AllowAnsi;
-extern bool            C_ArrowCursor;
-extern bool            C_AsciiChars;
-extern bool            C_Askbcc;
-extern bool            C_Askcc;
-extern bool            C_AskFollowUp;
-extern bool            C_AskXCommentTo;
-extern bool            C_AttachSaveWithoutPrompting;
-extern bool            C_AttachSplit;
-extern bool            C_Autoedit;
-extern bool            C_AutoSubscribe;
-extern bool            C_AutoTag;
-extern bool            C_Beep;
-extern bool            C_BeepNew;
-extern bool            C_BounceDelivered;
-extern bool            C_BrailleFriendly;
-extern bool            C_BrowserAbbreviateMailboxes;
-extern bool            C_ChangeFolderNext;
-extern bool            C_CheckMboxSize;
-extern bool            C_CheckNew;
-extern bool            C_CollapseAll;
-extern bool            C_CollapseFlagged;
-extern bool            C_CollapseUnread;
-extern bool            C_Confirmappend;
-extern bool            C_Confirmcreate;
-extern bool            C_CryptAutoencrypt;
-extern bool            C_CryptAutopgp;
-extern bool            C_CryptAutosign;
-extern bool            C_CryptAutosmime;
-extern bool            C_CryptConfirmhook;
-extern bool            C_CryptOpportunisticEncrypt;
-extern bool            C_CryptProtectedHeadersRead;
-extern bool            C_CryptProtectedHeadersSave;
-extern bool            C_CryptProtectedHeadersWrite;
-extern bool            C_CryptReplyencrypt;
-extern bool            C_CryptReplysign;
-extern bool            C_CryptReplysignencrypted;
-extern bool            C_CryptTimestamp;
-extern bool            C_CryptUseGpgme;
-extern bool            C_CryptUsePka;
-extern bool            C_DeleteUntag;
-extern bool            C_DigestCollapse;
-extern bool            C_DuplicateThreads;
-extern bool            C_EditHeaders;
-extern bool            C_EncodeFrom;
-extern bool            C_FastReply;
-extern bool            C_FccClear;
-extern bool            C_FlagSafe;
-extern bool            C_FollowupTo;
-extern bool            C_ForceName;
-extern bool            C_ForwardDecode;
-extern bool            C_ForwardDecrypt;
-extern bool            C_ForwardQuote;
-extern bool            C_ForwardReferences;
-extern bool            C_Hdrs;
-extern bool            C_Header;
-extern bool            C_HeaderCacheCompress;
-extern bool            C_HeaderColorPartial;
-extern bool            C_Help;
-extern bool            C_HiddenHost;
-extern bool            C_HideLimited;
-extern bool            C_HideMissing;
-extern bool            C_HideThreadSubject;
-extern bool            C_HideTopLimited;
-extern bool            C_HideTopMissing;
-extern bool            C_HistoryRemoveDups;
-extern bool            C_HonorDisposition;
-extern bool            C_IdnDecode;
-extern bool            C_IdnEncode;
-extern bool            C_IgnoreLinearWhiteSpace;
-extern bool            C_IgnoreListReplyTo;
-extern bool            C_ImapCheckSubscribed;
-extern bool            C_ImapCondstore;
-extern bool            C_ImapIdle;
-extern bool            C_ImapListSubscribed;
-extern bool            C_ImapPassive;
-extern bool            C_ImapPeek;
-extern bool            C_ImapQresync;
-extern bool            C_ImapRfc5161;
-extern bool            C_ImapServernoise;
-extern bool            C_ImplicitAutoview;
-extern bool            C_IncludeEncrypted;
-extern bool            C_IncludeOnlyfirst;
-extern bool            C_KeepFlagged;
-extern bool            C_MailcapSanitize;
-extern bool            C_MailCheckRecent;
-extern bool            C_MailCheckStats;
-extern bool            C_MaildirCheckCur;
-extern bool            C_MaildirHeaderCacheVerify;
-extern bool            C_MaildirTrash;
-extern bool            C_Markers;
-extern bool            C_MarkOld;
-extern bool            C_MenuMoveOff;
-extern bool            C_MenuScroll;
-extern bool            C_MessageCacheClean;
-extern bool            C_MetaKey;
-extern bool            C_Metoo;
-extern bool            C_MhPurge;
-extern bool            C_MimeForwardDecode;
-extern bool            C_MimeSubject;
-extern bool            C_MimeTypeQueryFirst;
-extern bool            C_NarrowTree;
-extern bool            C_NmRecord;
-extern bool            C_NntpListgroup;
-extern bool            C_NntpLoadDescription;
-extern bool            C_PagerStop;
-extern bool            C_PgpAutoDecode;
-extern bool            C_PgpAutoinline;
-extern bool            C_PgpCheckExit;
-extern bool            C_PgpCheckGpgDecryptStatusFd;
-extern bool            C_PgpIgnoreSubkeys;
-extern bool            C_PgpLongIds;
-extern bool            C_PgpReplyinline;
-extern bool            C_PgpRetainableSigs;
-extern bool            C_PgpSelfEncrypt;
-extern bool            C_PgpShowUnusable;
-extern bool            C_PgpStrictEnc;
-extern bool            C_PgpUseGpgAgent;
-extern bool            C_PipeDecode;
-extern bool            C_PipeSplit;
-extern bool            C_PopAuthTryAll;
-extern bool            C_PopLast;
-extern bool            C_PostponeEncrypt;
-extern bool            C_PrintDecode;
-extern bool            C_PrintSplit;
-extern bool            C_PromptAfter;
-extern bool            C_ReadOnly;
-extern bool            C_ReflowSpaceQuotes;
-extern bool            C_ReflowText;
-extern bool            C_ReplySelf;
-extern bool            C_ReplyWithXorig;
-extern bool            C_Resolve;
-extern bool            C_ResumeDraftFiles;
-extern bool            C_ResumeEditedDraftFiles;
-extern bool            C_ReverseAlias;
-extern bool            C_ReverseName;
-extern bool            C_ReverseRealname;
-extern bool            C_Rfc2047Parameters;
-extern bool            C_SaveAddress;
-extern bool            C_SaveEmpty;
-extern bool            C_SaveName;
-extern bool            C_SaveUnsubscribed;
-extern bool            C_Score;
-extern bool            C_ShowNewNews;
-extern bool            C_ShowOnlyUnread;
-extern bool            C_SidebarFolderIndent;
-extern bool            C_SidebarNewMailOnly;
-extern bool            C_SidebarNextNewWrap;
-extern bool            C_SidebarNonEmptyMailboxOnly;
-extern bool            C_SidebarOnRight;
-extern bool            C_SidebarShortPath;
-extern bool            C_SidebarVisible;
-extern bool            C_SigDashes;
-extern bool            C_SigOnTop;
-extern bool            C_SmartWrap;
-extern bool            C_SmimeAskCertLabel;
-extern bool            C_SmimeDecryptUseDefaultKey;
-extern bool            C_SmimeIsDefault;
-extern bool            C_SmimeSelfEncrypt;
-extern bool            C_SortRe;
-extern bool            C_SslForceTls;
-extern bool            C_SslUseSslv2;
-extern bool            C_SslUseSslv3;
-extern bool            C_SslUsesystemcerts;
-extern bool            C_SslUseTlsv1;
-extern bool            C_SslUseTlsv11;
-extern bool            C_SslUseTlsv12;
-extern bool            C_SslVerifyDates;
-extern bool            C_SslVerifyHost;
-extern bool            C_SslVerifyPartialChains;
-extern bool            C_StatusOnTop;
-extern bool            C_StrictThreads;
-extern bool            C_Suspend;
-extern bool            C_TextFlowed;
-extern bool            C_ThoroughSearch;
-extern bool            C_ThreadReceived;
-extern bool            C_Tilde;
-extern bool            C_TsEnabled;
-extern bool            C_UncollapseJump;
-extern bool            C_UncollapseNew;
-extern bool            C_Use8bitmime;
-extern bool            C_UseDomain;
-extern bool            C_UseEnvelopeFrom;
-extern bool            C_UseFrom;
-extern bool            C_UseIpv6;
-extern bool            C_UserAgent;
-extern bool            C_VirtualSpoolfile;
-extern bool            C_WaitKey;
-extern bool            C_Weed;
-extern bool            C_WrapSearch;
-extern bool            C_WriteBcc;
-extern bool            C_XCommentTo;
-extern char *          C_AliasFile;
-extern char *          C_AliasFormat;
-extern char *          C_AssumedCharset;
-extern char *          C_AttachCharset;
-extern char *          C_AttachFormat;
-extern char *          C_AttachSaveDir;
-extern char *          C_AttachSep;
-extern char *          C_Attribution;
-extern char *          C_AttributionLocale;
-extern char *          C_CertificateFile;
-extern char *          C_Charset;
-extern char *          C_ComposeFormat;
-extern char *          C_ConfigCharset;
-extern char *          C_ContentType;
-extern char *          C_CryptProtectedHeadersSubject;
-extern char *          C_DateFormat;
-extern char *          C_DebugFile;
-extern char *          C_DefaultHook;
-extern char *          C_DisplayFilter;
-extern char *          C_DsnNotify;
-extern char *          C_DsnReturn;
-extern char *          C_Editor;
-extern char *          C_EmptySubject;
-extern char *          C_EntropyFile;
-extern char *          C_Escape;
-extern char *          C_ExternalSearchCommand;
-extern char *          C_Folder;
-extern char *          C_FolderFormat;
-extern char *          C_ForwardAttributionIntro;
-extern char *          C_ForwardAttributionTrailer;
-extern char *          C_ForwardFormat;
-extern char *          C_GroupIndexFormat;
-extern char *          C_HeaderCache;
-extern char *          C_HeaderCacheBackend;
-extern char *          C_HeaderCachePagesize;
-extern char *          C_HiddenTags;
-extern char *          C_HistoryFile;
-extern char *          C_Hostname;
-extern char *          C_ImapAuthenticators;
-extern char *          C_ImapDelimChars;
-extern char *          C_ImapHeaders;
-extern char *          C_ImapLogin;
-extern char *          C_ImapOauthRefreshCommand;
-extern char *          C_ImapPass;
-extern char *          C_ImapUser;
-extern char *          C_IndentString;
-extern char *          C_IndexFormat;
-extern char *          C_Inews;
-extern char *          C_Ispell;
-extern char *          C_MailcapPath;
-extern char *          C_MarkMacroPrefix;
-extern char *          C_Mbox;
-extern char *          C_MessageCachedir;
-extern char *          C_MessageFormat;
-extern char *          C_MhSeqFlagged;
-extern char *          C_MhSeqReplied;
-extern char *          C_MhSeqUnseen;
-extern char *          C_MimeTypeQueryCommand;
-extern char *          C_MixEntryFormat;
-extern char *          C_Mixmaster;
-extern char *          C_NewMailCommand;
-extern char *          C_NewsCacheDir;
-extern char *          C_NewsgroupsCharset;
-extern char *          C_Newsrc;
-extern char *          C_NewsServer;
-extern char *          C_NmDefaultUri;
-extern char *          C_NmExcludeTags;
-extern char *          C_NmFlaggedTag;
-extern char *          C_NmQueryType;
-extern char *          C_NmQueryWindowCurrentSearch;
-extern char *          C_NmQueryWindowTimebase;
-extern char *          C_NmRecordTags;
-extern char *          C_NmRepliedTag;
-extern char *          C_NmUnreadTag;
-extern char *          C_NntpAuthenticators;
-extern char *          C_NntpPass;
-extern char *          C_NntpUser;
-extern char *          C_Pager;
-extern char *          C_PagerFormat;
-extern char *          C_PgpClearsignCommand;
-extern char *          C_PgpDecodeCommand;
-extern char *          C_PgpDecryptCommand;
-extern char *          C_PgpDefaultKey;
-extern char *          C_PgpEncryptOnlyCommand;
-extern char *          C_PgpEncryptSignCommand;
-extern char *          C_PgpEntryFormat;
-extern char *          C_PgpExportCommand;
-extern char *          C_PgpGetkeysCommand;
-extern char *          C_PgpImportCommand;
-extern char *          C_PgpListPubringCommand;
-extern char *          C_PgpListSecringCommand;
-extern char *          C_PgpSignAs;
-extern char *          C_PgpSignCommand;
-extern char *          C_PgpVerifyCommand;
-extern char *          C_PgpVerifyKeyCommand;
-extern char *          C_PipeSep;
-extern char *          C_PopAuthenticators;
-extern char *          C_PopHost;
-extern char *          C_PopOauthRefreshCommand;
-extern char *          C_PopPass;
-extern char *          C_PopUser;
-extern char *          C_PostIndentString;
-extern char *          C_Postponed;
-extern char *          C_PostponeEncryptAs;
-extern char *          C_Preconnect;
-extern char *          C_PreferredLanguages;
-extern char *          C_PrintCommand;
-extern char *          C_QueryCommand;
-extern char *          C_QueryFormat;
-extern char *          C_Realname;
-extern char *          C_Record;
-extern char *          C_SendCharset;
-extern char *          C_Sendmail;
-extern char *          C_Shell;
-extern char *          C_ShowMultipartAlternative;
-extern char *          C_SidebarDelimChars;
-extern char *          C_SidebarDividerChar;
-extern char *          C_SidebarFormat;
-extern char *          C_SidebarIndentString;
-extern char *          C_Signature;
-extern char *          C_SimpleSearch;
-extern char *          C_SmimeCaLocation;
-extern char *          C_SmimeCertificates;
-extern char *          C_SmimeDecryptCommand;
-extern char *          C_SmimeDefaultKey;
-extern char *          C_SmimeEncryptCommand;
-extern char *          C_SmimeEncryptWith;
-extern char *          C_SmimeGetCertCommand;
-extern char *          C_SmimeGetCertEmailCommand;
-extern char *          C_SmimeGetSignerCertCommand;
-extern char *          C_SmimeImportCertCommand;
-extern char *          C_SmimeKeys;
-extern char *          C_SmimePk7outCommand;
-extern char *          C_SmimeSignAs;
-extern char *          C_SmimeSignCommand;
-extern char *          C_SmimeSignDigestAlg;
-extern char *          C_SmimeVerifyCommand;
-extern char *          C_SmimeVerifyOpaqueCommand;
-extern char *          C_SmtpAuthenticators;
-extern char *          C_SmtpOauthRefreshCommand;
-extern char *          C_SmtpPass;
-extern char *          C_SmtpUrl;
-extern char *          C_SpamSeparator;
-extern char *          C_Spoolfile;
-extern char *          C_SslCaCertificatesFile;
-extern char *          C_SslCiphers;
-extern char *          C_SslClientCert;
-extern char *          C_StatusFormat;
-extern char *          C_Tmpdir;
-extern char *          C_Trash;
-extern char *          C_TsIconFormat;
-extern char *          C_TsStatusFormat;
-extern char *          C_Tunnel;
-extern char *          C_VfolderFormat;
-extern char *          C_Visual;
-extern long            C_ImapFetchChunkSize;
-extern long            C_PgpTimeout;
-extern short           C_ConnectTimeout;
-extern short           C_DebugLevel;
-extern short           C_History;
-extern short           C_ImapKeepalive;
-extern short           C_ImapPipelineDepth;
-extern short           C_ImapPollTimeout;
-extern short           C_MailCheck;
-extern short           C_MailCheckStatsInterval;
-extern short           C_MboxType;
-extern short           C_MenuContext;
-extern short           C_NetInc;
-extern short           C_NmDbLimit;
-extern short           C_NmOpenTimeout;
-extern short           C_NmQueryWindowCurrentPosition;
-extern short           C_NmQueryWindowDuration;
-extern short           C_NntpContext;
-extern short           C_NntpPoll;
-extern short           C_PagerContext;
-extern short           C_PagerIndexLines;
-extern short           C_PgpSortKeys;
-extern short           C_PopCheckinterval;
-extern short           C_ReadInc;
-extern short           C_ReflowWrap;
-extern short           C_SaveHistory;
-extern short           C_ScoreThresholdDelete;
-extern short           C_ScoreThresholdFlag;
-extern short           C_ScoreThresholdRead;
-extern short           C_SearchContext;
-extern short           C_SendmailWait;
-extern short           C_SidebarComponentDepth;
-extern short           C_SidebarSortMethod;
-extern short           C_SidebarWidth;
-extern short           C_SkipQuotedOffset;
-extern short           C_SleepTime;
-extern short           C_SmimeTimeout;
-extern short           C_Sort;
-extern short           C_SortAlias;
-extern short           C_SortAux;
-extern short           C_SortBrowser;
-extern short           C_SslMinDhPrimeBits;
-extern short           C_TimeInc;
-extern short           C_Timeout;
-extern short           C_Wrap;
-extern short           C_WrapHeaders;
-extern short           C_WriteInc;
-extern struct Address *C_EnvelopeFromAddress;
-extern struct Address *C_From;
-extern struct MbTable *C_CryptChars;
-extern struct MbTable *C_FlagChars;
-extern struct MbTable *C_FromChars;
-extern struct MbTable *C_StatusChars;
-extern struct MbTable *C_ToChars;
-extern struct Regex *  C_AbortNoattachRegex;
-extern struct Regex *  C_GecosMask;
-extern struct Regex *  C_Mask;
-extern struct Regex *  C_PgpDecryptionOkay;
-extern struct Regex *  C_PgpGoodSign;
-extern struct Regex *  C_QuoteRegex;
-extern struct Regex *  C_ReplyRegex;
-extern struct Regex *  C_Smileys;
-extern unsigned char   C_AbortNoattach;
-extern unsigned char   C_AbortNosubject;
-extern unsigned char   C_AbortUnmodified;
-extern unsigned char   C_Bounce;
-extern unsigned char   C_CatchupNewsgroup;
-extern unsigned char   C_Copy;
-extern unsigned char   C_CryptVerifySig;
-extern unsigned char   C_Delete;
-extern unsigned char   C_FccAttach;
-extern unsigned char   C_FollowupToPoster;
-extern unsigned char   C_ForwardAttachments;
-extern unsigned char   C_ForwardEdit;
-extern unsigned char   C_HonorFollowupTo;
-extern unsigned char   C_Include;
-extern unsigned char   C_MimeForward;
-extern unsigned char   C_MimeForwardRest;
-extern unsigned char   C_Move;
-extern unsigned char   C_PgpEncryptSelf;
-extern unsigned char   C_PgpMimeAuto;
-extern unsigned char   C_PopDelete;
-extern unsigned char   C_PopReconnect;
-extern unsigned char   C_PostModerated;
-extern unsigned char   C_Postpone;
-extern unsigned char   C_Print;
-extern unsigned char   C_Quit;
-extern unsigned char   C_Recall;
-extern unsigned char   C_ReplyTo;
-extern unsigned char   C_SmimeEncryptSelf;
-extern unsigned char   C_SslStarttls;
+struct Address;
+struct MbTable;
+struct Regex;
+
+#define CONFIG_CACHE_LINE 64 ///< Size of a CPU cache line
+
+/**
+ * struct ConfigVars - Storage for the config variables
+ *
+ * The variables are kept together, so the ones used at the same time share
+ * cache lines, rather than being scattered by the linker.  Each group starts
+ * on a new cache line.  Within a group, the largest types come first, to
+ * avoid padding.
+ *
+ * The C_* names are kept, as macros.
+ */
+struct ConfigVars
+{
+  /* Hot: read while drawing the index, pager, sidebar and status bar */
+  char           *Charset __attribute__((aligned(CONFIG_CACHE_LINE)));
+  struct MbTable *CryptChars;
+  char           *DateFormat;
+  struct MbTable *FlagChars;
+  struct MbTable *FromChars;
+  char           *HiddenTags;
+  char           *IndexFormat;
+  char           *PagerFormat;
+  struct Regex   *QuoteRegex;
+  char           *SidebarDelimChars;
+  char           *SidebarDividerChar;
+  char           *SidebarFormat;
+  char           *SidebarIndentString;
+  struct Regex   *Smileys;
+  struct MbTable *StatusChars;
+  char           *StatusFormat;
+  struct MbTable *ToChars;
+  char           *TsIconFormat;
+  char           *TsStatusFormat;
+  short           MenuContext;
+  short           PagerContext;
+  short           PagerIndexLines;
+  short           ReflowWrap;
+  short           SidebarComponentDepth;
+  short           SidebarWidth;
+  short           SkipQuotedOffset;
+  short           Wrap;
+  bool            AllowAnsi;
+  bool            ArrowCursor;
+  bool            AsciiChars;
+  bool            BrailleFriendly;
+  bool            HeaderColorPartial;
+  bool            Help;
+  bool            HideLimited;
+  bool            HideMissing;
+  bool            HideTopLimited;
+  bool            HideTopMissing;
+  bool            Markers;
+  bool            MenuMoveOff;
+  bool            MenuScroll;
+  bool            NarrowTree;
+  bool            PagerStop;
+  bool            ReflowSpaceQuotes;
+  bool            ReflowText;
+  bool            SidebarFolderIndent;
+  bool            SidebarNewMailOnly;
+  bool            SidebarNonEmptyMailboxOnly;
+  bool            SidebarOnRight;
+  bool            SidebarShortPath;
+  bool            SidebarVisible;
+  bool            SmartWrap;
+  bool            StatusOnTop;
+  bool            Tilde;
+  bool            TsEnabled;
+  bool            Weed;
+
+  /* Warm: read while sorting and threading the index */
+  struct Regex   *ReplyRegex __attribute__((aligned(CONFIG_CACHE_LINE)));
+  short           PgpSortKeys;
+  short           ScoreThresholdDelete;
+  short           ScoreThresholdFlag;
+  short           ScoreThresholdRead;
+  short           SidebarSortMethod;
+  short           Sort;
+  short           SortAlias;
+  short           SortAux;
+  short           SortBrowser;
+  bool            CollapseAll;
+  bool            CollapseFlagged;
+  bool            CollapseUnread;
+  bool            DuplicateThreads;
+  bool            HideThreadSubject;
+  bool            Score;
+  bool            SortRe;
+  bool            StrictThreads;
+  bool            ThreadReceived;
+  bool            UncollapseJump;
+  bool            UncollapseNew;
+
+  /* Cold: read while sending, by the crypto backends, or at startup */
+  struct Regex   *AbortNoattachRegex __attribute__((aligned(CONFIG_CACHE_LINE)));
+  char           *AliasFile;
+  char           *AliasFormat;
+  char           *AssumedCharset;
+  char           *AttachCharset;
+  char           *AttachFormat;
+  char           *AttachSaveDir;
+  char           *AttachSep;
+  char           *Attribution;
+  char           *AttributionLocale;
+  char           *CertificateFile;
+  char           *ComposeFormat;
+  char           *ConfigCharset;
+  char           *ContentType;
+  char           *CryptProtectedHeadersSubject;
+  char           *DebugFile;
+  char           *DefaultHook;
+  char           *DisplayFilter;
+  char           *DsnNotify;
+  char           *DsnReturn;
+  char           *Editor;
+  char           *EmptySubject;
+  char           *EntropyFile;
+  struct Address *EnvelopeFromAddress;
+  char           *Escape;
+  char           *ExternalSearchCommand;
+  char           *Folder;
+  char           *FolderFormat;
+  char           *ForwardAttributionIntro;
+  char           *ForwardAttributionTrailer;
+  char           *ForwardFormat;
+  struct Address *From;
+  struct Regex   *GecosMask;
+  char           *GroupIndexFormat;
+  char           *HeaderCache;
+  char           *HeaderCacheBackend;
+  char           *HeaderCachePagesize;
+  char           *HistoryFile;
+  char           *Hostname;
+  char           *ImapAuthenticators;
+  char           *ImapDelimChars;
+  char           *ImapHeaders;
+  char           *ImapLogin;
+  char           *ImapOauthRefreshCommand;
+  char           *ImapPass;
+  char           *ImapUser;
+  char           *IndentString;
+  char           *Inews;
+  char           *Ispell;
+  char           *MailcapPath;
+  char           *MarkMacroPrefix;
+  struct Regex   *Mask;
+  char           *Mbox;
+  char           *MessageCachedir;
+  char           *MessageFormat;
+  char           *MhSeqFlagged;
+  char           *MhSeqReplied;
+  char           *MhSeqUnseen;
+  char           *MimeTypeQueryCommand;
+  char           *MixEntryFormat;
+  char           *Mixmaster;
+  char           *NewMailCommand;
+  char           *NewsCacheDir;
+  char           *NewsgroupsCharset;
+  char           *Newsrc;
+  char           *NewsServer;
+  char           *NmDefaultUri;
+  char           *NmExcludeTags;
+  char           *NmFlaggedTag;
+  char           *NmQueryType;
+  char           *NmQueryWindowCurrentSearch;
+  char           *NmQueryWindowTimebase;
+  char           *NmRecordTags;
+  char           *NmRepliedTag;
+  char           *NmUnreadTag;
+  char           *NntpAuthenticators;
+  char           *NntpPass;
+  char           *NntpUser;
+  char           *Pager;
+  char           *PgpClearsignCommand;
+  char           *PgpDecodeCommand;
+  char           *PgpDecryptCommand;
+  struct Regex   *PgpDecryptionOkay;
+  char           *PgpDefaultKey;
+  char           *PgpEncryptOnlyCommand;
+  char           *PgpEncryptSignCommand;
+  char           *PgpEntryFormat;
+  char           *PgpExportCommand;
+  char           *PgpGetkeysCommand;
+  struct Regex   *PgpGoodSign;
+  char           *PgpImportCommand;
+  char           *PgpListPubringCommand;
+  char           *PgpListSecringCommand;
+  char           *PgpSignAs;
+  char           *PgpSignCommand;
+  char           *PgpVerifyCommand;
+  char           *PgpVerifyKeyCommand;
+  char           *PipeSep;
+  char           *PopAuthenticators;
+  char           *PopHost;
+  char           *PopOauthRefreshCommand;
+  char           *PopPass;
+  char           *PopUser;
+  char           *PostIndentString;
+  char           *Postponed;
+  char           *PostponeEncryptAs;
+  char           *Preconnect;
+  char           *PreferredLanguages;
+  char           *PrintCommand;
+  char           *QueryCommand;
+  char           *QueryFormat;
+  char           *Realname;
+  char           *Record;
+  char           *SendCharset;
+  char           *Sendmail;
+  char           *Shell;
+  char           *ShowMultipartAlternative;
+  char           *Signature;
+  char           *SimpleSearch;
+  char           *SmimeCaLocation;
+  char           *SmimeCertificates;
+  char           *SmimeDecryptCommand;
+  char           *SmimeDefaultKey;
+  char           *SmimeEncryptCommand;
+  char           *SmimeEncryptWith;
+  char           *SmimeGetCertCommand;
+  char           *SmimeGetCertEmailCommand;
+  char           *SmimeGetSignerCertCommand;
+  char           *SmimeImportCertCommand;
+  char           *SmimeKeys;
+  char           *SmimePk7outCommand;
+  char           *SmimeSignAs;
+  char           *SmimeSignCommand;
+  char           *SmimeSignDigestAlg;
+  char           *SmimeVerifyCommand;
+  char           *SmimeVerifyOpaqueCommand;
+  char           *SmtpAuthenticators;
+  char           *SmtpOauthRefreshCommand;
+  char           *SmtpPass;
+  char           *SmtpUrl;
+  char           *SpamSeparator;
+  char           *Spoolfile;
+  char           *SslCaCertificatesFile;
+  char           *SslCiphers;
+  char           *SslClientCert;
+  char           *Tmpdir;
+  char           *Trash;
+  char           *Tunnel;
+  char           *VfolderFormat;
+  char           *Visual;
+  long            ImapFetchChunkSize;
+  long            PgpTimeout;
+  short           ConnectTimeout;
+  short           DebugLevel;
+  short           History;
+  short           ImapKeepalive;
+  short           ImapPipelineDepth;
+  short           ImapPollTimeout;
+  short           MailCheck;
+  short           MailCheckStatsInterval;
+  short           MboxType;
+  short           NetInc;
+  short           NmDbLimit;
+  short           NmOpenTimeout;
+  short           NmQueryWindowCurrentPosition;
+  short           NmQueryWindowDuration;
+  short           NntpContext;
+  short           NntpPoll;
+  short           PopCheckinterval;
+  short           ReadInc;
+  short           SaveHistory;
+  short           SearchContext;
+  short           SendmailWait;
+  short           SleepTime;
+  short           SmimeTimeout;
+  short           SslMinDhPrimeBits;
+  short           TimeInc;
+  short           Timeout;
+  short           WrapHeaders;
+  short           WriteInc;
+  unsigned char   AbortNoattach;
+  unsigned char   AbortNosubject;
+  unsigned char   AbortUnmodified;
+  unsigned char   Bounce;
+  unsigned char   CatchupNewsgroup;
+  unsigned char   Copy;
+  unsigned char   CryptVerifySig;
+  unsigned char   Delete;
+  unsigned char   FccAttach;
+  unsigned char   FollowupToPoster;
+  unsigned char   ForwardAttachments;
+  unsigned char   ForwardEdit;
+  unsigned char   HonorFollowupTo;
+  unsigned char   Include;
+  unsigned char   MimeForward;
+  unsigned char   MimeForwardRest;
+  unsigned char   Move;
+  unsigned char   PgpEncryptSelf;
+  unsigned char   PgpMimeAuto;
+  unsigned char   PopDelete;
+  unsigned char   PopReconnect;
+  unsigned char   PostModerated;
+  unsigned char   Postpone;
+  unsigned char   Print;
+  unsigned char   Quit;
+  unsigned char   Recall;
+  unsigned char   ReplyTo;
+  unsigned char   SmimeEncryptSelf;
+  unsigned char   SslStarttls;
+  bool            Allow8bit;
+  bool            Askbcc;
+  bool            Askcc;
+  bool            AskFollowUp;
+  bool            AskXCommentTo;
+  bool            AttachSaveWithoutPrompting;
+  bool            AttachSplit;
+  bool            Autoedit;
+  bool            AutoSubscribe;
+  bool            AutoTag;
+  bool            Beep;
+  bool            BeepNew;
+  bool            BounceDelivered;
+  bool            BrowserAbbreviateMailboxes;
+  bool            ChangeFolderNext;
+  bool            CheckMboxSize;
+  bool            CheckNew;
+  bool            Confirmappend;
+  bool            Confirmcreate;
+  bool            CryptAutoencrypt;
+  bool            CryptAutopgp;
+  bool            CryptAutosign;
+  bool            CryptAutosmime;
+  bool            CryptConfirmhook;
+  bool            CryptOpportunisticEncrypt;
+  bool            CryptProtectedHeadersRead;
+  bool            CryptProtectedHeadersSave;
+  bool            CryptProtectedHeadersWrite;
+  bool            CryptReplyencrypt;
+  bool            CryptReplysign;
+  bool            CryptReplysignencrypted;
+  bool            CryptTimestamp;
+  bool            CryptUseGpgme;
+  bool            CryptUsePka;
+  bool            DeleteUntag;
+  bool            DigestCollapse;
+  bool            EditHeaders;
+  bool            EncodeFrom;
+  bool            FastReply;
+  bool            FccClear;
+  bool            FlagSafe;
+  bool            FollowupTo;
+  bool            ForceName;
+  bool            ForwardDecode;
+  bool            ForwardDecrypt;
+  bool            ForwardQuote;
+  bool            ForwardReferences;
+  bool            Hdrs;
+  bool            Header;
+  bool            HeaderCacheCompress;
+  bool            HiddenHost;
+  bool            HistoryRemoveDups;
+  bool            HonorDisposition;
+  bool            IdnDecode;
+  bool            IdnEncode;
+  bool            IgnoreLinearWhiteSpace;
+  bool            IgnoreListReplyTo;
+  bool            ImapCheckSubscribed;
+  bool            ImapCondstore;
+  bool            ImapIdle;
+  bool            ImapListSubscribed;
+  bool            ImapPassive;
+  bool            ImapPeek;
+  bool            ImapQresync;
+  bool            ImapRfc5161;
+  bool            ImapServernoise;
+  bool            ImplicitAutoview;
+  bool            IncludeEncrypted;
+  bool            IncludeOnlyfirst;
+  bool            KeepFlagged;
+  bool            MailcapSanitize;
+  bool            MailCheckRecent;
+  bool            MailCheckStats;
+  bool            MaildirCheckCur;
+  bool            MaildirHeaderCacheVerify;
+  bool            MaildirTrash;
+  bool            MarkOld;
+  bool            MessageCacheClean;
+  bool            MetaKey;
+  bool            Metoo;
+  bool            MhPurge;
+  bool            MimeForwardDecode;
+  bool            MimeSubject;
+  bool            MimeTypeQueryFirst;
+  bool            NmRecord;
+  bool            NntpListgroup;
+  bool            NntpLoadDescription;
+  bool            PgpAutoDecode;
+  bool            PgpAutoinline;
+  bool            PgpCheckExit;
+  bool            PgpCheckGpgDecryptStatusFd;
+  bool            PgpIgnoreSubkeys;
+  bool            PgpLongIds;
+  bool            PgpReplyinline;
+  bool            PgpRetainableSigs;
+  bool            PgpSelfEncrypt;
+  bool            PgpShowUnusable;
+  bool            PgpStrictEnc;
+  bool            PgpUseGpgAgent;
+  bool            PipeDecode;
+  bool            PipeSplit;
+  bool            PopAuthTryAll;
+  bool            PopLast;
+  bool            PostponeEncrypt;
+  bool            PrintDecode;
+  bool            PrintSplit;
+  bool            PromptAfter;
+  bool            ReadOnly;
+  bool            ReplySelf;
+  bool            ReplyWithXorig;
+  bool            Resolve;
+  bool            ResumeDraftFiles;
+  bool            ResumeEditedDraftFiles;
+  bool            ReverseAlias;
+  bool            ReverseName;
+  bool            ReverseRealname;
+  bool            Rfc2047Parameters;
+  bool            SaveAddress;
+  bool            SaveEmpty;
+  bool            SaveName;
+  bool            SaveUnsubscribed;
+  bool            ShowNewNews;
+  bool            ShowOnlyUnread;
+  bool            SidebarNextNewWrap;
+  bool            SigDashes;
+  bool            SigOnTop;
+  bool            SmimeAskCertLabel;
+  bool            SmimeDecryptUseDefaultKey;
+  bool            SmimeIsDefault;
+  bool            SmimeSelfEncrypt;
+  bool            SslForceTls;
+  bool            SslUseSslv2;
+  bool            SslUseSslv3;
+  bool            SslUsesystemcerts;
+  bool            SslUseTlsv1;
+  bool            SslUseTlsv11;
+  bool            SslUseTlsv12;
+  bool            SslVerifyDates;
+  bool            SslVerifyHost;
+  bool            SslVerifyPartialChains;
+  bool            Suspend;
+  bool            TextFlowed;
+  bool            ThoroughSearch;
+  bool            Use8bitmime;
+  bool            UseDomain;
+  bool            UseEnvelopeFrom;
+  bool            UseFrom;
+  bool            UseIpv6;
+  bool            UserAgent;
+  bool            VirtualSpoolfile;
+  bool            WaitKey;
+  bool            WrapSearch;
+  bool            WriteBcc;
+  bool            XCommentTo;
+};
+
+extern struct ConfigVars CVars;
+
+// clang-format off
+#define C_AbortNoattach                (CVars.AbortNoattach)
+#define C_AbortNoattachRegex           (CVars.AbortNoattachRegex)
+#define C_AbortNosubject               (CVars.AbortNosubject)
+#define C_AbortUnmodified              (CVars.AbortUnmodified)
+#define C_AliasFile                    (CVars.AliasFile)
+#define C_AliasFormat                  (CVars.AliasFormat)
+#define C_Allow8bit                    (CVars.Allow8bit)
+#define C_AllowAnsi                    (CVars.AllowAnsi)
+#define C_ArrowCursor                  (CVars.ArrowCursor)
+#define C_AsciiChars                   (CVars.AsciiChars)
+#define C_Askbcc                       (CVars.Askbcc)
+#define C_Askcc                        (CVars.Askcc)
+#define C_AskFollowUp                  (CVars.AskFollowUp)
+#define C_AskXCommentTo                (CVars.AskXCommentTo)
+#define C_AssumedCharset               (CVars.AssumedCharset)
+#define C_AttachCharset                (CVars.AttachCharset)
+#define C_AttachFormat                 (CVars.AttachFormat)
+#define C_AttachSaveDir                (CVars.AttachSaveDir)
+#define C_AttachSaveWithoutPrompting   (CVars.AttachSaveWithoutPrompting)
+#define C_AttachSep                    (CVars.AttachSep)
+#define C_AttachSplit                  (CVars.AttachSplit)
+#define C_Attribution                  (CVars.Attribution)
+#define C_AttributionLocale            (CVars.AttributionLocale)
+#define C_Autoedit                     (CVars.Autoedit)
+#define C_AutoSubscribe                (CVars.AutoSubscribe)
+#define C_AutoTag                      (CVars.AutoTag)
+#define C_Beep                         (CVars.Beep)
+#define C_BeepNew                      (CVars.BeepNew)
+#define C_Bounce                       (CVars.Bounce)
+#define C_BounceDelivered              (CVars.BounceDelivered)
+#define C_BrailleFriendly              (CVars.BrailleFriendly)
+#define C_BrowserAbbreviateMailboxes   (CVars.BrowserAbbreviateMailboxes)
+#define C_CatchupNewsgroup             (CVars.CatchupNewsgroup)
+#define C_CertificateFile              (CVars.CertificateFile)
+#define C_ChangeFolderNext             (CVars.ChangeFolderNext)
+#define C_Charset                      (CVars.Charset)
+#define C_CheckMboxSize                (CVars.CheckMboxSize)
+#define C_CheckNew                     (CVars.CheckNew)
+#define C_CollapseAll                  (CVars.CollapseAll)
+#define C_CollapseFlagged              (CVars.CollapseFlagged)
+#define C_CollapseUnread               (CVars.CollapseUnread)
+#define C_ComposeFormat                (CVars.ComposeFormat)
+#define C_ConfigCharset                (CVars.ConfigCharset)
+#define C_Confirmappend                (CVars.Confirmappend)
+#define C_Confirmcreate                (CVars.Confirmcreate)
+#define C_ConnectTimeout               (CVars.ConnectTimeout)
+#define C_ContentType                  (CVars.ContentType)
+#define C_Copy                         (CVars.Copy)
+#define C_CryptAutoencrypt             (CVars.CryptAutoencrypt)
+#define C_CryptAutopgp                 (CVars.CryptAutopgp)
+#define C_CryptAutosign                (CVars.CryptAutosign)
+#define C_CryptAutosmime               (CVars.CryptAutosmime)
+#define C_CryptChars                   (CVars.CryptChars)
+#define C_CryptConfirmhook             (CVars.CryptConfirmhook)
+#define C_CryptOpportunisticEncrypt    (CVars.CryptOpportunisticEncrypt)
+#define C_CryptProtectedHeadersRead    (CVars.CryptProtectedHeadersRead)
+#define C_CryptProtectedHeadersSave    (CVars.CryptProtectedHeadersSave)
+#define C_CryptProtectedHeadersSubject (CVars.CryptProtectedHeadersSubject)
+#define C_CryptProtectedHeadersWrite   (CVars.CryptProtectedHeadersWrite)
+#define C_CryptReplyencrypt            (CVars.CryptReplyencrypt)
+#define C_CryptReplysign               (CVars.CryptReplysign)
+#define C_CryptReplysignencrypted      (CVars.CryptReplysignencrypted)
+#define C_CryptTimestamp               (CVars.CryptTimestamp)
+#define C_CryptUseGpgme                (CVars.CryptUseGpgme)
+#define C_CryptUsePka                  (CVars.CryptUsePka)
+#define C_CryptVerifySig               (CVars.CryptVerifySig)
+#define C_DateFormat                   (CVars.DateFormat)
+#define C_DebugFile                    (CVars.DebugFile)
+#define C_DebugLevel                   (CVars.DebugLevel)
+#define C_DefaultHook                  (CVars.DefaultHook)
+#define C_Delete                       (CVars.Delete)
+#define C_DeleteUntag                  (CVars.DeleteUntag)
+#define C_DigestCollapse               (CVars.DigestCollapse)
+#define C_DisplayFilter                (CVars.DisplayFilter)
+#define C_DsnNotify                    (CVars.DsnNotify)
+#define C_DsnReturn                    (CVars.DsnReturn)
+#define C_DuplicateThreads             (CVars.DuplicateThreads)
+#define C_EditHeaders                  (CVars.EditHeaders)
+#define C_Editor                       (CVars.Editor)
+#define C_EmptySubject                 (CVars.EmptySubject)
+#define C_EncodeFrom                   (CVars.EncodeFrom)
+#define C_EntropyFile                  (CVars.EntropyFile)
+#define C_EnvelopeFromAddress          (CVars.EnvelopeFromAddress)
+#define C_Escape                       (CVars.Escape)
+#define C_ExternalSearchCommand        (CVars.ExternalSearchCommand)
+#define C_FastReply                    (CVars.FastReply)
+#define C_FccAttach                    (CVars.FccAttach)
+#define C_FccClear                     (CVars.FccClear)
+#define C_FlagChars                    (CVars.FlagChars)
+#define C_FlagSafe                     (CVars.FlagSafe)
+#define C_Folder                       (CVars.Folder)
+#define C_FolderFormat                 (CVars.FolderFormat)
+#define C_FollowupTo                   (CVars.FollowupTo)
+#define C_FollowupToPoster             (CVars.FollowupToPoster)
+#define C_ForceName                    (CVars.ForceName)
+#define C_ForwardAttachments           (CVars.ForwardAttachments)
+#define C_ForwardAttributionIntro      (CVars.ForwardAttributionIntro)
+#define C_ForwardAttributionTrailer    (CVars.ForwardAttributionTrailer)
+#define C_ForwardDecode                (CVars.ForwardDecode)
+#define C_ForwardDecrypt               (CVars.ForwardDecrypt)
+#define C_ForwardEdit                  (CVars.ForwardEdit)
+#define C_ForwardFormat                (CVars.ForwardFormat)
+#define C_ForwardQuote                 (CVars.ForwardQuote)
+#define C_ForwardReferences            (CVars.ForwardReferences)
+#define C_From                         (CVars.From)
+#define C_FromChars                    (CVars.FromChars)
+#define C_GecosMask                    (CVars.GecosMask)
+#define C_GroupIndexFormat             (CVars.GroupIndexFormat)
+#define C_Hdrs                         (CVars.Hdrs)
+#define C_Header                       (CVars.Header)
+#define C_HeaderCache                  (CVars.HeaderCache)
+#define C_HeaderCacheBackend           (CVars.HeaderCacheBackend)
+#define C_HeaderCacheCompress          (CVars.HeaderCacheCompress)
+#define C_HeaderCachePagesize          (CVars.HeaderCachePagesize)
+#define C_HeaderColorPartial           (CVars.HeaderColorPartial)
+#define C_Help                         (CVars.Help)
+#define C_HiddenHost                   (CVars.HiddenHost)
+#define C_HiddenTags                   (CVars.HiddenTags)
+#define C_HideLimited                  (CVars.HideLimited)
+#define C_HideMissing                  (CVars.HideMissing)
+#define C_HideThreadSubject            (CVars.HideThreadSubject)
+#define C_HideTopLimited               (CVars.HideTopLimited)
+#define C_HideTopMissing               (CVars.HideTopMissing)
+#define C_History                      (CVars.History)
+#define C_HistoryFile                  (CVars.HistoryFile)
+#define C_HistoryRemoveDups            (CVars.HistoryRemoveDups)
+#define C_HonorDisposition             (CVars.HonorDisposition)
+#define C_HonorFollowupTo              (CVars.HonorFollowupTo)
+#define C_Hostname                     (CVars.Hostname)
+#define C_IdnDecode                    (CVars.IdnDecode)
+#define C_IdnEncode                    (CVars.IdnEncode)
+#define C_IgnoreLinearWhiteSpace       (CVars.IgnoreLinearWhiteSpace)
+#define C_IgnoreListReplyTo            (CVars.IgnoreListReplyTo)
+#define C_ImapAuthenticators           (CVars.ImapAuthenticators)
+#define C_ImapCheckSubscribed          (CVars.ImapCheckSubscribed)
+#define C_ImapCondstore                (CVars.ImapCondstore)
+#define C_ImapDelimChars               (CVars.ImapDelimChars)
+#define C_ImapFetchChunkSize           (CVars.ImapFetchChunkSize)
+#define C_ImapHeaders                  (CVars.ImapHeaders)
+#define C_ImapIdle                     (CVars.ImapIdle)
+#define C_ImapKeepalive                (CVars.ImapKeepalive)
+#define C_ImapListSubscribed           (CVars.ImapListSubscribed)
+#define C_ImapLogin                    (CVars.ImapLogin)
+#define C_ImapOauthRefreshCommand      (CVars.ImapOauthRefreshCommand)
+#define C_ImapPass                     (CVars.ImapPass)
+#define C_ImapPassive                  (CVars.ImapPassive)
+#define C_ImapPeek                     (CVars.ImapPeek)
+#define C_ImapPipelineDepth            (CVars.ImapPipelineDepth)
+#define C_ImapPollTimeout              (CVars.ImapPollTimeout)
+#define C_ImapQresync                  (CVars.ImapQresync)
+#define C_ImapRfc5161                  (CVars.ImapRfc5161)
+#define C_ImapServernoise              (CVars.ImapServernoise)
+#define C_ImapUser                     (CVars.ImapUser)
+#define C_ImplicitAutoview             (CVars.ImplicitAutoview)
+#define C_Include                      (CVars.Include)
+#define C_IncludeEncrypted             (CVars.IncludeEncrypted)
+#define C_IncludeOnlyfirst             (CVars.IncludeOnlyfirst)
+#define C_IndentString                 (CVars.IndentString)
+#define C_IndexFormat                  (CVars.IndexFormat)
+#define C_Inews                        (CVars.Inews)
+#define C_Ispell                       (CVars.Ispell)
+#define C_KeepFlagged                  (CVars.KeepFlagged)
+#define C_MailcapPath                  (CVars.MailcapPath)
+#define C_MailcapSanitize              (CVars.MailcapSanitize)
+#define C_MailCheck                    (CVars.MailCheck)
+#define C_MailCheckRecent              (CVars.MailCheckRecent)
+#define C_MailCheckStats               (CVars.MailCheckStats)
+#define C_MailCheckStatsInterval       (CVars.MailCheckStatsInterval)
+#define C_MaildirCheckCur              (CVars.MaildirCheckCur)
+#define C_MaildirHeaderCacheVerify     (CVars.MaildirHeaderCacheVerify)
+#define C_MaildirTrash                 (CVars.MaildirTrash)
+#define C_Markers                      (CVars.Markers)
+#define C_MarkMacroPrefix              (CVars.MarkMacroPrefix)
+#define C_MarkOld                      (CVars.MarkOld)
+#define C_Mask                         (CVars.Mask)
+#define C_Mbox                         (CVars.Mbox)
+#define C_MboxType                     (CVars.MboxType)
+#define C_MenuContext                  (CVars.MenuContext)
+#define C_MenuMoveOff                  (CVars.MenuMoveOff)
+#define C_MenuScroll                   (CVars.MenuScroll)
+#define C_MessageCacheClean            (CVars.MessageCacheClean)
+#define C_MessageCachedir              (CVars.MessageCachedir)
+#define C_MessageFormat                (CVars.MessageFormat)
+#define C_MetaKey                      (CVars.MetaKey)
+#define C_Metoo                        (CVars.Metoo)
+#define C_MhPurge                      (CVars.MhPurge)
+#define C_MhSeqFlagged                 (CVars.MhSeqFlagged)
+#define C_MhSeqReplied                 (CVars.MhSeqReplied)
+#define C_MhSeqUnseen                  (CVars.MhSeqUnseen)
+#define C_MimeForward                  (CVars.MimeForward)
+#define C_MimeForwardDecode            (CVars.MimeForwardDecode)
+#define C_MimeForwardRest              (CVars.MimeForwardRest)
+#define C_MimeSubject                  (CVars.MimeSubject)
+#define C_MimeTypeQueryCommand         (CVars.MimeTypeQueryCommand)
+#define C_MimeTypeQueryFirst           (CVars.MimeTypeQueryFirst)
+#define C_MixEntryFormat               (CVars.MixEntryFormat)
+#define C_Mixmaster                    (CVars.Mixmaster)
+#define C_Move                         (CVars.Move)
+#define C_NarrowTree                   (CVars.NarrowTree)
+#define C_NetInc                       (CVars.NetInc)
+#define C_NewMailCommand               (CVars.NewMailCommand)
+#define C_NewsCacheDir                 (CVars.NewsCacheDir)
+#define C_NewsgroupsCharset            (CVars.NewsgroupsCharset)
+#define C_Newsrc                       (CVars.Newsrc)
+#define C_NewsServer                   (CVars.NewsServer)
+#define C_NmDbLimit                    (CVars.NmDbLimit)
+#define C_NmDefaultUri                 (CVars.NmDefaultUri)
+#define C_NmExcludeTags                (CVars.NmExcludeTags)
+#define C_NmFlaggedTag                 (CVars.NmFlaggedTag)
+#define C_NmOpenTimeout                (CVars.NmOpenTimeout)
+#define C_NmQueryType                  (CVars.NmQueryType)
+#define C_NmQueryWindowCurrentPosition (CVars.NmQueryWindowCurrentPosition)
+#define C_NmQueryWindowCurrentSearch   (CVars.NmQueryWindowCurrentSearch)
+#define C_NmQueryWindowDuration        (CVars.NmQueryWindowDuration)
+#define C_NmQueryWindowTimebase        (CVars.NmQueryWindowTimebase)
+#define C_NmRecord                     (CVars.NmRecord)
+#define C_NmRecordTags                 (CVars.NmRecordTags)
+#define C_NmRepliedTag                 (CVars.NmRepliedTag)
+#define C_NmUnreadTag                  (CVars.NmUnreadTag)
+#define C_NntpAuthenticators           (CVars.NntpAuthenticators)
+#define C_NntpContext                  (CVars.NntpContext)
+#define C_NntpListgroup                (CVars.NntpListgroup)
+#define C_NntpLoadDescription          (CVars.NntpLoadDescription)
+#define C_NntpPass                     (CVars.NntpPass)
+#define C_NntpPoll                     (CVars.NntpPoll)
+#define C_NntpUser                     (CVars.NntpUser)
+#define C_Pager                        (CVars.Pager)
+#define C_PagerContext                 (CVars.PagerContext)
+#define C_PagerFormat                  (CVars.PagerFormat)
+#define C_PagerIndexLines              (CVars.PagerIndexLines)
+#define C_PagerStop                    (CVars.PagerStop)
+#define C_PgpAutoDecode                (CVars.PgpAutoDecode)
+#define C_PgpAutoinline                (CVars.PgpAutoinline)
+#define C_PgpCheckExit                 (CVars.PgpCheckExit)
+#define C_PgpCheckGpgDecryptStatusFd   (CVars.PgpCheckGpgDecryptStatusFd)
+#define C_PgpClearsignCommand          (CVars.PgpClearsignCommand)
+#define C_PgpDecodeCommand             (CVars.PgpDecodeCommand)
+#define C_PgpDecryptCommand            (CVars.PgpDecryptCommand)
+#define C_PgpDecryptionOkay            (CVars.PgpDecryptionOkay)
+#define C_PgpDefaultKey                (CVars.PgpDefaultKey)
+#define C_PgpEncryptOnlyCommand        (CVars.PgpEncryptOnlyCommand)
+#define C_PgpEncryptSelf               (CVars.PgpEncryptSelf)
+#define C_PgpEncryptSignCommand        (CVars.PgpEncryptSignCommand)
+#define C_PgpEntryFormat               (CVars.PgpEntryFormat)
+#define C_PgpExportCommand             (CVars.PgpExportCommand)
+#define C_PgpGetkeysCommand            (CVars.PgpGetkeysCommand)
+#define C_PgpGoodSign                  (CVars.PgpGoodSign)
+#define C_PgpIgnoreSubkeys             (CVars.PgpIgnoreSubkeys)
+#define C_PgpImportCommand             (CVars.PgpImportCommand)
+#define C_PgpListPubringCommand        (CVars.PgpListPubringCommand)
+#define C_PgpListSecringCommand        (CVars.PgpListSecringCommand)
+#define C_PgpLongIds                   (CVars.PgpLongIds)
+#define C_PgpMimeAuto                  (CVars.PgpMimeAuto)
+#define C_PgpReplyinline               (CVars.PgpReplyinline)
+#define C_PgpRetainableSigs            (CVars.PgpRetainableSigs)
+#define C_PgpSelfEncrypt               (CVars.PgpSelfEncrypt)
+#define C_PgpShowUnusable              (CVars.PgpShowUnusable)
+#define C_PgpSignAs                    (CVars.PgpSignAs)
+#define C_PgpSignCommand               (CVars.PgpSignCommand)
+#define C_PgpSortKeys                  (CVars.PgpSortKeys)
+#define C_PgpStrictEnc                 (CVars.PgpStrictEnc)
+#define C_PgpTimeout                   (CVars.PgpTimeout)
+#define C_PgpUseGpgAgent               (CVars.PgpUseGpgAgent)
+#define C_PgpVerifyCommand             (CVars.PgpVerifyCommand)
+#define C_PgpVerifyKeyCommand          (CVars.PgpVerifyKeyCommand)
+#define C_PipeDecode                   (CVars.PipeDecode)
+#define C_PipeSep                      (CVars.PipeSep)
+#define C_PipeSplit                    (CVars.PipeSplit)
+#define C_PopAuthenticators            (CVars.PopAuthenticators)
+#define C_PopAuthTryAll                (CVars.PopAuthTryAll)
+#define C_PopCheckinterval             (CVars.PopCheckinterval)
+#define C_PopDelete                    (CVars.PopDelete)
+#define C_PopHost                      (CVars.PopHost)
+#define C_PopLast                      (CVars.PopLast)
+#define C_PopOauthRefreshCommand       (CVars.PopOauthRefreshCommand)
+#define C_PopPass                      (CVars.PopPass)
+#define C_PopReconnect                 (CVars.PopReconnect)
+#define C_PopUser                      (CVars.PopUser)
+#define C_PostIndentString             (CVars.PostIndentString)
+#define C_PostModerated                (CVars.PostModerated)
+#define C_Postpone                     (CVars.Postpone)
+#define C_Postponed                    (CVars.Postponed)
+#define C_PostponeEncrypt              (CVars.PostponeEncrypt)
+#define C_PostponeEncryptAs            (CVars.PostponeEncryptAs)
+#define C_Preconnect                   (CVars.Preconnect)
+#define C_PreferredLanguages           (CVars.PreferredLanguages)
+#define C_Print                        (CVars.Print)
+#define C_PrintCommand                 (CVars.PrintCommand)
+#define C_PrintDecode                  (CVars.PrintDecode)
+#define C_PrintSplit                   (CVars.PrintSplit)
+#define C_PromptAfter                  (CVars.PromptAfter)
+#define C_QueryCommand                 (CVars.QueryCommand)
+#define C_QueryFormat                  (CVars.QueryFormat)
+#define C_Quit                         (CVars.Quit)
+#define C_QuoteRegex                   (CVars.QuoteRegex)
+#define C_ReadInc                      (CVars.ReadInc)
+#define C_ReadOnly                     (CVars.ReadOnly)
+#define C_Realname                     (CVars.Realname)
+#define C_Recall                       (CVars.Recall)
+#define C_Record                       (CVars.Record)
+#define C_ReflowSpaceQuotes            (CVars.ReflowSpaceQuotes)
+#define C_ReflowText                   (CVars.ReflowText)
+#define C_ReflowWrap                   (CVars.ReflowWrap)
+#define C_ReplyRegex                   (CVars.ReplyRegex)
+#define C_ReplySelf                    (CVars.ReplySelf)
+#define C_ReplyTo                      (CVars.ReplyTo)
+#define C_ReplyWithXorig               (CVars.ReplyWithXorig)
+#define C_Resolve                      (CVars.Resolve)
+#define C_ResumeDraftFiles             (CVars.ResumeDraftFiles)
+#define C_ResumeEditedDraftFiles       (CVars.ResumeEditedDraftFiles)
+#define C_ReverseAlias                 (CVars.ReverseAlias)
+#define C_ReverseName                  (CVars.ReverseName)
+#define C_ReverseRealname              (CVars.ReverseRealname)
+#define C_Rfc2047Parameters            (CVars.Rfc2047Parameters)
+#define C_SaveAddress                  (CVars.SaveAddress)
+#define C_SaveEmpty                    (CVars.SaveEmpty)
+#define C_SaveHistory                  (CVars.SaveHistory)
+#define C_SaveName                     (CVars.SaveName)
+#define C_SaveUnsubscribed             (CVars.SaveUnsubscribed)
+#define C_Score                        (CVars.Score)
+#define C_ScoreThresholdDelete         (CVars.ScoreThresholdDelete)
+#define C_ScoreThresholdFlag           (CVars.ScoreThresholdFlag)
+#define C_ScoreThresholdRead           (CVars.ScoreThresholdRead)
+#define C_SearchContext                (CVars.SearchContext)
+#define C_SendCharset                  (CVars.SendCharset)
+#define C_Sendmail                     (CVars.Sendmail)
+#define C_SendmailWait                 (CVars.SendmailWait)
+#define C_Shell                        (CVars.Shell)
+#define C_ShowMultipartAlternative     (CVars.ShowMultipartAlternative)
+#define C_ShowNewNews                  (CVars.ShowNewNews)
+#define C_ShowOnlyUnread               (CVars.ShowOnlyUnread)
+#define C_SidebarComponentDepth        (CVars.SidebarComponentDepth)
+#define C_SidebarDelimChars            (CVars.SidebarDelimChars)
+#define C_SidebarDividerChar           (CVars.SidebarDividerChar)
+#define C_SidebarFolderIndent          (CVars.SidebarFolderIndent)
+#define C_SidebarFormat                (CVars.SidebarFormat)
+#define C_SidebarIndentString          (CVars.SidebarIndentString)
+#define C_SidebarNewMailOnly           (CVars.SidebarNewMailOnly)
+#define C_SidebarNextNewWrap           (CVars.SidebarNextNewWrap)
+#define C_SidebarNonEmptyMailboxOnly   (CVars.SidebarNonEmptyMailboxOnly)
+#define C_SidebarOnRight               (CVars.SidebarOnRight)
+#define C_SidebarShortPath             (CVars.SidebarShortPath)
+#define C_SidebarSortMethod            (CVars.SidebarSortMethod)
+#define C_SidebarVisible               (CVars.SidebarVisible)
+#define C_SidebarWidth                 (CVars.SidebarWidth)
+#define C_SigDashes                    (CVars.SigDashes)
+#define C_Signature                    (CVars.Signature)
+#define C_SigOnTop                     (CVars.SigOnTop)
+#define C_SimpleSearch                 (CVars.SimpleSearch)
+#define C_SkipQuotedOffset             (CVars.SkipQuotedOffset)
+#define C_SleepTime                    (CVars.SleepTime)
+#define C_SmartWrap                    (CVars.SmartWrap)
+#define C_Smileys                      (CVars.Smileys)
+#define C_SmimeAskCertLabel            (CVars.SmimeAskCertLabel)
+#define C_SmimeCaLocation              (CVars.SmimeCaLocation)
+#define C_SmimeCertificates            (CVars.SmimeCertificates)
+#define C_SmimeDecryptCommand          (CVars.SmimeDecryptCommand)
+#define C_SmimeDecryptUseDefaultKey    (CVars.SmimeDecryptUseDefaultKey)
+#define C_SmimeDefaultKey              (CVars.SmimeDefaultKey)
+#define C_SmimeEncryptCommand          (CVars.SmimeEncryptCommand)
+#define C_SmimeEncryptSelf             (CVars.SmimeEncryptSelf)
+#define C_SmimeEncryptWith             (CVars.SmimeEncryptWith)
+#define C_SmimeGetCertCommand          (CVars.SmimeGetCertCommand)
+#define C_SmimeGetCertEmailCommand     (CVars.SmimeGetCertEmailCommand)
+#define C_SmimeGetSignerCertCommand    (CVars.SmimeGetSignerCertCommand)
+#define C_SmimeImportCertCommand       (CVars.SmimeImportCertCommand)
+#define C_SmimeIsDefault               (CVars.SmimeIsDefault)
+#define C_SmimeKeys                    (CVars.SmimeKeys)
+#define C_SmimePk7outCommand           (CVars.SmimePk7outCommand)
+#define C_SmimeSelfEncrypt             (CVars.SmimeSelfEncrypt)
+#define C_SmimeSignAs                  (CVars.SmimeSignAs)
+#define C_SmimeSignCommand             (CVars.SmimeSignCommand)
+#define C_SmimeSignDigestAlg           (CVars.SmimeSignDigestAlg)
+#define C_SmimeTimeout                 (CVars.SmimeTimeout)
+#define C_SmimeVerifyCommand           (CVars.SmimeVerifyCommand)
+#define C_SmimeVerifyOpaqueCommand     (CVars.SmimeVerifyOpaqueCommand)
+#define C_SmtpAuthenticators           (CVars.SmtpAuthenticators)
+#define C_SmtpOauthRefreshCommand      (CVars.SmtpOauthRefreshCommand)
+#define C_SmtpPass                     (CVars.SmtpPass)
+#define C_SmtpUrl                      (CVars.SmtpUrl)
+#define C_Sort                         (CVars.Sort)
+#define C_SortAlias                    (CVars.SortAlias)
+#define C_SortAux                      (CVars.SortAux)
+#define C_SortBrowser                  (CVars.SortBrowser)
+#define C_SortRe                       (CVars.SortRe)
+#define C_SpamSeparator                (CVars.SpamSeparator)
+#define C_Spoolfile                    (CVars.Spoolfile)
+#define C_SslCaCertificatesFile        (CVars.SslCaCertificatesFile)
+#define C_SslCiphers                   (CVars.SslCiphers)
+#define C_SslClientCert                (CVars.SslClientCert)
+#define C_SslForceTls                  (CVars.SslForceTls)
+#define C_SslMinDhPrimeBits            (CVars.SslMinDhPrimeBits)
+#define C_SslStarttls                  (CVars.SslStarttls)
+#define C_SslUseSslv2                  (CVars.SslUseSslv2)
+#define C_SslUseSslv3                  (CVars.SslUseSslv3)
+#define C_SslUsesystemcerts            (CVars.SslUsesystemcerts)
+#define C_SslUseTlsv1                  (CVars.SslUseTlsv1)
+#define C_SslUseTlsv11                 (CVars.SslUseTlsv11)
+#define C_SslUseTlsv12                 (CVars.SslUseTlsv12)
+#define C_SslVerifyDates               (CVars.SslVerifyDates)
+#define C_SslVerifyHost                (CVars.SslVerifyHost)
+#define C_SslVerifyPartialChains       (CVars.SslVerifyPartialChains)
+#define C_StatusChars                  (CVars.StatusChars)
+#define C_StatusFormat                 (CVars.StatusFormat)
+#define C_StatusOnTop                  (CVars.StatusOnTop)
+#define C_StrictThreads                (CVars.StrictThreads)
+#define C_Suspend                      (CVars.Suspend)
+#define C_TextFlowed                   (CVars.TextFlowed)
+#define C_ThoroughSearch               (CVars.ThoroughSearch)
+#define C_ThreadReceived               (CVars.ThreadReceived)
+#define C_Tilde                        (CVars.Tilde)
+#define C_TimeInc                      (CVars.TimeInc)
+#define C_Timeout                      (CVars.Timeout)
+#define C_Tmpdir                       (CVars.Tmpdir)
+#define C_ToChars                      (CVars.ToChars)
+#define C_Trash                        (CVars.Trash)
+#define C_TsEnabled                    (CVars.TsEnabled)
+#define C_TsIconFormat                 (CVars.TsIconFormat)
+#define C_TsStatusFormat               (CVars.TsStatusFormat)
+#define C_Tunnel                       (CVars.Tunnel)
+#define C_UncollapseJump               (CVars.UncollapseJump)
+#define C_UncollapseNew                (CVars.UncollapseNew)
+#define C_Use8bitmime                  (CVars.Use8bitmime)
+#define C_UseDomain                    (CVars.UseDomain)
+#define C_UseEnvelopeFrom              (CVars.UseEnvelopeFrom)
+#define C_UseFrom                      (CVars.UseFrom)
+#define C_UseIpv6                      (CVars.UseIpv6)
+#define C_UserAgent                    (CVars.UserAgent)
+#define C_VfolderFormat                (CVars.VfolderFormat)
+#define C_VirtualSpoolfile             (CVars.VirtualSpoolfile)
+#define C_Visual                       (CVars.Visual)
+#define C_WaitKey                      (CVars.WaitKey)
+#define C_Weed                         (CVars.Weed)
+#define C_Wrap                         (CVars.Wrap)
+#define C_WrapHeaders                  (CVars.WrapHeaders)
+#define C_WrapSearch                   (CVars.WrapSearch)
+#define C_WriteBcc                     (CVars.WriteBcc)
+#define C_WriteInc                     (CVars.WriteInc)
+#define C_XCommentTo                   (CVars.XCommentTo)
+// clang-format on
 
 int charset_validator(const struct ConfigSet *cs, const struct ConfigDef *cdef, intptr_t value, struct Buffer *err);
 int hcache_validator(const struct ConfigSet *cs, const struct ConfigDef *cdef, intptr_t value, struct Buffer *err);
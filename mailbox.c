@@ -26,6 +26,13 @@
  * @page mailbox Representation of a mailbox
  *
  * Representation of a mailbox
+ *
+ * Registered Mailboxes are indexed by their realpath and by their description.
+ * If a Mailbox's realpath isn't set, its path is canonicalised with
+ * realpath(3).  Paths that can't be resolved, e.g. ones that don't exist, yet,
+ * or aren't local, are used as they are.
+ * The list nodes are part of the Mailbox, so registering one doesn't allocate
+ * anything except the hash entries.
  */
 
 #include "config.h"
@@ -54,7 +61,180 @@
 #include "mx.h"
 #include "protos.h"
 
-struct MailboxList AllMailboxes = STAILQ_HEAD_INITIALIZER(AllMailboxes);
+struct MailboxList AllMailboxes = TAILQ_HEAD_INITIALIZER(AllMailboxes);
+
+static struct Hash *MailboxPaths = NULL; ///< Registered Mailboxes, by realpath
+static struct Hash *MailboxNames = NULL; ///< Registered Mailboxes, by description
+static size_t MailboxCount = 0;          ///< Number of registered Mailboxes
+static size_t MailboxHashSize = 0;       ///< Size of the hash tables
+
+/**
+ * mailbox_hash_insert - Add a Mailbox to the hash tables
+ * @param m Mailbox to add
+ */
+static void mailbox_hash_insert(struct Mailbox *m)
+{
+  mutt_hash_insert(MailboxPaths, m->realpath, m);
+  if (m->desc)
+    mutt_hash_insert(MailboxNames, m->desc, m);
+}
+
+/**
+ * mailbox_reserve - Make room in the hash tables
+ * @param num Number of Mailboxes about to be added
+ *
+ * The hash tables don't grow by themselves, so they're rebuilt, at least
+ * doubling in size, whenever they would become more than fully loaded.
+ */
+static void mailbox_reserve(size_t num)
+{
+  if (MailboxPaths && ((MailboxCount + num) <= MailboxHashSize))
+    return;
+
+  size_t size = MAX(MailboxHashSize * 2, 128);
+  while (size < (MailboxCount + num))
+    size *= 2;
+
+  mutt_hash_free(&MailboxPaths);
+  mutt_hash_free(&MailboxNames);
+  MailboxPaths = mutt_hash_new(size, MUTT_HASH_NO_FLAGS);
+  MailboxNames = mutt_hash_new(size, MUTT_HASH_ALLOW_DUPS);
+  MailboxHashSize = size;
+
+  struct MailboxNode *np = NULL;
+  TAILQ_FOREACH(np, &AllMailboxes, entries)
+  {
+    mailbox_hash_insert(np->mailbox);
+  }
+}
+
+/**
+ * mailbox_register - Register a Mailbox
+ * @param m Mailbox to add
+ * @retval true Mailbox was registered
+ *
+ * The hash tables must already have room for the Mailbox.
+ */
+static bool mailbox_register(struct Mailbox *m)
+{
+  if (!m || m->gnode.mailbox)
+    return false;
+
+  if (!m->realpath)
+  {
+    if (!m->pathbuf || (mutt_buffer_len(m->pathbuf) == 0))
+      return false;
+
+    char buf[PATH_MAX];
+    if (realpath(mutt_b2s(m->pathbuf), buf))
+      m->realpath = mutt_str_strdup(buf);
+    else
+      m->realpath = mutt_str_strdup(mutt_b2s(m->pathbuf));
+  }
+
+  if (mutt_hash_find(MailboxPaths, m->realpath))
+    return false;
+
+  m->gnode.mailbox = m;
+  TAILQ_INSERT_TAIL(&AllMailboxes, &m->gnode, entries);
+  mailbox_hash_insert(m);
+  MailboxCount++;
+  return true;
+}
+
+/**
+ * mailbox_add - Register a Mailbox
+ * @param m Mailbox to add
+ * @retval true Mailbox was registered
+ *
+ * The Mailbox is added to #AllMailboxes, unless one with the same realpath is
+ * already there.  If the realpath isn't set, it's resolved from the path.
+ *
+ * @note Don't change the realpath or description of a registered Mailbox
+ */
+bool mailbox_add(struct Mailbox *m)
+{
+  mailbox_reserve(1);
+  return mailbox_register(m);
+}
+
+/**
+ * mailbox_add_bulk - Register many Mailboxes
+ * @param mailboxes Array of Mailboxes to add
+ * @param num       Number of Mailboxes
+ * @retval num Number of Mailboxes registered
+ *
+ * The hash tables are resized, at most once, before any are added.
+ * Duplicates, including those within the array, aren't registered; they still
+ * belong to the caller.
+ */
+size_t mailbox_add_bulk(struct Mailbox *mailboxes[], size_t num)
+{
+  if (!mailboxes || (num == 0))
+    return 0;
+
+  mailbox_reserve(num);
+
+  size_t count = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    if (mailbox_register(mailboxes[i]))
+      count++;
+  }
+
+  return count;
+}
+
+/**
+ * mailbox_remove - Unregister a Mailbox
+ * @param m Mailbox to remove
+ */
+void mailbox_remove(struct Mailbox *m)
+{
+  if (!m || !m->gnode.mailbox)
+    return;
+
+  TAILQ_REMOVE(&AllMailboxes, &m->gnode, entries);
+  m->gnode.mailbox = NULL;
+  mutt_hash_delete(MailboxPaths, m->realpath, m);
+  if (m->desc)
+    mutt_hash_delete(MailboxNames, m->desc, m);
+
+  if (--MailboxCount == 0)
+  {
+    mutt_hash_free(&MailboxPaths);
+    mutt_hash_free(&MailboxNames);
+    MailboxHashSize = 0;
+  }
+}
+
+/**
+ * mailbox_find - Find a Mailbox by its realpath
+ * @param path Path to find
+ * @retval ptr  Matching Mailbox
+ * @retval NULL None found
+ */
+struct Mailbox *mailbox_find(const char *path)
+{
+  if (!MailboxPaths || !path)
+    return NULL;
+
+  return mutt_hash_find(MailboxPaths, path);
+}
+
+/**
+ * mailbox_find_name - Find a Mailbox by its description
+ * @param name Description to find
+ * @retval ptr  Matching Mailbox
+ * @retval NULL None found
+ */
+struct Mailbox *mailbox_find_name(const char *name)
+{
+  if (!MailboxNames || !name)
+    return NULL;
+
+  return mutt_hash_find(MailboxNames, name);
+}
 
 /**
  * mailbox_new - Create a new Mailbox
@@ -72,6 +252,9 @@ struct Mailbox *mailbox_new(void)
 /**
  * mailbox_free - Free a Mailbox
  * @param[out] ptr Mailbox to free
+ *
+ * The Mailbox is unlinked from its Account, but the Account isn't freed, even
+ * if it has no Mailboxes left.  That's up to the Account's owner.
  */
 void mailbox_free(struct Mailbox **ptr)
 {
@@ -80,6 +263,13 @@ void mailbox_free(struct Mailbox **ptr)
 
   struct Mailbox *m = *ptr;
 
+  if (m->account)
+  {
+    TAILQ_REMOVE(&m->account->mailboxes, &m->anode, entries);
+    m->anode.mailbox = NULL;
+    m->account = NULL;
+  }
+  mailbox_remove(m);
   mutt_buffer_free(&m->pathbuf);
   FREE(&m->desc);
   if (m->mdata && m->free_mdata)
@@ -93,6 +93,16 @@ typedef uint16_t AclFlags;          ///< Flags, e.g. #MUTT_ACL_ADMIN
 #define MUTT_MAILBOX_CHECK_FORCE       (1 << 0)
 #define MUTT_MAILBOX_CHECK_FORCE_STATS (1 << 1)
 
+/**
+ * struct MailboxNode - List of Mailboxes
+ */
+struct MailboxNode
+{
+  struct Mailbox *mailbox;
+  TAILQ_ENTRY(MailboxNode) entries;
+};
+TAILQ_HEAD(MailboxList, MailboxNode);
+
 /**
  * struct Mailbox - A mailbox
  */
@@ -114,21 +124,19 @@ struct Mailbox
 
   void (*notify2)(struct Mailbox *m, enum MailboxNotification action); ///< Notification callback
   void *ndata; ///< Notification callback private data
-};
 
-/**
- * struct MailboxNode - List of Mailboxes
- */
-struct MailboxNode
-{
-  struct Mailbox *mailbox;
-  STAILQ_ENTRY(MailboxNode) entries;
+  struct MailboxNode gnode; ///< Entry in #AllMailboxes, see mailbox_add()
+  struct MailboxNode anode; ///< Entry in the Account's Mailboxes, see account_add_mailbox()
 };
-STAILQ_HEAD(MailboxList, MailboxNode);
 
 extern struct MailboxList AllMailboxes; ///< List of all Mailboxes
 
+bool            mailbox_add              (struct Mailbox *m);
+size_t          mailbox_add_bulk         (struct Mailbox *mailboxes[], size_t num);
+struct Mailbox *mailbox_find             (const char *path);
+struct Mailbox *mailbox_find_name        (const char *name);
 void            mailbox_free             (struct Mailbox **ptr);
 struct Mailbox *mailbox_new              (void);
+void            mailbox_remove           (struct Mailbox *m);
 
 #endif /* MUTT_MAILBOX_H */
@@ -5,22 +5,36 @@
 #include <stdio.h>
 #include <string.h>
 #include "mutt/logging.h"
+#include "bench/inherit.h"
+#include "bench/regex.h"
+#include "bench/source.h"
+#include "bench/string.h"
+#include "bench/subset.h"
 #include "dump/dump.h"
 #include "test/account2.h"
 #include "test/address.h"
+#include "test/arena.h"
 #include "test/bool.h"
+#include "test/complexity.h"
 #include "test/deep.h"
 #include "test/enum.h"
 #include "test/inherit.h"
 #include "test/initial.h"
+#include "test/intern.h"
 #include "test/long.h"
+#include "test/lookup.h"
+#include "test/mailbox.h"
 #include "test/mbtable.h"
 #include "test/number.h"
+#include "test/prefilter.h"
 #include "test/quad.h"
 #include "test/regex3.h"
+#include "test/regexgroup.h"
 #include "test/set.h"
+#include "test/shared.h"
 #include "test/slist.h"
 #include "test/sort.h"
+#include "test/source.h"
 #include "test/string4.h"
 #include "test/synonym.h"
 
@@ -54,21 +68,36 @@ struct Test test[] = {
   { "set",       config_set       },
   { "account",   config_account   },
   { "initial",   config_initial   },
+  { "intern",    config_intern    },
   { "synonym",   config_synonym   },
   { "address",   config_address   },
+  { "arena",     config_arena     },
   { "bool",      config_bool      },
+  { "complexity", config_complexity },
   { "enum",      config_enum      },
   { "long",      config_long      },
+  { "lookup",    config_lookup    },
+  { "mailbox",   config_mailbox   },
   { "mbtable",   config_mbtable   },
   { "number",    config_number    },
+  { "prefilter", config_prefilter },
   { "quad",      config_quad      },
   { "regex",     config_regex     },
+  { "regexgroup", config_regexgroup },
+  { "shared",    config_shared    },
   { "slist",     config_slist     },
   { "sort",      config_sort      },
+  { "source",    config_source    },
   { "string",    config_string    },
   { "deep",      config_deep      },
   { "dump",      config_dump      },
   { "inherit",   config_inherit   },
+  { "bench_source",   bench_source   },
+  { "bench_validate", bench_validate },
+  { "bench_subset",   bench_subset   },
+  { "bench_inherit",  bench_inherit  },
+  { "bench_string",   bench_string   },
+  { "bench_regex",    bench_regex    },
   { NULL },
 };
 // clang-format on
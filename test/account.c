@@ -43,6 +43,104 @@ static struct ConfigDef Vars[] = {
 };
 // clang-format on
 
+static bool test_account_registry(struct ConfigSet *cs)
+{
+  log_line(__func__);
+
+  static const char *AccountVarStr[] = {
+    "Apple",
+    NULL,
+  };
+
+  static const char *names[] = { "apple", "banana", "cherry" };
+  struct Account *acs[mutt_array_size(names)] = { NULL };
+  bool result = false;
+
+  for (size_t i = 0; i < mutt_array_size(names); i++)
+  {
+    acs[i] = account_new(cs, NULL);
+    if (!TEST_CHECK(account_add_config(acs[i], cs, names[i], AccountVarStr)))
+      goto tar_out;
+    if (!TEST_CHECK(account_add(acs[i])))
+      goto tar_out;
+  }
+
+  /* Duplicate names and double registration are rejected */
+  struct Account *dup = account_new(cs, NULL);
+  bool unnamed = account_add(dup);
+  dup->name = mutt_str_strdup("banana");
+  bool dup_added = account_add(dup);
+  account_free(&dup);
+  if (!TEST_CHECK(!unnamed && !dup_added && !account_add(acs[0]) && !account_add(NULL)))
+    goto tar_out;
+
+  for (size_t i = 0; i < mutt_array_size(names); i++)
+  {
+    if (!TEST_CHECK((account_find(names[i]) == acs[i]) &&
+                    (account_find_id(acs[i]->id) == acs[i])))
+    {
+      goto tar_out;
+    }
+  }
+
+  if (!TEST_CHECK((account_find("veg") == NULL) && (account_find(NULL) == NULL) &&
+                  (account_find_id(0) == NULL)))
+  {
+    goto tar_out;
+  }
+
+  if (!TEST_CHECK(account_get_current() == NULL))
+    goto tar_out;
+
+  account_push_current(acs[0]);
+  account_push_current(acs[1]);
+  account_push_current(NULL);
+  if (!TEST_CHECK(account_get_current() == acs[1]))
+    goto tar_out;
+
+  /* Freeing an Account removes it from the registry and the stack */
+  unsigned int id = acs[1]->id;
+  account_free(&acs[1]);
+  if (!TEST_CHECK((account_find("banana") == NULL) && (account_find_id(id) == NULL) &&
+                  (account_get_current() == acs[0])))
+  {
+    goto tar_out;
+  }
+
+  account_pop_current();
+  account_pop_current();
+  if (!TEST_CHECK(account_get_current() == NULL))
+    goto tar_out;
+
+  /* Renaming keeps the registration, under the new name */
+  if (!TEST_CHECK(!account_add_config(acs[0], cs, "cherry", AccountVarStr) &&
+                  account_add_config(acs[0], cs, "damson", AccountVarStr)))
+  {
+    goto tar_out;
+  }
+  if (!TEST_CHECK((account_find("apple") == NULL) && (account_find("damson") == acs[0]) &&
+                  (account_find_id(acs[0]->id) == acs[0])))
+  {
+    goto tar_out;
+  }
+
+  /* Freeing the config removes the name from the registry */
+  id = acs[2]->id;
+  account_free_config(acs[2]);
+  if (!TEST_CHECK((account_find("cherry") == NULL) && (account_find_id(id) == NULL) &&
+                  (acs[2]->id == 0) && (account_find("damson") == acs[0])))
+  {
+    goto tar_out;
+  }
+
+  log_line(__func__);
+  result = true;
+tar_out:
+  for (size_t i = 0; i < mutt_array_size(names); i++)
+    account_free(&acs[i]);
+  return result;
+}
+
 void config_account(void)
 {
   log_line(__func__);
@@ -264,6 +362,9 @@ void config_account(void)
 
   account_free(NULL);
 
+  if (!TEST_CHECK(test_account_registry(cs)))
+    return;
+
   account_free(&a);
   cs_free(&cs);
   FREE(&err.data);
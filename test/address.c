@@ -50,6 +50,8 @@ static struct Address *VarNectarine;
 static struct Address *VarOlive;
 static struct Address *VarPapaya;
 static struct Address *VarQuince;
+static struct Address *VarRaspberry;
+static bool VarIdnEncode;
 
 // clang-format off
 static struct ConfigDef Vars[] = {
@@ -70,6 +72,8 @@ static struct ConfigDef Vars[] = {
   { "Olive",      DT_ADDRESS, &VarOlive,      IP "olive@example.com",      0, validator_warn    },
   { "Papaya",     DT_ADDRESS, &VarPapaya,     IP "papaya@example.com",     0, validator_fail    },
   { "Quince",     DT_ADDRESS, &VarQuince,     0,                           0, NULL              }, /* test_inherit */
+  { "Raspberry",  DT_ADDRESS, &VarRaspberry,  0,                           0, NULL              }, /* test_cache */
+  { "idn_encode", DT_BOOL,    &VarIdnEncode,  true,                        0, NULL              },
   { NULL },
 };
 // clang-format on
@@ -597,6 +601,93 @@ ti_out:
   return result;
 }
 
+static bool test_cache(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  const char *name = "Raspberry";
+  const char *value = "Rose <rose@example.com>, bob@example.org";
+
+  mutt_buffer_reset(err);
+  int rc = cs_str_string_set(cs, name, value, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("%s\n", err->data);
+    goto tc_out;
+  }
+
+  /* The value is the first address, but they're all kept */
+  mutt_buffer_reset(err);
+  rc = cs_str_string_get(cs, name, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) ||
+      !TEST_CHECK(mutt_str_strcmp(VarRaspberry->mailbox, "rose@example.com") == 0))
+  {
+    goto tc_out;
+  }
+  TEST_MSG("%s = %s\n", name, err->data);
+
+  const struct AddressList *lists[] = {
+    address_list(VarRaspberry),
+    address_intl(VarRaspberry),
+    address_local(VarRaspberry),
+  };
+  for (size_t i = 0; i < mutt_array_size(lists); i++)
+  {
+    if (!TEST_CHECK(lists[i] != NULL))
+      goto tc_out;
+
+    size_t count = 0;
+    const struct Address *a = NULL;
+    TAILQ_FOREACH(a, lists[i], entries)
+    {
+      count++;
+      if (!TEST_CHECK((i != 1) || a->is_intl) || !TEST_CHECK((i != 2) || !a->is_intl))
+        goto tc_out;
+    }
+    if (!TEST_CHECK(count == 2))
+      goto tc_out;
+  }
+  TEST_MSG("Display: %s\n", address_display(VarRaspberry));
+
+  /* The conversions are kept... */
+  struct Address *intl = TAILQ_FIRST((struct AddressList *) address_intl(VarRaspberry));
+  intl->is_intl = false;
+  if (!TEST_CHECK(!TAILQ_FIRST(address_intl(VarRaspberry))->is_intl))
+    goto tc_out;
+
+  /* ...until the IDN settings change */
+  rc = cs_str_native_set(cs, "idn_encode", false, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) ||
+      !TEST_CHECK(TAILQ_FIRST(address_intl(VarRaspberry))->is_intl))
+  {
+    goto tc_out;
+  }
+
+  /* Every scope with the same value shares the conversions */
+  const struct Address *before = VarRaspberry;
+  mutt_buffer_reset(err);
+  rc = cs_str_string_set(cs, "Quince", value, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) || !TEST_CHECK(VarQuince == before))
+    goto tc_out;
+
+  /* Different lists with the same first address aren't shared */
+  rc = cs_str_string_set(cs, "Quince", "Rose <rose@example.com>", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) || !TEST_CHECK(VarQuince != before))
+    goto tc_out;
+
+  if (!TEST_CHECK(address_list(NULL) == NULL) || !TEST_CHECK(address_intl(NULL) == NULL) ||
+      !TEST_CHECK(address_local(NULL) == NULL) || !TEST_CHECK(address_display(NULL) == NULL))
+  {
+    goto tc_out;
+  }
+
+  log_line(__func__);
+  result = true;
+tc_out:
+  return result;
+}
+
 void config_address(void)
 {
   struct Buffer err;
@@ -608,6 +699,7 @@ void config_address(void)
   struct ConfigSet *cs = cs_new(30);
 
   address_init(cs);
+  bool_init(cs);
   dont_fail = true;
   if (!cs_register_variables(cs, Vars, 0))
     return;
@@ -625,6 +717,7 @@ void config_address(void)
   TEST_CHECK(test_reset(cs, &err));
   TEST_CHECK(test_validator(cs, &err));
   TEST_CHECK(test_inherit(cs, &err));
+  TEST_CHECK(test_cache(cs, &err));
 
   cs_free(&cs);
   FREE(&err.data);
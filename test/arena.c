@@ -0,0 +1,248 @@
+/**
+ * @file
+ * Test code for the config Arena
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "account.h"
+#include "common.h"
+
+static short VarApple;
+static short VarBanana;
+static char *VarCherry;
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",  DT_NUMBER, &VarApple,  42, 0, NULL },
+  { "Banana", DT_NUMBER, &VarBanana, 99, 0, NULL },
+  { "Cherry", DT_STRING, &VarCherry, 0,  0, NULL },
+  { NULL },
+};
+// clang-format on
+
+static bool test_arena_alloc(void)
+{
+  log_line(__func__);
+
+  struct Arena *a = arena_new(256);
+
+  char *first = arena_calloc(a, 3);
+  char *second = arena_calloc(a, 17);
+  if (!TEST_CHECK(first && second && (first != second)))
+    goto taa_out;
+
+  if (!TEST_CHECK((((uintptr_t) first % (2 * sizeof(void *))) == 0) &&
+                  (((uintptr_t) second % (2 * sizeof(void *))) == 0)))
+  {
+    goto taa_out;
+  }
+
+  /* A large allocation doesn't waste the current block */
+  char *big = arena_calloc(a, 1000);
+  char *third = arena_calloc(a, 8);
+  if (!TEST_CHECK(big && (big[999] == '\0') && (third == (second + 32))))
+    goto taa_out;
+
+  TEST_MSG("Used: %zu bytes\n", arena_used(a));
+  if (!TEST_CHECK(arena_used(a) == (16 + 32 + 1008 + 16)))
+    goto taa_out;
+
+  char *old = first;
+  arena_release(a, &first, 3);
+  if (!TEST_CHECK(!first && (arena_used(a) == (16 + 32 + 1008 + 16))))
+    goto taa_out;
+
+  /* Released memory is reused, zeroed, by an allocation of the same size */
+  old[0] = 'x';
+  char *again = arena_calloc(a, 9);
+  if (!TEST_CHECK((again == old) && (again[0] == '\0') &&
+                  (arena_used(a) == (16 + 32 + 1008 + 16))))
+  {
+    goto taa_out;
+  }
+
+  /* Large allocations aren't */
+  arena_release(a, &big, 1000);
+  big = arena_calloc(a, 1000);
+  if (!TEST_CHECK(arena_used(a) == (16 + 32 + 1008 + 16 + 1008)))
+    goto taa_out;
+
+  /* Without an Arena, it's a plain allocation */
+  char *plain = arena_calloc(NULL, 10);
+  arena_release(NULL, &plain, 10);
+  if (!TEST_CHECK(!plain && (arena_used(NULL) == 0)))
+    goto taa_out;
+
+  arena_release(a, NULL, 0);
+  arena_free(&a);
+  arena_free(&a);
+  arena_free(NULL);
+
+  log_line(__func__);
+  return true;
+
+taa_out:
+  arena_free(&a);
+  return false;
+}
+
+static struct ConfigSet *arena_config_new(ConfigSetFlags flags)
+{
+  struct ConfigSet *cs = cs_new_flags(30, flags);
+
+  number_init(cs);
+  string_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    cs_free(&cs);
+
+  return cs;
+}
+
+static bool test_arena_config(struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  const char *AccountVarStr[] = {
+    "Apple",
+    "Banana",
+    NULL,
+  };
+
+  struct ConfigSet *cs = arena_config_new(CS_ARENA);
+  if (!TEST_CHECK(cs != NULL))
+    return false;
+
+  struct Account *a = account_new(cs, NULL);
+  if (!TEST_CHECK(account_add_config(a, cs, "fruit", AccountVarStr)))
+    goto tac_out;
+
+  /* The inherited items come from the Arena */
+  size_t used = arena_used(cs->arena);
+  if (!TEST_CHECK(used > 0))
+    goto tac_out;
+
+  int rc = cs_str_string_set(cs, "Cherry", "cherry", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) ||
+      !TEST_CHECK(arena_used(cs->arena) > used))
+  {
+    goto tac_out;
+  }
+
+  rc = cs_str_string_set(cs, "fruit:Apple", "7", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+    goto tac_out;
+
+  mutt_buffer_reset(err);
+  rc = cs_str_string_get(cs, "fruit:Apple", err);
+  if (!TEST_CHECK((CSR_RESULT(rc) == CSR_SUCCESS) &&
+                  (mutt_str_strcmp(mutt_b2s(err), "7") == 0)))
+  {
+    goto tac_out;
+  }
+
+  /* Long strings are freed, so changing them doesn't grow the Arena */
+  char value[64];
+  used = arena_used(cs->arena);
+  for (int i = 0; i < 100; i++)
+  {
+    snprintf(value, sizeof(value), "a value that's too long for a cell %d", i);
+    cs_str_string_set(cs, "Cherry", value, err);
+  }
+  if (!TEST_CHECK(arena_used(cs->arena) == used))
+    goto tac_out;
+
+  /* Removing the Account doesn't give the memory back... */
+  used = arena_used(cs->arena);
+  account_free(&a);
+  if (!TEST_CHECK(arena_used(cs->arena) == used))
+    goto tac_out;
+
+  /* ...but recreating it, e.g. on reconnect, reuses it */
+  for (int i = 0; i < 100; i++)
+  {
+    a = account_new(cs, NULL);
+    if (!TEST_CHECK(account_add_config(a, cs, "fruit", AccountVarStr)))
+      goto tac_out;
+    account_free(&a);
+  }
+  if (!TEST_CHECK(arena_used(cs->arena) == used))
+    goto tac_out;
+
+  log_line(__func__);
+  result = true;
+tac_out:
+  account_free(&a);
+  cs_free(&cs);
+  return result;
+}
+
+static bool test_fast_exit(struct Buffer *err)
+{
+  log_line(__func__);
+
+  struct ConfigSet *cs = arena_config_new(CS_ARENA);
+  if (!TEST_CHECK(cs != NULL))
+    return false;
+
+  struct HashElem *parent = cs_get_elem(cs, "Apple");
+  if (!TEST_CHECK(cs_inherit_variable(cs, parent, "fruit:Apple") != NULL))
+  {
+    cs_free(&cs);
+    return false;
+  }
+
+  cs_str_string_set(cs, "fruit:Apple", "13", err);
+  cs_str_string_set(cs, "Cherry", "cherry", err);
+
+  /* Everything is in the Arena, so nothing leaks */
+  cs->flags |= CS_FAST_EXIT;
+  cs_free(&cs);
+  VarCherry = NULL;
+
+  if (!TEST_CHECK(cs == NULL))
+    return false;
+
+  log_line(__func__);
+  return true;
+}
+
+void config_arena(void)
+{
+  struct Buffer err;
+  mutt_buffer_init(&err);
+  err.dsize = 256;
+  err.data = mutt_mem_calloc(1, err.dsize);
+  mutt_buffer_reset(&err);
+
+  TEST_CHECK(test_arena_alloc());
+  TEST_CHECK(test_arena_config(&err));
+  TEST_CHECK(test_fast_exit(&err));
+
+  FREE(&err.data);
+}
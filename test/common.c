@@ -33,8 +33,6 @@
 #include "common.h"
 #include "account.h"
 
-struct HashElem *get_base(struct HashElem *he);
-
 const char *line = "----------------------------------------"
                    "----------------------------------------";
 
@@ -91,6 +89,12 @@ int log_observer(struct NotifyCallback *nc)
 
   struct EventConfig *ec = (struct EventConfig *) nc->event;
 
+  if (nc->event_subtype == NT_CONFIG_DELETED)
+  {
+    TEST_MSG("\033[1;33mEvent: %s config has been deleted\033[0m\n", ec->name);
+    return true;
+  }
+
   struct Buffer result;
   mutt_buffer_init(&result);
   result.dsize = 256;
@@ -105,8 +109,18 @@ int log_observer(struct NotifyCallback *nc)
   else
     cs_he_initial_get(ec->cs, ec->he, &result);
 
-  TEST_MSG("\033[1;33mEvent: %s has been %s to '%s'\033[0m\n", ec->name,
-           events[nc->event_subtype - 1], result.data);
+  if ((nc->event_subtype == NT_CONFIG_SLIST_ADD) || (nc->event_subtype == NT_CONFIG_SLIST_REMOVE))
+  {
+    TEST_MSG("\033[1;33mEvent: %s has had '%s' %s, now '%s'\033[0m\n", ec->name,
+             NONULL(ec->element),
+             (nc->event_subtype == NT_CONFIG_SLIST_ADD) ? "added" : "removed",
+             result.data);
+  }
+  else
+  {
+    TEST_MSG("\033[1;33mEvent: %s has been %s to '%s'\033[0m\n", ec->name,
+             events[nc->event_subtype - 1], result.data);
+  }
 
   FREE(&result.data);
   return true;
@@ -155,7 +169,7 @@ void cs_dump_set(const struct ConfigSet *cs)
     if (he->type & DT_INHERITED)
     {
       struct Inheritance *i = he->data;
-      he = get_base(i->parent);
+      he = cs_he_base(i->parent);
       name = i->name;
     }
     else
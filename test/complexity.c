@@ -0,0 +1,252 @@
+/**
+ * @file
+ * Test code for the Regex complexity analysis
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <regex.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+
+/* No match may take longer than this, in milliseconds */
+#define STRESS_MAX_TIME 1000
+
+static struct Regex *VarApple;
+static struct Regex *VarBanana;
+
+static int validator_risk(const struct ConfigSet *cs, const struct ConfigDef *cdef,
+                          intptr_t value, struct Buffer *err);
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",  DT_REGEX, &VarApple,  0, 0, NULL           }, /* test_stress */
+  { "Banana", DT_REGEX, &VarBanana, 0, 0, validator_risk },
+  { NULL },
+};
+
+static const struct RiskTest
+{
+  const char *pattern;
+  enum RegexRisk risk;
+} RiskTests[] = {
+  { "\\<(attach|attached|attachments?)\\>",    REGEX_RISK_NONE    },
+  { "^([ \t]*[|>:}#])+",                       REGEX_RISK_NONE    },
+  { "^((re|aw|sv)(\\[[0-9]+\\])*:[ \t]*)*",    REGEX_RISK_NONE    },
+  { "(>From )|(:[-^]?[][)(><}{|/DP])",         REGEX_RISK_NONE    },
+  { "^[^,]*",                                  REGEX_RISK_NONE    },
+  { "([a-z]+@)+",                              REGEX_RISK_NONE    },
+  { "(a|b)*c",                                 REGEX_RISK_NONE    },
+  { "a{2,}",                                   REGEX_RISK_NONE    },
+  { "(a+)+$",                                  REGEX_RISK_NESTED  },
+  { "(a*)*b",                                  REGEX_RISK_NESTED  },
+  { "(x+x+)+y",                                REGEX_RISK_NESTED  },
+  { "(\\w+\\s?)*$",                            REGEX_RISK_NESTED  },
+  { "(.*,)+x",                                 REGEX_RISK_NESTED  },
+  { "(a+|b+)+",                                REGEX_RISK_NESTED  },
+  { "(a{1,20}){1,20}$",                        REGEX_RISK_NESTED  },
+  { "((a*)*|b)*c",                             REGEX_RISK_NESTED  },
+  { "(.*)\\1",                                 REGEX_RISK_BACKREF },
+  { "^(a+)\\1+b",                              REGEX_RISK_BACKREF },
+  { "((a+)+)\\2b",                             REGEX_RISK_BACKREF },
+  { NULL },
+};
+// clang-format on
+
+static int validator_risk(const struct ConfigSet *cs, const struct ConfigDef *cdef,
+                          intptr_t value, struct Buffer *err)
+{
+  const struct Regex *r = (const struct Regex *) value;
+  if (regex_risk(r) == REGEX_RISK_NONE)
+    return CSR_SUCCESS;
+
+  mutt_buffer_printf(err, "%s: %s, %s", __func__, cdef->name,
+                     complexity_risk_name(regex_risk(r)));
+  return CSR_ERR_INVALID;
+}
+
+static bool test_analysis(void)
+{
+  log_line(__func__);
+
+  for (size_t i = 0; RiskTests[i].pattern; i++)
+  {
+    enum RegexRisk risk = complexity_risk(RiskTests[i].pattern);
+    TEST_MSG("%-40s %s\n", RiskTests[i].pattern, complexity_risk_name(risk));
+    if (!TEST_CHECK(risk == RiskTests[i].risk))
+      return false;
+  }
+
+  if (!TEST_CHECK(complexity_risk(NULL) == REGEX_RISK_NONE))
+    return false;
+
+  /* Malformed patterns mustn't confuse the parser */
+  const char *broken[] = { "(", ")", "[", "\\", "[[:alpha:", "a{", "a{1", "a{1,", "*a" };
+  for (size_t i = 0; i < mutt_array_size(broken); i++)
+    complexity_risk(broken[i]);
+
+  log_line(__func__);
+  return true;
+}
+
+static bool stress_match(const char *pattern, const struct Regex *r,
+                         char **strings, size_t num)
+{
+  const size_t budget = regex_budget(r);
+  for (size_t j = 0; j < num; j++)
+  {
+    const size_t len = strlen(strings[j]);
+
+    struct timespec start = { 0 };
+    struct timespec end = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int rc_exec = regex_exec(r, strings[j], 0, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long ms = ((end.tv_sec - start.tv_sec) * 1000) +
+              ((end.tv_nsec - start.tv_nsec) / 1000000);
+    if (!TEST_CHECK(ms < STRESS_MAX_TIME))
+    {
+      TEST_MSG("'%s' took %ldms to match %zu bytes\n", pattern, ms, len);
+      return false;
+    }
+
+    /* Unless the prefilter rules it out, a long string isn't matched */
+    if ((budget != 0) && (len > budget))
+    {
+      if (!TEST_CHECK(((rc_exec == REG_ESPACE) || (rc_exec == REG_NOMATCH)) &&
+                      !regex_match(r, strings[j])))
+      {
+        return false;
+      }
+    }
+    else if (len <= 1000)
+    {
+      int expected = regexec(r->regex, strings[j], 0, NULL, 0);
+      if (!TEST_CHECK(rc_exec == expected))
+      {
+        TEST_MSG("'%s' against %zu bytes: expected %d\n", pattern, len, expected);
+        return false;
+      }
+    }
+  }
+
+  /* However slow the matches were, the budget is fixed */
+  if (!TEST_CHECK(regex_budget(r) == budget))
+    return false;
+
+  return true;
+}
+
+static bool test_stress(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  /* Adversarial strings: a long run of one character, then a mismatch */
+  const size_t lengths[] = { 16, 200, 1000, 4000, 20000 };
+  char *strings[2 * mutt_array_size(lengths)] = { 0 };
+  for (size_t i = 0; i < mutt_array_size(lengths); i++)
+  {
+    for (size_t j = 0; j < 2; j++)
+    {
+      char *s = mutt_mem_malloc(lengths[i] + 2);
+      memset(s, (j == 0) ? 'a' : 'x', lengths[i]);
+      s[lengths[i]] = '!';
+      s[lengths[i] + 1] = '\0';
+      strings[(2 * i) + j] = s;
+    }
+  }
+
+  for (size_t i = 0; RiskTests[i].pattern; i++)
+  {
+    const char *pattern = RiskTests[i].pattern;
+
+    mutt_buffer_reset(err);
+    int rc = cs_str_string_set(cs, "Apple", pattern, err);
+    if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+    {
+      TEST_MSG("%s\n", err->data);
+      goto ts_out;
+    }
+
+    const bool risky = (RiskTests[i].risk != REGEX_RISK_NONE);
+    if (!TEST_CHECK(((rc & CSR_SUC_WARNING) != 0) == risky))
+      goto ts_out;
+    if (risky)
+      TEST_MSG("%s\n", err->data);
+
+    mutt_buffer_reset(err);
+    rc = cs_str_string_set(cs, "Banana", pattern, err);
+    if (!TEST_CHECK((CSR_RESULT(rc) == CSR_SUCCESS) != risky))
+      goto ts_out;
+    if (risky)
+      TEST_MSG("Expected error: %s\n", err->data);
+
+    if (!stress_match(pattern, VarApple, strings, mutt_array_size(strings)))
+      goto ts_out;
+
+    /* PCRE2 backtracks, so it's the engine most at risk */
+    if (regex_engine_set("pcre2"))
+    {
+      struct Regex *r = regex_new(pattern, 0, NULL);
+      regex_engine_set(NULL);
+      bool ok = stress_match(pattern, r, strings, mutt_array_size(strings));
+      regex_free(&r);
+      if (!ok)
+        goto ts_out;
+    }
+  }
+
+  log_line(__func__);
+  result = true;
+ts_out:
+  for (size_t i = 0; i < mutt_array_size(strings); i++)
+    FREE(&strings[i]);
+  return result;
+}
+
+void config_complexity(void)
+{
+  struct Buffer err;
+  mutt_buffer_init(&err);
+  err.dsize = 256;
+  err.data = mutt_mem_calloc(1, err.dsize);
+  mutt_buffer_reset(&err);
+
+  struct ConfigSet *cs = cs_new(30);
+
+  regex_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return;
+
+  TEST_CHECK(test_analysis());
+  TEST_CHECK(test_stress(cs, &err));
+
+  cs_free(&cs);
+  FREE(&err.data);
+}
@@ -59,7 +59,7 @@ enum AnimalType
   ANIMAL_FROG      = 42,
 };
 
-static struct Mapping AnimalMap[] = {
+static const struct Mapping AnimalMap[] = {
   { "Antelope",  ANIMAL_ANTELOPE,  },
   { "Badger",    ANIMAL_BADGER,    },
   { "Cassowary", ANIMAL_CASSOWARY, },
@@ -77,7 +77,7 @@ static struct Mapping AnimalMap[] = {
 struct EnumDef AnimalDef = {
   "animal",
   5,
-  (struct Mapping *) &AnimalMap,
+  AnimalMap,
 };
 
 static struct ConfigDef Vars[] = {
@@ -118,6 +118,10 @@ static bool test_initial_values(struct ConfigSet *cs, struct Buffer *err)
     TEST_MSG("Actual  : %d\n", VarBanana);
   }
 
+  /* Registering the config items indexed their Mapping */
+  if (!TEST_CHECK(lookup_is_perfect(AnimalMap)))
+    return false;
+
   cs_str_string_set(cs, "Apple", "Cassowary", err);
   cs_str_string_set(cs, "Banana", "herbivore", err);
 
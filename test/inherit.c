@@ -237,10 +237,280 @@ bool t_mailbox(void)
   return true;
 }
 
+static bool t_chain_check(struct ConfigSet *cs, const char *name, const char *expected,
+                          struct Buffer *err)
+{
+  mutt_buffer_reset(err);
+  int rc = cs_str_string_get(cs, name, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+    return false;
+
+  TEST_MSG("%s = '%s'\n", name, mutt_b2s(err));
+  if (!TEST_CHECK(mutt_str_strcmp(mutt_b2s(err), expected) == 0))
+  {
+    TEST_MSG("Expected: '%s'\n", expected);
+    return false;
+  }
+  return true;
+}
+
+bool t_chain(void)
+{
+  log_line(__func__);
+
+  bool result = false;
+  struct Buffer *err = mutt_buffer_alloc(256);
+  struct ConfigSet *cs = cs_new(30);
+  address_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return false;
+
+  const char *account_vars[] = { "Banana", NULL };
+  const char *mailbox_vars[] = { "Banana", NULL };
+
+  struct ConfigSubset *account_sub = cs_subset_new(cs, "ac", NULL, account_vars);
+  struct ConfigSubset *mailbox_sub = cs_subset_new(cs, "mbox", "ac", mailbox_vars);
+
+  // The mailbox reads through the account to the base
+  if (!t_chain_check(cs, "ac:mbox:Banana", "banana@example.com", err))
+    goto tc_out;
+
+  // Setting the account changes what the mailbox sees
+  cs_str_string_set(cs, "ac:Banana", "account@example.com", err);
+  if (!t_chain_check(cs, "ac:mbox:Banana", "account@example.com", err))
+    goto tc_out;
+
+  // Changing the base mustn't affect the mailbox, now
+  cs_str_string_set(cs, "Banana", "base@example.com", err);
+  if (!t_chain_check(cs, "ac:mbox:Banana", "account@example.com", err))
+    goto tc_out;
+
+  // Resetting the account exposes the base again
+  cs_str_reset(cs, "ac:Banana", err);
+  if (!t_chain_check(cs, "ac:mbox:Banana", "base@example.com", err))
+    goto tc_out;
+
+  // Removing the account leaves the mailbox inheriting from the base
+  cs_str_string_set(cs, "ac:Banana", "account@example.com", err);
+  cs_subset_free(&account_sub);
+  if (!t_chain_check(cs, "ac:mbox:Banana", "base@example.com", err))
+    goto tc_out;
+
+  cs_str_string_set(cs, "Banana", "banana@example.com", err);
+  if (!t_chain_check(cs, "ac:mbox:Banana", "banana@example.com", err))
+    goto tc_out;
+
+  log_line(__func__);
+  result = true;
+
+tc_out:
+  cs_subset_free(&mailbox_sub);
+  cs_subset_free(&account_sub);
+  cs_free(&cs);
+  mutt_buffer_free(&err);
+  return result;
+}
+
+bool t_sparse(void)
+{
+  log_line(__func__);
+
+  bool result = false;
+  struct Buffer *err = mutt_buffer_alloc(256);
+  struct ConfigSet *cs = cs_new(30);
+  address_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return false;
+
+  const char *account_vars[] = { "Apple", "Banana", NULL };
+  const char *mailbox_vars[] = { "Banana", NULL };
+
+  struct ConfigSubset *account_sub = cs_subset_new_sparse(cs, "ac", NULL, account_vars);
+  struct ConfigSubset *mailbox_sub = cs_subset_new_sparse(cs, "mbox", account_sub, mailbox_vars);
+
+  // Nothing is created until it's needed
+  if (!TEST_CHECK(!cs_get_elem(cs, "ac:Banana") && !cs_get_elem(cs, "ac:mbox:Banana")))
+    goto ts_out;
+
+  mutt_buffer_reset(err);
+  cs_subset_string_get(mailbox_sub, 0, err);
+  TEST_MSG("ac:mbox:Banana = '%s'\n", mutt_b2s(err));
+  if (!TEST_CHECK(mutt_str_strcmp(mutt_b2s(err), "banana@example.com") == 0))
+    goto ts_out;
+
+  // Setting the mailbox creates the account's item, too
+  int rc = cs_subset_string_set(mailbox_sub, 0, "mailbox@example.com", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) ||
+      !TEST_CHECK(cs_get_elem(cs, "ac:Banana") && cs_get_elem(cs, "ac:mbox:Banana")))
+  {
+    goto ts_out;
+  }
+
+  if (!t_chain_check(cs, "ac:mbox:Banana", "mailbox@example.com", err))
+    goto ts_out;
+
+  // The account inherits from the base, until it's set
+  if (!t_chain_check(cs, "ac:Banana", "banana@example.com", err))
+    goto ts_out;
+
+  cs_subset_string_set(account_sub, 1, "account@example.com", err);
+  cs_subset_reset(mailbox_sub, 0, err);
+  if (!t_chain_check(cs, "ac:mbox:Banana", "account@example.com", err))
+    goto ts_out;
+
+  // Apple was never set
+  if (!TEST_CHECK(!cs_get_elem(cs, "ac:Apple")))
+    goto ts_out;
+
+  log_line(__func__);
+  result = true;
+
+ts_out:
+  cs_subset_free(&mailbox_sub);
+  cs_subset_free(&account_sub);
+  cs_free(&cs);
+  mutt_buffer_free(&err);
+  return result;
+}
+
+bool t_delete_many(void)
+{
+  log_line(__func__);
+
+  bool result = false;
+  struct Buffer *err = mutt_buffer_alloc(256);
+  struct ConfigSet *cs = cs_new(30);
+  address_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return false;
+
+  notify_observer_add(cs->notify, NT_CONFIG, 0, log_observer, 0);
+
+  struct HashElem *base = cs_get_elem(cs, "Banana");
+  struct HashElem *account = cs_inherit_variable(cs, base, "ac:Banana");
+  struct HashElem *mailbox = cs_inherit_variable(cs, account, "ac:mbox:Banana");
+  cs_he_string_set(cs, account, "account@example.com", err);
+
+  // Base items and NULLs are skipped
+  struct HashElem *hes[] = { base, NULL, account };
+  size_t count = cs_he_delete_many(cs, hes, mutt_array_size(hes), "ac");
+  if (!TEST_CHECK((count == 1) && (hes[0] == base) && !hes[2]))
+    goto tdm_out;
+
+  if (!TEST_CHECK(cs_get_elem(cs, "Banana") && !cs_get_elem(cs, "ac:Banana")))
+    goto tdm_out;
+
+  // The orphan now reads from the base
+  if (!t_chain_check(cs, "ac:mbox:Banana", "banana@example.com", err))
+    goto tdm_out;
+
+  if (!TEST_CHECK((cs_he_delete_many(NULL, hes, 1, "ac") == 0) &&
+                  (cs_he_delete_many(cs, NULL, 1, "ac") == 0)))
+  {
+    goto tdm_out;
+  }
+
+  count = cs_he_delete_many(cs, &mailbox, 1, NULL);
+  if (!TEST_CHECK((count == 1) && !cs_get_elem(cs, "ac:mbox:Banana")))
+    goto tdm_out;
+
+  log_line(__func__);
+  result = true;
+
+tdm_out:
+  cs_free(&cs);
+  mutt_buffer_free(&err);
+  return result;
+}
+
+bool t_lookup(void)
+{
+  log_line(__func__);
+
+  bool result = false;
+  struct Buffer *err = mutt_buffer_alloc(256);
+  struct ConfigSet *cs = cs_new(30);
+  address_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return false;
+
+  const char *account_vars[] = { "Banana", "Apple", NULL };
+  const char *mailbox_vars[] = { "Apple", "Banana", NULL };
+
+  struct ConfigSubset *account_sub = cs_subset_new(cs, "ac", NULL, account_vars);
+  struct ConfigSubset *mailbox_sub = cs_subset_new_sparse(cs, "mbox", account_sub, mailbox_vars);
+  struct ConfigSubset *other_sub = cs_subset_new_sparse(cs, "other", account_sub, mailbox_vars);
+
+  // Subsets with the same names share one sorted index
+  if (!TEST_CHECK(mailbox_sub && other_sub && (other_sub->sorted == mailbox_sub->sorted) &&
+                  (account_sub->sorted != mailbox_sub->sorted)))
+  {
+    goto tl_out;
+  }
+  cs_subset_free(&other_sub);
+  if (!TEST_CHECK(cs_subset_lookup(mailbox_sub, "Banana") == 1))
+    goto tl_out;
+
+  if (!TEST_CHECK((cs_subset_lookup(account_sub, "Apple") == 1) &&
+                  (cs_subset_lookup(account_sub, "Banana") == 0) &&
+                  (cs_subset_lookup(mailbox_sub, "Apple") == 0) &&
+                  (cs_subset_lookup(mailbox_sub, "Banana") == 1) &&
+                  (cs_subset_lookup(account_sub, "Cherry") == -1) &&
+                  (cs_subset_lookup(account_sub, NULL) == -1) &&
+                  (cs_subset_lookup(NULL, "Apple") == -1)))
+  {
+    goto tl_out;
+  }
+
+  // Reads fall through to the base
+  int vid_apple = cs_subset_lookup(mailbox_sub, "Apple");
+  int vid_banana = cs_subset_lookup(mailbox_sub, "Banana");
+  intptr_t banana = cs_subset_native_get(mailbox_sub, vid_banana, err);
+  if (!TEST_CHECK((banana != INT_MIN) && (banana != 0)))
+    goto tl_out;
+
+  int rc = cs_subset_native_set(mailbox_sub, vid_apple, banana, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("%s\n", mutt_b2s(err));
+    goto tl_out;
+  }
+
+  if (!t_chain_check(cs, "ac:mbox:Apple", "banana@example.com", err))
+    goto tl_out;
+
+  // The account is unchanged
+  if (!TEST_CHECK(cs_subset_native_get(account_sub, 1, err) == 0))
+    goto tl_out;
+
+  if (!TEST_CHECK((cs_subset_native_get(mailbox_sub, 99, err) == INT_MIN) &&
+                  (cs_subset_native_get(NULL, 0, err) == INT_MIN) &&
+                  (cs_subset_native_set(mailbox_sub, -1, 0, err) == CSR_ERR_CODE) &&
+                  (cs_subset_native_set(NULL, 0, 0, err) == CSR_ERR_CODE)))
+  {
+    goto tl_out;
+  }
+
+  log_line(__func__);
+  result = true;
+
+tl_out:
+  cs_subset_free(&other_sub);
+  cs_subset_free(&mailbox_sub);
+  cs_subset_free(&account_sub);
+  cs_free(&cs);
+  mutt_buffer_free(&err);
+  return result;
+}
+
 void config_inherit(void)
 {
   // t_initial();
   // t_value();
   // t_account();
   t_mailbox();
+  TEST_CHECK(t_chain());
+  TEST_CHECK(t_sparse());
+  TEST_CHECK(t_delete_many());
+  TEST_CHECK(t_lookup());
 }
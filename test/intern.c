@@ -0,0 +1,201 @@
+/**
+ * @file
+ * Test code for interned strings
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+
+static char *VarApple;
+static char *VarBanana;
+static char *VarCherry;
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",  DT_STRING, &VarApple,  IP "apple", 0, NULL },
+  { "Banana", DT_STRING, &VarBanana, 0,          0, NULL },
+  { "Cherry", DT_STRING, &VarCherry, 0,          0, NULL },
+  { NULL },
+};
+// clang-format on
+
+static bool test_intern_pool(struct ConfigSet *cs)
+{
+  log_line(__func__);
+
+  const char *first = cs_intern(cs, "damson");
+  const char *second = cs_intern(cs, "damson");
+  char copy[] = "damson";
+  const char *other = copy;
+
+  if (!TEST_CHECK(first && (first == second) && (cs_intern_count(cs, first) == 2)))
+    return false;
+
+  /* An equal string that wasn't interned */
+  if (!TEST_CHECK((cs_intern_count(cs, copy) == 0) && !cs_intern_release(cs, &other) &&
+                  (other == copy)))
+  {
+    return false;
+  }
+
+  if (!TEST_CHECK(!cs_intern(cs, NULL) && !cs_intern(cs, "")))
+    return false;
+
+  if (!TEST_CHECK(cs_intern_release(cs, &first) && !first &&
+                  (cs_intern_count(cs, second) == 1)))
+  {
+    return false;
+  }
+
+  if (!TEST_CHECK(cs_intern_release(cs, &second) && !second))
+    return false;
+
+  if (!TEST_CHECK(!cs_intern_release(NULL, &second) && !cs_intern_release(cs, NULL)))
+    return false;
+
+  log_line(__func__);
+  return true;
+}
+
+static bool test_intern_short(struct ConfigSet *cs)
+{
+  log_line(__func__);
+
+  static const char *longest = "abcdefghijklmnopqrstuvw";  /* 23 chars, in a cell */
+  static const char *shortest = "abcdefghijklmnopqrstuvwx"; /* 24 chars, on the heap */
+
+  const char *first = cs_intern(cs, longest);
+  const char *second = cs_intern(cs, shortest);
+  if (!TEST_CHECK((mutt_str_strcmp(first, longest) == 0) &&
+                  (mutt_str_strcmp(second, shortest) == 0)))
+  {
+    return false;
+  }
+
+  /* A released cell is reused */
+  const char *old = first;
+  cs_intern_release(cs, &first);
+  first = cs_intern(cs, "x");
+  if (!TEST_CHECK((first == old) && (mutt_str_strcmp(first, "x") == 0) &&
+                  (cs_intern_count(cs, first) == 1)))
+  {
+    return false;
+  }
+
+  if (!TEST_CHECK(cs_intern_release(cs, &first) && cs_intern_release(cs, &second)))
+    return false;
+
+  log_line(__func__);
+  return true;
+}
+
+static bool test_intern_values(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+
+  /* Equal values share storage */
+  cs_str_string_set(cs, "Banana", "shared value", err);
+  cs_str_native_set(cs, "Cherry", IP "shared value", err);
+  if (!TEST_CHECK(VarBanana && (VarBanana == VarCherry) &&
+                  (cs_intern_count(cs, VarBanana) == 2)))
+  {
+    return false;
+  }
+
+  cs_str_string_set(cs, "Cherry", "another value", err);
+  if (!TEST_CHECK((VarBanana != VarCherry) && (cs_intern_count(cs, VarBanana) == 1)))
+    return false;
+
+  /* The variable and the initial value each have a reference */
+  int rc = cs_str_initial_set(cs, "Banana", "shared value", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+    return false;
+
+  if (!TEST_CHECK((VarBanana == (char *) Vars[1].initial) &&
+                  (cs_intern_count(cs, VarBanana) == 2)))
+  {
+    return false;
+  }
+
+  rc = cs_str_reset(cs, "Banana", err);
+  if (!TEST_CHECK(rc == (CSR_SUCCESS | CSR_SUC_NO_CHANGE)))
+    return false;
+
+  cs_str_string_set(cs, "Banana", "another value", err);
+  if (!TEST_CHECK((VarBanana == VarCherry) && (cs_intern_count(cs, VarCherry) == 2) &&
+                  (cs_intern_count(cs, (char *) Vars[1].initial) == 1)))
+  {
+    return false;
+  }
+
+  /* An inherited value that matches the initial value outlives it */
+  struct HashElem *he = cs_inherit_variable(cs, cs_get_elem(cs, "Banana"), "fruit:Banana");
+  cs_str_string_set(cs, "fruit:Banana", "shared value", err);
+  cs_str_initial_set(cs, "Banana", "changed value", err);
+  mutt_buffer_reset(err);
+  cs_str_string_get(cs, "fruit:Banana", err);
+  const char *value = (const char *) cs_str_native_get(cs, "fruit:Banana", NULL);
+  bool kept = (mutt_str_strcmp(mutt_b2s(err), "shared value") == 0) &&
+              (cs_intern_count(cs, value) == 1);
+  cs_uninherit_variable(cs, "fruit:Banana");
+  if (!TEST_CHECK(he && kept))
+    return false;
+
+  /* The literal initial value isn't interned */
+  cs_str_string_set(cs, "Apple", "pear", err);
+  cs_str_reset(cs, "Apple", err);
+  if (!TEST_CHECK((VarApple == (char *) Vars[0].initial) &&
+                  (cs_intern_count(cs, VarApple) == 0)))
+  {
+    return false;
+  }
+
+  log_line(__func__);
+  return true;
+}
+
+void config_intern(void)
+{
+  struct Buffer err;
+  mutt_buffer_init(&err);
+  err.dsize = 256;
+  err.data = mutt_mem_calloc(1, err.dsize);
+  mutt_buffer_reset(&err);
+
+  struct ConfigSet *cs = cs_new(30);
+
+  string_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return;
+
+  TEST_CHECK(test_intern_pool(cs));
+  TEST_CHECK(test_intern_short(cs));
+  TEST_CHECK(test_intern_values(cs, &err));
+
+  cs_free(&cs);
+  FREE(&err.data);
+}
@@ -0,0 +1,216 @@
+/**
+ * @file
+ * Test code for the Mapping lookups
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+
+#define WIDE_SIZE 200
+
+// clang-format off
+static const struct Mapping OddMap[] = {
+  { "minus",   -5 },
+  { "big",     1000 },
+  { "zero",    0 },
+  { "Zero",    7 },
+  { "again",   1000 },
+  { "seven",   7 },
+  { NULL,      0 },
+};
+
+static const struct Mapping EmptyMap[] = {
+  { NULL, 0 },
+};
+// clang-format on
+
+static char WideNames[WIDE_SIZE][16];
+static struct Mapping WideMap[WIDE_SIZE + 1];
+
+static const struct LookupTest
+{
+  const char *name;
+  const struct Mapping *map;
+} LookupTests[] = {
+  { "SortAliasMethods",   SortAliasMethods },
+  { "SortAuxMethods",     SortAuxMethods },
+  { "SortBrowserMethods", SortBrowserMethods },
+  { "SortKeyMethods",     SortKeyMethods },
+  { "SortMethods",        SortMethods },
+  { "SortSidebarMethods", SortSidebarMethods },
+  { "OddMap",             OddMap },
+  { "WideMap",            WideMap },
+  { NULL },
+};
+
+static bool check_value(const char *name, const struct Mapping *map)
+{
+  int expected = mutt_map_get_value(name, map);
+  int got = lookup_get_value(name, map);
+  if (!TEST_CHECK(got == expected))
+  {
+    TEST_MSG("'%s': expected %d, got %d\n", name, expected, got);
+    return false;
+  }
+  return true;
+}
+
+static bool test_values(void)
+{
+  log_line(__func__);
+
+  for (size_t i = 0; LookupTests[i].name; i++)
+  {
+    const struct Mapping *map = LookupTests[i].map;
+
+    size_t num = 0;
+    for (; map[num].name; num++)
+    {
+      char buf[64];
+      if (!check_value(map[num].name, map))
+        return false;
+
+      /* Case-insensitive */
+      mutt_str_strfcpy(buf, map[num].name, sizeof(buf));
+      for (char *p = buf; *p; p++)
+        *p = toupper((unsigned char) *p);
+      if (!check_value(buf, map))
+        return false;
+
+      /* Near misses */
+      snprintf(buf, sizeof(buf), "%sx", map[num].name);
+      if (!check_value(buf, map))
+        return false;
+      snprintf(buf, sizeof(buf), "%.*s", (int) strlen(map[num].name) - 1, map[num].name);
+      if (!check_value(buf, map))
+        return false;
+    }
+
+    TEST_MSG("%-18s %3zu names, perfect: %s\n", LookupTests[i].name, num,
+             lookup_is_perfect(map) ? "yes" : "no");
+    if (!TEST_CHECK(lookup_is_perfect(map)))
+      return false;
+  }
+
+  if (!TEST_CHECK(lookup_get_value("none", EmptyMap) == -1))
+    return false;
+  if (!TEST_CHECK(lookup_get_value(NULL, SortMethods) == -1))
+    return false;
+  if (!TEST_CHECK(lookup_get_value("date", NULL) == -1))
+    return false;
+
+  log_line(__func__);
+  return true;
+}
+
+static bool test_names(void)
+{
+  log_line(__func__);
+
+  for (size_t i = 0; LookupTests[i].name; i++)
+  {
+    const struct Mapping *map = LookupTests[i].map;
+
+    /* The first name for an id wins, e.g. "date", not "date-sent" */
+    for (int id = -10; id < 1100; id++)
+    {
+      const char *expected = mutt_map_get_name(id, map);
+      const char *got = lookup_get_name(id, map);
+      if (!TEST_CHECK(got == expected))
+      {
+        TEST_MSG("%s, %d: expected '%s', got '%s'\n", LookupTests[i].name, id,
+                 NONULL(expected), NONULL(got));
+        return false;
+      }
+    }
+  }
+
+  TEST_MSG("SortAuxMethods, %d = %s\n", SORT_DATE, lookup_get_name(SORT_DATE, SortAuxMethods));
+  TEST_MSG("OddMap, 1000 = %s\n", lookup_get_name(1000, OddMap));
+
+  if (!TEST_CHECK(lookup_get_name(0, EmptyMap) == NULL))
+    return false;
+  if (!TEST_CHECK(lookup_get_name(0, NULL) == NULL))
+    return false;
+
+  log_line(__func__);
+  return true;
+}
+
+static bool test_unregistered(void)
+{
+  log_line(__func__);
+
+  /* A Mapping that might change, e.g. on the stack, is scanned */
+  struct Mapping map[] = {
+    { "red",   1 },
+    { "green", 2 },
+    { NULL,    0 },
+  };
+
+  if (!TEST_CHECK((lookup_get_value("green", map) == 2) && !lookup_is_perfect(map)))
+    return false;
+
+  map[1].name = "blue";
+  map[1].value = 3;
+  if (!TEST_CHECK((lookup_get_value("green", map) == -1) &&
+                  (lookup_get_value("blue", map) == 3) &&
+                  (mutt_str_strcmp(lookup_get_name(3, map), "blue") == 0) &&
+                  !lookup_get_name(2, map)))
+  {
+    return false;
+  }
+
+  /* Registering twice is harmless */
+  if (!TEST_CHECK(lookup_register(OddMap) && lookup_register(OddMap) &&
+                  lookup_is_perfect(OddMap) && !lookup_register(NULL)))
+  {
+    return false;
+  }
+
+  log_line(__func__);
+  return true;
+}
+
+void config_lookup(void)
+{
+  /* Ids go beyond LOOKUP_MAX_ID, and each one is used twice */
+  for (size_t i = 0; i < WIDE_SIZE; i++)
+  {
+    snprintf(WideNames[i], sizeof(WideNames[i]), "name-%03zu", i);
+    WideMap[i].name = WideNames[i];
+    WideMap[i].value = (i / 2) * 3;
+  }
+
+  for (size_t i = 0; LookupTests[i].name; i++)
+    lookup_register(LookupTests[i].map);
+
+  TEST_CHECK(test_values());
+  TEST_CHECK(test_names());
+  TEST_CHECK(test_unregistered());
+}
@@ -0,0 +1,211 @@
+/**
+ * @file
+ * Test code for the Mailbox registry
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "account.h"
+#include "common.h"
+#include "mailbox.h"
+
+static struct Mailbox *create_mailbox(const char *path, const char *desc)
+{
+  struct Mailbox *m = mailbox_new();
+  mutt_buffer_strcpy(m->pathbuf, path);
+  m->desc = mutt_str_strdup(desc);
+  return m;
+}
+
+static bool test_mailbox_add(void)
+{
+  log_line(__func__);
+  bool result = false;
+
+  struct Mailbox *apple = create_mailbox("/home/mail/apple", "Apple");
+  struct Mailbox *banana = create_mailbox("/home/mail/banana", NULL);
+  struct Mailbox *dup = create_mailbox("/home/mail/apple", "Duplicate");
+
+  if (!TEST_CHECK(mailbox_add(apple) && mailbox_add(banana)))
+    goto tma_out;
+
+  /* Duplicates and double registration are rejected */
+  if (!TEST_CHECK(!mailbox_add(dup) && !mailbox_add(apple) && !mailbox_add(NULL)))
+    goto tma_out;
+
+  if (!TEST_CHECK((mailbox_find("/home/mail/apple") == apple) &&
+                  (mailbox_find("/home/mail/banana") == banana) &&
+                  (mailbox_find_name("Apple") == apple) &&
+                  (mailbox_find_name("Duplicate") == NULL) &&
+                  (mailbox_find(NULL) == NULL) && (mailbox_find_name(NULL) == NULL)))
+  {
+    goto tma_out;
+  }
+
+  mailbox_remove(apple);
+  if (!TEST_CHECK((mailbox_find("/home/mail/apple") == NULL) &&
+                  (mailbox_find_name("Apple") == NULL)))
+  {
+    goto tma_out;
+  }
+
+  /* Now the path is free */
+  if (!TEST_CHECK(mailbox_add(dup) && (mailbox_find_name("Duplicate") == dup)))
+    goto tma_out;
+
+  /* Local paths are canonicalised */
+  struct Mailbox *root = create_mailbox("/./", NULL);
+  struct Mailbox *root2 = create_mailbox("/", NULL);
+  bool added = mailbox_add(root);
+  bool added2 = mailbox_add(root2);
+  bool found = (mailbox_find("/") == root);
+  mailbox_free(&root);
+  mailbox_free(&root2);
+  if (!TEST_CHECK(added && !added2 && found))
+    goto tma_out;
+
+  log_line(__func__);
+  result = true;
+tma_out:
+  mailbox_free(&apple);
+  mailbox_free(&banana);
+  mailbox_free(&dup);
+  if (!TEST_CHECK(TAILQ_EMPTY(&AllMailboxes)))
+    result = false;
+  return result;
+}
+
+static bool test_mailbox_add_bulk(void)
+{
+  log_line(__func__);
+
+  const size_t num = 5000;
+  struct Mailbox **mailboxes = mutt_mem_calloc(num + 1, sizeof(struct Mailbox *));
+  char path[64];
+  char desc[64];
+  bool result = false;
+
+  for (size_t i = 0; i < num; i++)
+  {
+    snprintf(path, sizeof(path), "/home/mail/folder%zu", i);
+    snprintf(desc, sizeof(desc), "Folder %zu", i);
+    mailboxes[i] = create_mailbox(path, desc);
+  }
+  /* A duplicate within the batch */
+  mailboxes[num] = create_mailbox("/home/mail/folder0", "Again");
+
+  size_t count = mailbox_add_bulk(mailboxes, num + 1);
+  TEST_MSG("Added %zu of %zu\n", count, num + 1);
+  if (!TEST_CHECK(count == num))
+    goto tmab_out;
+
+  for (size_t i = 0; i < num; i += 499)
+  {
+    snprintf(path, sizeof(path), "/home/mail/folder%zu", i);
+    snprintf(desc, sizeof(desc), "Folder %zu", i);
+    if (!TEST_CHECK((mailbox_find(path) == mailboxes[i]) &&
+                    (mailbox_find_name(desc) == mailboxes[i])))
+    {
+      goto tmab_out;
+    }
+  }
+
+  if (!TEST_CHECK(mailbox_add_bulk(NULL, 3) == 0))
+    goto tmab_out;
+
+  log_line(__func__);
+  result = true;
+tmab_out:
+  for (size_t i = 0; i <= num; i++)
+    mailbox_free(&mailboxes[i]);
+  FREE(&mailboxes);
+  return result;
+}
+
+static bool test_account_mailbox(void)
+{
+  log_line(__func__);
+
+  struct Account *a = account_new(NULL, NULL);
+  struct Mailbox *apple = create_mailbox("/home/mail/apple", NULL);
+  struct Mailbox *banana = create_mailbox("/home/mail/banana", NULL);
+  bool result = false;
+
+  if (!TEST_CHECK(account_add_mailbox(a, apple) && account_add_mailbox(a, banana)))
+    goto tam_out;
+
+  if (!TEST_CHECK(!account_add_mailbox(a, apple) && (apple->account == a)))
+    goto tam_out;
+
+  account_remove_mailbox(a, apple);
+  if (!TEST_CHECK(!apple->account && (TAILQ_FIRST(&a->mailboxes) == &banana->anode)))
+    goto tam_out;
+
+  /* Freeing a Mailbox removes it from its Account */
+  struct Mailbox *cherry = create_mailbox("/home/mail/cherry", NULL);
+  account_add_mailbox(a, cherry);
+  mailbox_free(&cherry);
+  if (!TEST_CHECK((TAILQ_FIRST(&a->mailboxes) == &banana->anode) &&
+                  (TAILQ_NEXT(&banana->anode, entries) == NULL)))
+  {
+    goto tam_out;
+  }
+
+  /* Freeing the last Mailbox leaves the Account to its owner */
+  struct Mailbox *damson = create_mailbox("/home/mail/damson", NULL);
+  struct Account *a2 = account_new(NULL, NULL);
+  account_add_mailbox(a2, damson);
+  mailbox_free(&damson);
+  const bool empty = TAILQ_EMPTY(&a2->mailboxes);
+  account_free(&a2);
+  if (!TEST_CHECK(empty))
+    goto tam_out;
+
+  /* Removing the last Mailbox frees the Account */
+  account_remove_mailbox(a, banana);
+  a = NULL;
+
+  /* Freeing an Account leaves its Mailboxes */
+  a = account_new(NULL, NULL);
+  account_add_mailbox(a, apple);
+  account_add_mailbox(a, banana);
+  account_free(&a);
+  if (!TEST_CHECK(!apple->account && !banana->account && !apple->anode.mailbox))
+    goto tam_out;
+
+  log_line(__func__);
+  result = true;
+tam_out:
+  account_free(&a);
+  mailbox_free(&apple);
+  mailbox_free(&banana);
+  return result;
+}
+
+void config_mailbox(void)
+{
+  TEST_CHECK(test_mailbox_add());
+  TEST_CHECK(test_mailbox_add_bulk());
+  TEST_CHECK(test_account_mailbox());
+}
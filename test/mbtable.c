@@ -23,6 +23,7 @@
 #define TEST_NO_MAIN
 #include "acutest.h"
 #include "config.h"
+#include <locale.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -48,6 +49,7 @@ static struct MbTable *VarNectarine;
 static struct MbTable *VarOlive;
 static struct MbTable *VarPapaya;
 static struct MbTable *VarQuince;
+static struct MbTable *VarRaspberry;
 
 // clang-format off
 static struct ConfigDef Vars[] = {
@@ -68,6 +70,7 @@ static struct ConfigDef Vars[] = {
   { "Olive",      DT_MBTABLE, &VarOlive,      IP "olive",      0, validator_warn    },
   { "Papaya",     DT_MBTABLE, &VarPapaya,     IP "papaya",     0, validator_fail    },
   { "Quince",     DT_MBTABLE, &VarQuince,     0,               0, NULL              }, /* test_inherit */
+  { "Raspberry",  DT_MBTABLE, &VarRaspberry,  0,               0, NULL              }, /* test_parsed */
   { NULL },
 };
 // clang-format on
@@ -613,6 +616,78 @@ ti_out:
   return result;
 }
 
+static bool test_parsed(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  char *old_locale = mutt_str_strdup(setlocale(LC_CTYPE, NULL));
+  setlocale(LC_CTYPE, "C.UTF-8");
+
+  struct MbTable *ascii = mbtable_parse(" +-*");
+  /* 'a', RIGHTWARDS ARROW, a double-width CJK character, an invalid byte */
+  struct MbTable *utf8 = mbtable_parse("a\xe2\x86\x92\xe6\x97\xa5\xff");
+
+  if (!TEST_CHECK(ascii && ascii->ascii && (ascii->len == 4) && (ascii->widths[3] == 1) &&
+                  (ascii->lens[3] == 1) && (ascii->wchars[3] == L'*') &&
+                  (mutt_str_strcmp(ascii->chars[3], "*") == 0)))
+  {
+    goto tp_out;
+  }
+  TEST_MSG("'%s' is ASCII, %d chars\n", ascii->orig_str, ascii->len);
+
+  const int widths[] = { 1, 1, 2, 1 };
+  const int lens[] = { 1, 3, 3, 1 };
+  const wchar_t wchars[] = { L'a', 0x2192, 0x65E5, MBTABLE_INVALID };
+  if (!TEST_CHECK(utf8 && !utf8->ascii && (utf8->len == 4)))
+    goto tp_out;
+  for (int i = 0; i < utf8->len; i++)
+  {
+    if (!TEST_CHECK((utf8->widths[i] == widths[i]) && (utf8->lens[i] == lens[i]) &&
+                    (utf8->wchars[i] == wchars[i]) &&
+                    ((int) mutt_str_strlen(utf8->chars[i]) == lens[i])))
+    {
+      TEST_MSG("Character %d: width %d, length %d\n", i, utf8->widths[i], utf8->lens[i]);
+      goto tp_out;
+    }
+    TEST_MSG("Character %d: U+%04X, width %d, %d bytes\n", i,
+             (unsigned int) utf8->wchars[i], utf8->widths[i], utf8->lens[i]);
+  }
+
+  /* A table that isn't shared is copied, not parsed again */
+  const char *name = "Raspberry";
+  int rc = cs_str_native_set(cs, name, (intptr_t) utf8, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("%s\n", err->data);
+    goto tp_out;
+  }
+
+  if (!TEST_CHECK(VarRaspberry && (VarRaspberry != utf8) && (VarRaspberry->len == utf8->len)))
+    goto tp_out;
+  for (int i = 0; i < utf8->len; i++)
+  {
+    if (!TEST_CHECK((VarRaspberry->widths[i] == utf8->widths[i]) &&
+                    (VarRaspberry->wchars[i] == utf8->wchars[i]) &&
+                    (VarRaspberry->chars[i] != utf8->chars[i]) &&
+                    (mutt_str_strcmp(VarRaspberry->chars[i], utf8->chars[i]) == 0)))
+    {
+      TEST_MSG("Character %d wasn't copied\n", i);
+      goto tp_out;
+    }
+  }
+  TEST_MSG("%s = '%s', %d chars\n", name, VarRaspberry->orig_str, VarRaspberry->len);
+
+  log_line(__func__);
+  result = true;
+tp_out:
+  mbtable_free(&ascii);
+  mbtable_free(&utf8);
+  setlocale(LC_CTYPE, old_locale);
+  FREE(&old_locale);
+  return result;
+}
+
 void config_mbtable(void)
 {
   struct Buffer err;
@@ -641,6 +716,7 @@ void config_mbtable(void)
   TEST_CHECK(test_reset(cs, &err));
   TEST_CHECK(test_validator(cs, &err));
   TEST_CHECK(test_inherit(cs, &err));
+  TEST_CHECK(test_parsed(cs, &err));
 
   cs_free(&cs);
   FREE(&err.data);
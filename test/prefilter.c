@@ -0,0 +1,162 @@
+/**
+ * @file
+ * Test code for the Regex prefilter
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <regex.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "common.h"
+
+// clang-format off
+static const char *Patterns[] = {
+  "\\<(attach|attached|attachments?)\\>",
+  "^([ \t]*[|>:}#])+",
+  "^((re|aw|sv)(\\[[0-9]+\\])*:[ \t]*)*",
+  "(>From )|(:[-^]?[][)(><}{|/DP])",
+  "^[^,]*",
+  "^From ",
+  "hello.*world",
+  "x{2,}y",
+  "(ab)+c",
+  "[[:digit:]]+ items",
+  "a\\.b",
+  "(foo|bar)baz",
+  "Patch",
+  "(a|b)\\1",
+  ":P",
+  "q",
+  "(ab|cab)",
+  "see",
+  NULL,
+};
+
+static const char *Subjects[] = {
+  "",
+  "the file is attached",
+  "see the attachments",
+  "reattach",
+  "> > quoted",
+  "\tnot quoted",
+  "Re: Re[2]: hello",
+  "hi :-) there",
+  ">From me",
+  "From nobody",
+  "from nobody",
+  "hello cruel world",
+  "xxy",
+  "xy",
+  "ababc",
+  "42 items",
+  "a.b",
+  "axb",
+  "barbaz",
+  "fobaz",
+  "PATCH",
+  "patch",
+  "bb",
+  "ATTACHED",
+  "caf\xc3\xa9 attached",
+  "hi :P",
+  "Quite SEEN",
+  "see",
+  NULL,
+};
+// clang-format on
+
+static bool test_analysis(void)
+{
+  log_line(__func__);
+
+  for (size_t i = 0; Patterns[i]; i++)
+  {
+    int rflags = mutt_mb_is_lower(Patterns[i]) ? REG_ICASE : 0;
+    struct RegexPrefilter *pf = prefilter_new(Patterns[i], rflags);
+    if (pf)
+    {
+      TEST_MSG("%-40s required '%s', prefix '%s'%s%s\n", Patterns[i], pf->required,
+               pf->prefix, pf->anchored ? ", anchored" : "",
+               pf->use_first ? ", first byte" : "");
+    }
+    else
+    {
+      TEST_MSG("%-40s none\n", Patterns[i]);
+    }
+    prefilter_free(&pf);
+  }
+
+  if (!TEST_CHECK(!prefilter_new(NULL, 0) && !prefilter_reject(NULL, "abc")))
+    return false;
+
+  log_line(__func__);
+  return true;
+}
+
+static bool test_agreement(void)
+{
+  log_line(__func__);
+  bool result = false;
+  size_t rejected = 0;
+  size_t tested = 0;
+
+  for (size_t i = 0; Patterns[i]; i++)
+  {
+    struct Regex *r = regex_new(Patterns[i], DT_REGEX_MATCH_CASE, NULL);
+    struct Regex *ri = regex_new(Patterns[i], 0, NULL);
+    for (size_t j = 0; Subjects[j]; j++)
+    {
+      for (size_t k = 0; k < 2; k++)
+      {
+        struct Regex *rx = (k == 0) ? r : ri;
+        bool expected = (regexec(rx->regex, Subjects[j], 0, NULL, 0) == 0);
+        bool actual = (regex_exec(rx, Subjects[j], 0, NULL) == 0);
+        tested++;
+        if (!actual)
+          rejected++;
+        if (!TEST_CHECK(actual == expected))
+        {
+          TEST_MSG("'%s' against '%s': expected %d\n", Patterns[i], Subjects[j], expected);
+          regex_free(&r);
+          regex_free(&ri);
+          goto ta_out;
+        }
+      }
+    }
+    regex_free(&r);
+    regex_free(&ri);
+  }
+
+  TEST_MSG("%zu tests, %zu didn't match\n", tested, rejected);
+  log_line(__func__);
+  result = true;
+ta_out:
+  return result;
+}
+
+void config_prefilter(void)
+{
+  TEST_CHECK(test_analysis());
+  TEST_CHECK(test_agreement());
+}
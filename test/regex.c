@@ -26,6 +26,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include "mutt/mutt.h"
 #include "common.h"
 #include "config/lib.h"
@@ -381,6 +382,18 @@ static bool test_native_set(struct ConfigSet *cs, struct Buffer *err)
     goto tns_out;
   }
 
+  /* A shared Regex is only reused by an item with the same flags */
+  rc = cs_str_string_set(cs, "Elderberry", "shared.*", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+    goto tns_out;
+  rc = cs_str_native_set(cs, "Jackfruit", (intptr_t) VarElderberry, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) || !TEST_CHECK(VarJackfruit != VarElderberry))
+    goto tns_out;
+  rc = cs_str_native_set(cs, "Kumquat", (intptr_t) VarJackfruit, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) || !TEST_CHECK(VarKumquat == VarJackfruit))
+    goto tns_out;
+  TEST_MSG("Jackfruit = '%s', not shared with Elderberry (NOSUB)\n", VarJackfruit->pattern);
+
   log_line(__func__);
   result = true;
 tns_out:
@@ -673,6 +686,102 @@ ti_out:
   return result;
 }
 
+static bool test_engine(struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  static const char *engines[] = { "posix", "pcre2" };
+  static const struct
+  {
+    const char *pattern;
+    int flags;
+    const char *str;
+    bool match;
+  } tests[] = {
+    // clang-format off
+    { "^([ \t]*[|>:}#])+",       0,                   "> > quoted",     true  },
+    { "^([ \t]*[|>:}#])+",       0,                   "not quoted",     false },
+    { "\\<(attach|attached)\\>", 0,                   "it's attached.", true  },
+    { "\\<(attach|attached)\\>", 0,                   "reattached",     false },
+    { "(:[-^]?[][)(><}{|/DP])",  0,                   "hi :-) there",   true  },
+    { "[\\]",                    0,                   "back\\slash",    true  },
+    { "hello",                   0,                   "HELLO world",    true  },
+    { "Hello",                   0,                   "hello world",    false },
+    { "Hello",                   DT_REGEX_MATCH_CASE, "Hello world",    true  },
+    { "!^\\.[^.]",               DT_REGEX_ALLOW_NOT,  ".hidden",        false },
+    { "!^\\.[^.]",               DT_REGEX_ALLOW_NOT,  "visible",        true  },
+    { "a.b$",                    0,                   "a\nb",           true  },
+    { "[[:digit:]]+",            DT_REGEX_NOSUB,      "room 101",       true  },
+    // clang-format on
+  };
+
+  if (!TEST_CHECK(regex_engine_set("posix")))
+    goto te_out;
+  if (!TEST_CHECK(!regex_engine_set("unknown")))
+    goto te_out;
+
+  for (size_t e = 0; e < mutt_array_size(engines); e++)
+  {
+    if (!regex_engine_set(engines[e]))
+      continue;
+
+    for (size_t i = 0; i < mutt_array_size(tests); i++)
+    {
+      mutt_buffer_reset(err);
+      struct Regex *r = regex_new(tests[i].pattern, tests[i].flags, err);
+      if (!TEST_CHECK(r != NULL))
+      {
+        TEST_MSG("%s: %s\n", tests[i].pattern, mutt_b2s(err));
+        goto te_out;
+      }
+
+      bool match = regex_match(r, tests[i].str);
+      regex_free(&r);
+      if (!TEST_CHECK(match == tests[i].match))
+      {
+        TEST_MSG("%s: '%s' %s\n", engines[e], tests[i].pattern, tests[i].str);
+        goto te_out;
+      }
+    }
+
+    /* Sub-matches are leftmost-longest, whichever the engine */
+    struct Regex *r = regex_new("a|ab", 0, err);
+    regmatch_t pmatch[1];
+    int rc = regex_exec(r, "xab", mutt_array_size(pmatch), pmatch);
+    regex_free(&r);
+    if (!TEST_CHECK((rc == 0) && (pmatch[0].rm_so == 1) && (pmatch[0].rm_eo == 3)))
+    {
+      TEST_MSG("%s: 'a|ab' xab = %d-%d\n", engines[e], (int) pmatch[0].rm_so,
+               (int) pmatch[0].rm_eo);
+      goto te_out;
+    }
+  }
+
+  regex_engine_set(NULL);
+  if (!TEST_CHECK(mutt_str_strcmp(regex_engine_get(), "posix") == 0))
+    goto te_out;
+
+  struct Regex *r = regex_new("b(c+)d", 0, err);
+  regmatch_t pmatch[2];
+  int rc = regex_exec(r, "abccd", mutt_array_size(pmatch), pmatch);
+  bool ok = (rc == 0) && (pmatch[1].rm_so == 2) && (pmatch[1].rm_eo == 4) &&
+            (regexec(r->regex, "abccd", 0, NULL, 0) == 0);
+  regex_free(&r);
+  if (!TEST_CHECK(ok))
+    goto te_out;
+  TEST_MSG("Match: b(c+)d = 2-4\n");
+
+  if (!TEST_CHECK(!regex_match(NULL, "abc") && (regex_engine_name(NULL) == NULL)))
+    goto te_out;
+
+  log_line(__func__);
+  result = true;
+te_out:
+  regex_engine_set(NULL);
+  return result;
+}
+
 void config_regex(void)
 {
   struct Buffer err;
@@ -701,6 +810,7 @@ void config_regex(void)
   TEST_CHECK(test_reset(cs, &err));
   TEST_CHECK(test_validator(cs, &err));
   TEST_CHECK(test_inherit(cs, &err));
+  TEST_CHECK(test_engine(&err));
 
   cs_free(&cs);
   FREE(&err.data);
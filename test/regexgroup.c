@@ -0,0 +1,275 @@
+/**
+ * @file
+ * Test code for matching several Regexes at once
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "account.h"
+#include "common.h"
+
+static struct Regex *VarApple;
+static struct Regex *VarBanana;
+static struct Regex *VarCherry;
+static struct Regex *VarDamson;
+static struct Regex *VarElderberry;
+static struct Regex *VarFig;
+static short VarGuava;
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",      DT_REGEX,                    &VarApple,      IP "^([ \t]*[|>:}#])+", 0, NULL },
+  { "Banana",     DT_REGEX|DT_REGEX_ALLOW_NOT, &VarBanana,     IP "!^From ",           0, NULL },
+  { "Cherry",     DT_REGEX,                    &VarCherry,     IP ":-?[)(]",           0, NULL },
+  { "Damson",     DT_REGEX,                    &VarDamson,     IP "(o)\\1",            0, NULL },
+  { "Elderberry", DT_REGEX,                    &VarElderberry, IP "Hello",             0, NULL },
+  { "Fig",        DT_REGEX,                    &VarFig,        0,                      0, NULL },
+  { "Guava",      DT_NUMBER,                   &VarGuava,      0,                      0, NULL },
+  { NULL },
+};
+// clang-format on
+
+static void dump_matches(struct RegexGroup *group, const char *subjects[])
+{
+  for (size_t i = 0; subjects[i]; i++)
+    TEST_MSG("%-24s 0x%02x\n", subjects[i], cs_regex_group_match(group, subjects[i]));
+}
+
+static bool check_matches(struct ConfigSet *cs, struct RegexGroup *group,
+                          const char *names[], const char *subjects[])
+{
+  for (size_t i = 0; subjects[i]; i++)
+  {
+    RegexGroupMatches expected = 0;
+    for (size_t j = 0; names[j]; j++)
+    {
+      const struct Regex *r = (const struct Regex *) cs_str_native_get(cs, names[j], NULL);
+      if (regex_match(r, subjects[i]))
+        expected |= (1U << j);
+    }
+
+    RegexGroupMatches matches = cs_regex_group_match(group, subjects[i]);
+    if (!TEST_CHECK(matches == expected))
+    {
+      TEST_MSG("'%s': group 0x%02x, separately 0x%02x\n", subjects[i], matches, expected);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool test_group_match(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  const char *names[] = { "Apple", "Banana", "Cherry", "Damson", "Elderberry", "Fig", NULL };
+  const char *subjects[] = {
+    "> quoted :-)", "From me", "hello world", "Hello world", "good", "plain",
+    "PLAIN", "Pl\xc3\xa4in", "HelloHello", "Hell", "", NULL,
+  };
+
+  struct RegexGroup *group = cs_regex_group_new(cs, names);
+  if (!TEST_CHECK(group != NULL))
+    return false;
+
+  dump_matches(group, subjects);
+  if (!check_matches(cs, group, names, subjects))
+    goto tgm_out;
+
+  if (!TEST_CHECK((cs_regex_group_match(group, "> quoted :-)") == 0x07) &&
+                  (cs_regex_group_match(group, "From me") == 0x00) &&
+                  (cs_regex_group_match(group, "Hello good") == 0x1a)))
+  {
+    goto tgm_out;
+  }
+
+  mutt_buffer_reset(err);
+  int rc = cs_str_string_set(cs, "Fig", "plain", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("Error: %s\n", err->data);
+    goto tgm_out;
+  }
+  rc = cs_str_string_set(cs, "Apple", "^>>", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("Error: %s\n", err->data);
+    goto tgm_out;
+  }
+
+  dump_matches(group, subjects);
+  if (!check_matches(cs, group, names, subjects))
+    goto tgm_out;
+
+  if (!TEST_CHECK((cs_regex_group_match(group, "plain") == 0x22) &&
+                  (cs_regex_group_match(group, "> quoted :-)") == 0x06)))
+  {
+    goto tgm_out;
+  }
+
+  log_line(__func__);
+  result = true;
+tgm_out:
+  cs_regex_group_free(&group);
+  return result;
+}
+
+static bool test_group_inherit(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+  struct RegexGroup *group = NULL;
+
+  const char *account = "fruit";
+  const char *AccountVarRegex[] = {
+    "Cherry",
+    NULL,
+  };
+
+  struct Account *a = account_new(cs, NULL);
+  account_add_config(a, cs, account, AccountVarRegex);
+
+  const char *names[] = { "fruit:Cherry", "Elderberry", NULL };
+  group = cs_regex_group_new(cs, names);
+  if (!TEST_CHECK(group != NULL))
+    goto tgi_out;
+
+  if (!TEST_CHECK(cs_regex_group_match(group, "Hello :-)") == 0x03))
+    goto tgi_out;
+
+  // change the parent
+  mutt_buffer_reset(err);
+  int rc = cs_str_string_set(cs, "Cherry", ";-\\)", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("Error: %s\n", err->data);
+    goto tgi_out;
+  }
+  TEST_MSG("Hello ;-) = 0x%02x\n", cs_regex_group_match(group, "Hello ;-)"));
+  if (!TEST_CHECK(cs_regex_group_match(group, "Hello ;-)") == 0x03))
+    goto tgi_out;
+
+  // change the child
+  rc = cs_str_string_set(cs, "fruit:Cherry", "8-\\)", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("Error: %s\n", err->data);
+    goto tgi_out;
+  }
+  TEST_MSG("Hello ;-) = 0x%02x\n", cs_regex_group_match(group, "Hello ;-)"));
+  if (!TEST_CHECK(cs_regex_group_match(group, "Hello 8-)") == 0x03))
+    goto tgi_out;
+
+  // change an intermediate ancestor
+  struct HashElem *mailbox = cs_inherit_variable(cs, cs_get_elem(cs, "fruit:Cherry"),
+                                                 "fruit:mbox:Cherry");
+  const char *deep[] = { "fruit:mbox:Cherry", NULL };
+  cs_regex_group_free(&group);
+  group = cs_regex_group_new(cs, deep);
+  if (!TEST_CHECK(group && (cs_regex_group_match(group, "Hello 8-)") == 0x01)))
+    goto tgi_out;
+
+  rc = cs_str_string_set(cs, "fruit:Cherry", "B-\\)", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("Error: %s\n", err->data);
+    goto tgi_out;
+  }
+  if (!TEST_CHECK((cs_regex_group_match(group, "Hello 8-)") == 0x00) &&
+                  (cs_regex_group_match(group, "Hello B-)") == 0x01)))
+  {
+    goto tgi_out;
+  }
+
+  cs_he_delete_many(cs, &mailbox, 1, NULL);
+  cs_regex_group_free(&group);
+  group = cs_regex_group_new(cs, names);
+
+  // delete the child
+  account_free(&a);
+  TEST_MSG("Hello 8-) = 0x%02x\n", cs_regex_group_match(group, "Hello 8-)"));
+  if (!TEST_CHECK(cs_regex_group_match(group, "Hello 8-)") == 0x02))
+    goto tgi_out;
+
+  log_line(__func__);
+  result = true;
+tgi_out:
+  cs_regex_group_free(&group);
+  account_free(&a);
+  return result;
+}
+
+static bool test_group_errors(struct ConfigSet *cs)
+{
+  log_line(__func__);
+
+  const char *unknown[] = { "Apple", "Unknown", NULL };
+  const char *number[] = { "Apple", "Guava", NULL };
+  const char *empty[] = { NULL };
+
+  if (!TEST_CHECK(!cs_regex_group_new(cs, unknown) && !cs_regex_group_new(cs, number) &&
+                  !cs_regex_group_new(cs, empty) && !cs_regex_group_new(NULL, empty)))
+  {
+    return false;
+  }
+
+  if (!TEST_CHECK(cs_regex_group_match(NULL, "abc") == 0))
+    return false;
+
+  cs_regex_group_free(NULL);
+
+  log_line(__func__);
+  return true;
+}
+
+void config_regexgroup(void)
+{
+  struct Buffer err;
+  mutt_buffer_init(&err);
+  err.dsize = 256;
+  err.data = mutt_mem_calloc(1, err.dsize);
+  mutt_buffer_reset(&err);
+
+  struct ConfigSet *cs = cs_new(30);
+
+  number_init(cs);
+  regex_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return;
+
+  notify_observer_add(cs->notify, NT_CONFIG, 0, log_observer, 0);
+
+  set_list(cs);
+
+  TEST_CHECK(test_group_match(cs, &err));
+  TEST_CHECK(test_group_inherit(cs, &err));
+  TEST_CHECK(test_group_errors(cs));
+
+  cs_free(&cs);
+  FREE(&err.data);
+}
@@ -0,0 +1,226 @@
+/**
+ * @file
+ * Test code for shared config values
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "mutt/mutt.h"
+#include "address/lib.h"
+#include "config/lib.h"
+#include "common.h"
+
+static struct Address *VarApple;
+static struct Address *VarBanana;
+static struct MbTable *VarCherry;
+static struct MbTable *VarDamson;
+static struct Regex *VarElderberry;
+static struct Regex *VarFig;
+static struct Slist *VarGuava;
+static struct Slist *VarHawthorn;
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",      DT_ADDRESS, &VarApple,      IP "apple@example.com", 0, NULL },
+  { "Banana",     DT_ADDRESS, &VarBanana,     0,                      0, NULL },
+  { "Cherry",     DT_MBTABLE, &VarCherry,     IP "abc",               0, NULL },
+  { "Damson",     DT_MBTABLE, &VarDamson,     0,                      0, NULL },
+  { "Elderberry", DT_REGEX,   &VarElderberry, IP "^a.*",              0, NULL },
+  { "Fig",        DT_REGEX,   &VarFig,        0,                      0, NULL },
+  { "Guava",      DT_SLIST|SLIST_SEP_COLON, &VarGuava,    IP "a:b",   0, NULL },
+  { "Hawthorn",   DT_SLIST|SLIST_SEP_COLON, &VarHawthorn, 0,          0, NULL },
+  { NULL },
+};
+// clang-format on
+
+static bool check_shared(struct ConfigSet *cs, const char *first, const char *second,
+                         void **var1, void **var2, struct Buffer *err)
+{
+  log_line(__func__);
+
+  struct Buffer *value = mutt_buffer_alloc(256);
+  bool result = false;
+
+  // Setting the same value by string shares the object
+  mutt_buffer_reset(value);
+  cs_str_string_get(cs, first, value);
+  int rc = cs_str_string_set(cs, second, mutt_b2s(value), err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("%s\n", mutt_b2s(err));
+    goto cs_out;
+  }
+
+  TEST_MSG("%s = '%s', refs = %d\n", second, mutt_b2s(value), cs_shared_count(cs, *var2));
+  if (!TEST_CHECK((*var1 == *var2) && (cs_shared_count(cs, *var1) == 2)))
+    goto cs_out;
+
+  // Changing one doesn't affect the other
+  rc = cs_str_reset(cs, second, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) ||
+      !TEST_CHECK((*var2 == NULL) && (cs_shared_count(cs, *var1) == 1)))
+  {
+    goto cs_out;
+  }
+
+  // Setting the same object natively shares it, too
+  rc = cs_str_native_set(cs, second, (intptr_t) *var1, err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS) ||
+      !TEST_CHECK((*var1 == *var2) && (cs_shared_count(cs, *var1) == 2)))
+  {
+    goto cs_out;
+  }
+
+  // Dropping the last reference releases the object (checked by the sanitisers)
+  cs_str_reset(cs, second, err);
+  cs_str_string_set(cs, first, NULL, err);
+  if (!TEST_CHECK((*var1 == NULL) && (*var2 == NULL)))
+    goto cs_out;
+  cs_str_reset(cs, first, err);
+
+  log_line(__func__);
+  result = true;
+cs_out:
+  mutt_buffer_free(&value);
+  return result;
+}
+
+static bool test_shared_inherit(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  const char *account_vars[] = { "Elderberry", NULL };
+  struct ConfigSubset *sub = cs_subset_new(cs, "fruit", NULL, account_vars);
+
+  // An account that's set to its parent's value shares the parent's object
+  int rc = cs_str_string_set(cs, "fruit:Elderberry", "^a.*", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("%s\n", mutt_b2s(err));
+    goto tsi_out;
+  }
+
+  struct Regex *r = (struct Regex *) cs_str_native_get(cs, "fruit:Elderberry", err);
+  TEST_MSG("fruit:Elderberry = '%s', refs = %d\n", r ? r->pattern : "", cs_shared_count(cs, r));
+  if (!TEST_CHECK((r == VarElderberry) && (cs_shared_count(cs, r) == 2)))
+    goto tsi_out;
+
+  // Until one of them is written
+  rc = cs_str_string_set(cs, "fruit:Elderberry", "^b.*", err);
+  r = (struct Regex *) cs_str_native_get(cs, "fruit:Elderberry", err);
+  if (!TEST_CHECK((r != VarElderberry) && (cs_shared_count(cs, VarElderberry) == 1)))
+    goto tsi_out;
+
+  log_line(__func__);
+  result = true;
+tsi_out:
+  cs_subset_free(&sub);
+  return result;
+}
+
+static bool test_shared_cache(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+  struct SharedStats before = { 0 };
+  struct SharedStats after = { 0 };
+
+  cs_shared_stats(cs, &before);
+
+  // A released value is kept, so setting it again reuses the object
+  int rc = cs_str_string_set(cs, "Fig", "^z+", err);
+  struct Regex *first = VarFig;
+  rc |= cs_str_string_set(cs, "Fig", "^y+", err);
+  rc |= cs_str_string_set(cs, "Fig", "^z+", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("%s\n", mutt_b2s(err));
+    goto tsc_out;
+  }
+
+  cs_shared_stats(cs, &after);
+  TEST_MSG("hits %zu, misses %zu, revived %zu, cached %zu\n", after.hits - before.hits,
+           after.misses - before.misses, after.revived - before.revived, after.cached);
+  if (!TEST_CHECK((VarFig == first) && (after.revived - before.revived == 1) &&
+                  (after.misses - before.misses == 2)))
+  {
+    goto tsc_out;
+  }
+
+  // Shrinking the cache frees the released objects
+  cs_shared_cache_limit(cs, 0);
+  cs_shared_stats(cs, &after);
+  TEST_MSG("cached %zu\n", after.cached);
+  if (!TEST_CHECK(after.cached == 0))
+    goto tsc_out;
+
+  // Without a cache, a value is compiled again
+  cs_shared_stats(cs, &before);
+  cs_str_string_set(cs, "Fig", "^y+", err);
+  cs_str_string_set(cs, "Fig", "^z+", err);
+  cs_shared_stats(cs, &after);
+  TEST_MSG("misses %zu\n", after.misses - before.misses);
+  if (!TEST_CHECK((after.misses - before.misses == 2) && (after.cached == 0)))
+    goto tsc_out;
+
+  cs_shared_stats(NULL, &after);
+  if (!TEST_CHECK(after.hits == 0))
+    goto tsc_out;
+
+  log_line(__func__);
+  result = true;
+tsc_out:
+  cs_shared_cache_limit(cs, SHARED_CACHE_MAX);
+  cs_str_reset(cs, "Fig", err);
+  return result;
+}
+
+void config_shared(void)
+{
+  struct Buffer err;
+  mutt_buffer_init(&err);
+  err.dsize = 256;
+  err.data = mutt_mem_calloc(1, err.dsize);
+  mutt_buffer_reset(&err);
+
+  struct ConfigSet *cs = cs_new(30);
+
+  address_init(cs);
+  mbtable_init(cs);
+  regex_init(cs);
+  slist_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return;
+
+  TEST_CHECK(check_shared(cs, "Apple", "Banana", (void **) &VarApple, (void **) &VarBanana, &err));
+  TEST_CHECK(check_shared(cs, "Cherry", "Damson", (void **) &VarCherry, (void **) &VarDamson, &err));
+  TEST_CHECK(check_shared(cs, "Elderberry", "Fig", (void **) &VarElderberry, (void **) &VarFig, &err));
+  TEST_CHECK(check_shared(cs, "Guava", "Hawthorn", (void **) &VarGuava, (void **) &VarHawthorn, &err));
+  TEST_CHECK(test_shared_inherit(cs, &err));
+  TEST_CHECK(test_shared_cache(cs, &err));
+
+  cs_free(&cs);
+  FREE(&err.data);
+}
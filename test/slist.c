@@ -50,10 +50,8 @@ static struct Slist *VarNectarine;
 static struct Slist *VarOlive;
 static struct Slist *VarPapaya;
 static struct Slist *VarQuince;
-#if 0
 static struct Slist *VarRaspberry;
 static struct Slist *VarStrawberry;
-#endif
 
 // clang-format off
 static struct ConfigDef VarsColon[] = {
@@ -101,6 +99,8 @@ static struct ConfigDef VarsOther[] = {
   { "Olive",      DT_SLIST|SLIST_SEP_COLON, &VarOlive,      IP "olive",               0, validator_warn    },
   { "Papaya",     DT_SLIST|SLIST_SEP_COLON, &VarPapaya,     IP "papaya",              0, validator_fail    },
   { "Quince",     DT_SLIST|SLIST_SEP_COLON, &VarQuince,     0,                        0, NULL              }, /* test_inherit */
+  { "Raspberry",  DT_SLIST|SLIST_SEP_COLON|SLIST_ALLOW_EMPTY|SLIST_CASE_SENSITIVE, &VarRaspberry, 0, 0, NULL  }, /* test_packed */
+  { "Strawberry", DT_SLIST|SLIST_SEP_COMMA, &VarStrawberry, IP "apple,banana",        0, NULL              }, /* test_edit */
   { NULL },
 };
 // clang-format on
@@ -896,6 +896,176 @@ ti_out:
 
 }
 
+static bool test_packed(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+
+  const char *name = "Raspberry";
+  struct Buffer *value = mutt_buffer_alloc(256);
+  bool result = false;
+
+  /* Long enough to be hashed, with one empty item */
+  for (size_t i = 0; i < 20; i++)
+    mutt_buffer_add_printf(value, "%s%zu:", (i == 10) ? ":item" : "item", i);
+
+  mutt_buffer_reset(err);
+  int rc = cs_str_string_set(cs, name, mutt_b2s(value), err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_SUCCESS))
+  {
+    TEST_MSG("Error: %s\n", mutt_b2s(err));
+    goto tp_out;
+  }
+
+  const struct Slist *list = (const struct Slist *) cs_str_native_get(cs, name, err);
+  TEST_MSG("%s has %zu items\n", name, list ? list->count : 0);
+  if (!TEST_CHECK(list && (list->count == 21)))
+    goto tp_out;
+
+  /* The trailing empty item is a duplicate */
+  if (!TEST_CHECK((mutt_str_strcmp(cs_slist_get(list, 0), "item0") == 0) &&
+                  !cs_slist_get(list, 10) &&
+                  (mutt_str_strcmp(cs_slist_get(list, 11), "item10") == 0) &&
+                  (mutt_str_strcmp(cs_slist_get(list, 20), "item19") == 0) &&
+                  !cs_slist_get(list, 21) &&
+                  !cs_slist_get(NULL, 0)))
+  {
+    goto tp_out;
+  }
+
+  /* Twice, so the second time uses the hash */
+  for (int i = 0; i < 2; i++)
+  {
+    if (!TEST_CHECK(cs_slist_is_member(list, "item19") && cs_slist_is_member(list, "item0") &&
+                    !cs_slist_is_member(list, "item20") &&
+                    !cs_slist_is_member(list, "ITEM1") && cs_slist_is_member(list, "") &&
+                    cs_slist_is_member(list, NULL) && !cs_slist_is_member(NULL, "item1")))
+    {
+      goto tp_out;
+    }
+  }
+
+  /* Case matters, for this list */
+  struct HashElem *he = cs_get_elem(cs, name);
+  if (!TEST_CHECK(cs_slist_contains(cs, he, "item1") && !cs_slist_contains(cs, he, "ITEM1") &&
+                  cs_slist_contains(cs, he, "")))
+  {
+    goto tp_out;
+  }
+
+  /* A short list isn't hashed */
+  mutt_buffer_reset(err);
+  rc = cs_str_string_set(cs, name, "apple:banana", err);
+  list = (const struct Slist *) cs_str_native_get(cs, name, err);
+  if (!TEST_CHECK(list && cs_slist_is_member(list, "banana") &&
+                  !cs_slist_is_member(list, "cherry") && !cs_slist_is_member(list, "")))
+  {
+    goto tp_out;
+  }
+
+  log_line(__func__);
+  result = true;
+tp_out:
+  mutt_buffer_free(&value);
+  return result;
+}
+
+static bool test_edit(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  const char *name = "Strawberry";
+  struct HashElem *he = cs_get_elem(cs, name);
+
+  mutt_buffer_reset(err);
+  int rc = cs_slist_add(cs, he, "cherry", err);
+  if (!TEST_CHECK(rc == CSR_SUCCESS))
+  {
+    TEST_MSG("Error: %s\n", mutt_b2s(err));
+    return false;
+  }
+
+  /* Case is ignored, for this list */
+  rc = cs_slist_add(cs, he, "Apple", err);
+  if (!TEST_CHECK((rc == (CSR_SUCCESS | CSR_SUC_NO_CHANGE)) &&
+                  cs_slist_contains(cs, he, "BANANA") && !cs_slist_contains(cs, he, "damson")))
+  {
+    return false;
+  }
+
+  rc = cs_slist_remove(cs, he, "APPLE", err);
+  if (!TEST_CHECK((rc == CSR_SUCCESS) && (VarStrawberry->count == 2)))
+    return false;
+
+  rc = cs_slist_remove(cs, he, "damson", err);
+  if (!TEST_CHECK(rc == (CSR_SUCCESS | CSR_SUC_NO_CHANGE)))
+    return false;
+
+  mutt_buffer_reset(err);
+  rc = cs_slist_add(cs, he, "", err);
+  if (!TEST_CHECK(CSR_RESULT(rc) == CSR_ERR_INVALID))
+    return false;
+  TEST_MSG("Expected error: %s\n", mutt_b2s(err));
+
+  if (!TEST_CHECK((cs_slist_add(cs, NULL, "apple", err) == CSR_ERR_CODE) &&
+                  (cs_slist_remove(NULL, he, "apple", err) == CSR_ERR_CODE) &&
+                  !cs_slist_contains(cs, NULL, "apple")))
+  {
+    return false;
+  }
+
+  /* A shared value is copied before it's changed */
+  rc = cs_str_native_set(cs, "Ilama", (intptr_t) VarStrawberry, err);
+  if (!TEST_CHECK((CSR_RESULT(rc) == CSR_SUCCESS) && (VarIlama == VarStrawberry)))
+    return false;
+
+  cs_slist_add(cs, he, "damson", err);
+  if (!TEST_CHECK((VarIlama != VarStrawberry) && (VarIlama->count == 2) &&
+                  (VarStrawberry->count == 3)))
+  {
+    return false;
+  }
+
+  /* Removing the last item leaves NULL, like setting an empty string */
+  struct HashElem *he_ilama = cs_get_elem(cs, "Ilama");
+  cs_slist_remove(cs, he_ilama, "banana", err);
+  rc = cs_slist_remove(cs, he_ilama, "cherry", err);
+  if (!TEST_CHECK((rc == (CSR_SUCCESS | CSR_SUC_EMPTY)) && !VarIlama))
+    return false;
+
+  /* The validator is still run */
+  struct Slist *before = VarMango;
+  mutt_buffer_reset(err);
+  rc = cs_slist_add(cs, cs_get_elem(cs, "Mango"), "lime", err);
+  if (!TEST_CHECK((CSR_RESULT(rc) == CSR_ERR_INVALID) && (VarMango == before)))
+    return false;
+  TEST_MSG("Expected error: %s\n", mutt_b2s(err));
+
+  /* Changing an inherited list leaves the parent alone */
+  const char *AccountVarStr[] = {
+    name,
+    NULL,
+  };
+
+  struct Account *a = account_new(cs, NULL);
+  account_add_config(a, cs, "fruit", AccountVarStr);
+
+  struct HashElem *he_child = cs_get_elem(cs, "fruit:Strawberry");
+  rc = cs_slist_remove(cs, he_child, "banana", err);
+  if (!TEST_CHECK((rc == CSR_SUCCESS) && (VarStrawberry->count == 3) &&
+                  !cs_slist_contains(cs, he_child, "banana") &&
+                  cs_slist_contains(cs, he, "banana")))
+  {
+    goto te_out;
+  }
+
+  log_line(__func__);
+  result = true;
+te_out:
+  account_free(&a);
+  return result;
+}
+
 bool slist_test_separator(struct ConfigDef Vars[], struct Buffer *err)
 {
   log_line(__func__);
@@ -957,6 +1127,8 @@ void config_slist(void)
   TEST_CHECK(test_reset(cs, &err));
   TEST_CHECK(test_validator(cs, &err));
   TEST_CHECK(test_inherit(cs, &err));
+  TEST_CHECK(test_packed(cs, &err));
+  TEST_CHECK(test_edit(cs, &err));
 
   cs_free(&cs);
   FREE(&err.data);
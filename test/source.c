@@ -0,0 +1,435 @@
+/**
+ * @file
+ * Test code for reading config from a file
+ *
+ * @authors
+ * Copyright (C) 2019 Richard Russon <rich@flatcap.org>
+ *
+ * @copyright
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_NO_MAIN
+#include "acutest.h"
+#include "config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "mutt/mutt.h"
+#include "config/lib.h"
+#include "account.h"
+#include "common.h"
+
+static bool VarApple;
+static short VarBanana;
+static char *VarCherry;
+static char VarDamson;
+static char *VarElderberry;
+static char *VarFig;
+
+// clang-format off
+static struct ConfigDef Vars[] = {
+  { "Apple",      DT_BOOL,   &VarApple,      false,        0, NULL },
+  { "Banana",     DT_NUMBER, &VarBanana,     12,           0, NULL },
+  { "Cherry",     DT_STRING, &VarCherry,     IP "cherry",  0, NULL },
+  { "Damson",     DT_QUAD,   &VarDamson,     MUTT_ASKNO,   0, NULL },
+  { "Elderberry", DT_STRING, &VarElderberry, 0,            0, NULL },
+  { NULL },
+};
+
+static struct ConfigDef ArenaVars[] = {
+  { "Fig",        DT_STRING, &VarFig,        IP "fig",     0, NULL }, /* test_validate_arena */
+  { NULL },
+};
+// clang-format on
+
+static const char *RcFile = "/tmp/neomutt-test-source.rc";
+
+static bool write_rc(const char *path, const char *contents)
+{
+  FILE *fp = fopen(path, "w");
+  if (!fp)
+    return false;
+
+  size_t len = strlen(contents);
+  bool result = (fwrite(contents, 1, len, fp) == len);
+  fclose(fp);
+  return result;
+}
+
+static void dump_vars(struct ConfigSet *cs, const char *names[])
+{
+  struct Buffer *value = mutt_buffer_alloc(256);
+
+  for (size_t i = 0; names[i]; i++)
+  {
+    mutt_buffer_reset(value);
+    int rc = cs_str_string_get(cs, names[i], value);
+    if (CSR_RESULT(rc) == CSR_SUCCESS)
+      TEST_MSG("%s = '%s'\n", names[i], mutt_b2s(value));
+    else
+      TEST_MSG("%s: ERROR: %s\n", names[i], mutt_b2s(value));
+  }
+
+  mutt_buffer_free(&value);
+}
+
+static bool test_source_commands(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+
+  static const char *rc = "# comment\n"
+                          "set Apple\n"
+                          "set Banana = 42 Elderberry=elder\\ berry\n"
+                          "set Cherry=\"tab\\tquote\\\"\"   # trailing comment\r\n"
+                          "\n"
+                          "set Damson=yes ; toggle Apple\n"
+                          "set noDamson invApple\n"
+                          "unset Elderberry ; reset Cherry\n"
+                          "set Elderberry = 'single \"quoted\"'";
+
+  static const char *names[] = {
+    "Apple", "Banana", "Cherry", "Damson", "Elderberry", NULL,
+  };
+
+  const char *path = RcFile;
+  if (!write_rc(path, rc))
+  {
+    TEST_MSG("Can't create %s\n", path);
+    return false;
+  }
+
+  mutt_buffer_reset(err);
+  int errors = cs_source_file(cs, path, err);
+  unlink(path);
+
+  if (!TEST_CHECK(errors == 0))
+  {
+    TEST_MSG("%d errors: %s\n", errors, mutt_b2s(err));
+    return false;
+  }
+
+  dump_vars(cs, names);
+
+  if (!TEST_CHECK((VarApple == true) && (VarBanana == 42) &&
+                  (mutt_str_strcmp(VarCherry, "cherry") == 0) &&
+                  (VarDamson == MUTT_NO) &&
+                  (mutt_str_strcmp(VarElderberry, "single \"quoted\"") == 0)))
+  {
+    return false;
+  }
+
+  log_line(__func__);
+  return true;
+}
+
+static bool test_source_errors(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+
+  static const char *rc = "set Banana = 99\n"
+                          "set Banana = abc\n"
+                          "set Unknown = 1\n"
+                          "set Cherry = \"unterminated\n"
+                          "toggle Banana\n"
+                          "frobnicate Apple\n"
+                          "set Cherry\n"
+                          "set Cherry = last\n";
+
+  const char *path = RcFile;
+  if (!write_rc(path, rc))
+  {
+    TEST_MSG("Can't create %s\n", path);
+    return false;
+  }
+
+  mutt_buffer_reset(err);
+  int errors = cs_source_file(cs, path, err);
+  unlink(path);
+
+  TEST_MSG("%d errors, first: %s\n", errors, mutt_b2s(err));
+  if (!TEST_CHECK(errors == 6))
+    return false;
+
+  /* Lines after the errors must still have been applied */
+  if (!TEST_CHECK((VarBanana == 99) && (mutt_str_strcmp(VarCherry, "last") == 0)))
+    return false;
+
+  mutt_buffer_reset(err);
+  if (!TEST_CHECK(cs_source_file(cs, "/does/not/exist", err) == -1))
+    return false;
+  TEST_MSG("Expected error: %s\n", mutt_b2s(err));
+
+  if (!TEST_CHECK(cs_source_file(NULL, path, err) == -1))
+    return false;
+  if (!TEST_CHECK(cs_source_file(cs, NULL, err) == -1))
+    return false;
+
+  log_line(__func__);
+  return true;
+}
+
+static bool test_source_inherit(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+  bool result = false;
+
+  const char *account = "fruit";
+  const char *AccountVarStr[] = {
+    "Apple",
+    "Banana",
+    NULL,
+  };
+
+  struct Account *a = account_new(cs, NULL);
+  account_add_config(a, cs, account, AccountVarStr);
+
+  static const char *rc = "set fruit:Banana = 7\n"
+                          "toggle fruit:Apple\n";
+
+  static const char *names[] = {
+    "Apple", "fruit:Apple", "Banana", "fruit:Banana", NULL,
+  };
+
+  const char *path = RcFile;
+  if (!write_rc(path, rc))
+  {
+    TEST_MSG("Can't create %s\n", path);
+    goto tsi_out;
+  }
+
+  mutt_buffer_reset(err);
+  int errors = cs_source_file(cs, path, err);
+  unlink(path);
+
+  if (!TEST_CHECK(errors == 0))
+  {
+    TEST_MSG("%d errors: %s\n", errors, mutt_b2s(err));
+    goto tsi_out;
+  }
+
+  dump_vars(cs, names);
+
+  log_line(__func__);
+  result = true;
+tsi_out:
+  account_free(&a);
+  return result;
+}
+
+static bool test_validate_file(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+
+  static const char *rc = "set Banana = 55 Cherry = \"validate\"\n"
+                          "set Banana = abc\n"
+                          "set noDamson invApple\n"
+                          "unset Cherry ; reset Banana\n"
+                          "toggle Cherry\n"
+                          "set Unknown\n";
+
+  bool before_apple = VarApple;
+  short before_banana = VarBanana;
+  char before_damson = VarDamson;
+  char *before_cherry = mutt_str_strdup(VarCherry);
+  bool result = false;
+
+  const char *path = RcFile;
+  if (!write_rc(path, rc))
+  {
+    TEST_MSG("Can't create %s\n", path);
+    goto tvf_out;
+  }
+
+  mutt_buffer_reset(err);
+  int errors = cs_validate_file(cs, path, err);
+  unlink(path);
+
+  TEST_MSG("%d errors:\n%s", errors, mutt_b2s(err));
+  if (!TEST_CHECK(errors == 3))
+    goto tvf_out;
+
+  /* Nothing may have changed */
+  if (!TEST_CHECK((VarApple == before_apple) && (VarBanana == before_banana) &&
+                  (VarDamson == before_damson) &&
+                  (mutt_str_strcmp(VarCherry, before_cherry) == 0)))
+  {
+    goto tvf_out;
+  }
+
+  mutt_buffer_reset(err);
+  if (!TEST_CHECK(cs_validate_file(cs, "/does/not/exist", err) == -1))
+    goto tvf_out;
+  TEST_MSG("Expected error: %s\n", mutt_b2s(err));
+
+  log_line(__func__);
+  result = true;
+tvf_out:
+  FREE(&before_cherry);
+  return result;
+}
+
+static bool test_validate_files(struct ConfigSet *cs, struct Buffer *err)
+{
+  log_line(__func__);
+
+  static const char *rcs[] = {
+    "set Banana = 1\nset Cherry = one\n",
+    "set Banana = two\n",
+    "set Apple = maybe\nset Damson = perhaps\nset Elderberry = 3\n",
+    "# empty\n",
+  };
+
+  char paths[mutt_array_size(rcs)][64];
+  struct ValidateResult files[mutt_array_size(rcs) + 1];
+  memset(paths, 0, sizeof(paths));
+  memset(files, 0, sizeof(files));
+  bool result = false;
+
+  for (size_t i = 0; i < mutt_array_size(rcs); i++)
+  {
+    snprintf(paths[i], sizeof(paths[i]), "/tmp/neomutt-test-validate-%zu.rc", i);
+    if (!write_rc(paths[i], rcs[i]))
+    {
+      TEST_MSG("Can't create %s\n", paths[i]);
+      goto tvfs_out;
+    }
+    files[i].path = paths[i];
+  }
+  files[mutt_array_size(rcs)].path = "/does/not/exist";
+
+  size_t errors = cs_validate_files(cs, files, mutt_array_size(files), 2);
+
+  for (size_t i = 0; i < mutt_array_size(files); i++)
+  {
+    TEST_MSG("%s: %zu lines, %d errors\n%s", files[i].path, files[i].lines,
+             files[i].errors, mutt_b2s(files[i].err));
+  }
+
+  if (!TEST_CHECK((errors == 3) && (files[0].errors == 0) && (files[1].errors == 1) &&
+                  (files[2].errors == 2) && (files[3].errors == 0) &&
+                  (files[4].errors == -1)))
+  {
+    goto tvfs_out;
+  }
+
+  if (!TEST_CHECK(cs_validate_files(NULL, files, mutt_array_size(files), 0) == 0))
+    goto tvfs_out;
+
+  log_line(__func__);
+  result = true;
+tvfs_out:
+  cs_validate_free(files, mutt_array_size(files));
+  for (size_t i = 0; i < mutt_array_size(rcs); i++)
+  {
+    if (paths[i][0] != '\0')
+      unlink(paths[i]);
+  }
+  return result;
+}
+
+static bool test_validate_arena(struct Buffer *err)
+{
+  log_line(__func__);
+
+  /* Every value is interned, in the Arena, by several threads at once */
+  struct ConfigSet *cs = cs_new_flags(30, CS_ARENA);
+  string_init(cs);
+  bool result = false;
+
+  char paths[8][64];
+  struct ValidateResult files[mutt_array_size(paths)];
+  memset(paths, 0, sizeof(paths));
+  memset(files, 0, sizeof(files));
+
+  if (!cs_register_variables(cs, ArenaVars, 0))
+    goto tva_out;
+
+  struct Buffer *rc = mutt_buffer_alloc(8192);
+  for (size_t i = 0; i < 200; i++)
+  {
+    mutt_buffer_add_printf(rc, "set Fig = short%zu\n", i);
+    mutt_buffer_add_printf(rc, "set Fig = 'a much longer value, number %zu, that spills'\n", i);
+  }
+
+  for (size_t i = 0; i < mutt_array_size(paths); i++)
+  {
+    snprintf(paths[i], sizeof(paths[i]), "/tmp/neomutt-test-arena-%zu.rc", i);
+    if (!write_rc(paths[i], mutt_b2s(rc)))
+    {
+      TEST_MSG("Can't create %s\n", paths[i]);
+      mutt_buffer_free(&rc);
+      goto tva_out;
+    }
+    files[i].path = paths[i];
+  }
+  mutt_buffer_free(&rc);
+
+  size_t errors = cs_validate_files(cs, files, mutt_array_size(files), 8);
+  TEST_MSG("%zu files, %zu errors\n", mutt_array_size(files), errors);
+  if (!TEST_CHECK(errors == 0))
+    goto tva_out;
+
+  mutt_buffer_reset(err);
+  if (!TEST_CHECK(CSR_RESULT(cs_str_string_get(cs, "Fig", err)) == CSR_SUCCESS) ||
+      !TEST_CHECK(mutt_str_strcmp(mutt_b2s(err), "fig") == 0))
+  {
+    goto tva_out;
+  }
+
+  log_line(__func__);
+  result = true;
+tva_out:
+  cs_validate_free(files, mutt_array_size(files));
+  for (size_t i = 0; i < mutt_array_size(paths); i++)
+  {
+    if (paths[i][0] != '\0')
+      unlink(paths[i]);
+  }
+  cs_free(&cs);
+  return result;
+}
+
+void config_source(void)
+{
+  struct Buffer err;
+  mutt_buffer_init(&err);
+  err.dsize = 256;
+  err.data = mutt_mem_calloc(1, err.dsize);
+  mutt_buffer_reset(&err);
+
+  struct ConfigSet *cs = cs_new(30);
+
+  bool_init(cs);
+  number_init(cs);
+  quad_init(cs);
+  string_init(cs);
+  if (!cs_register_variables(cs, Vars, 0))
+    return;
+
+  notify_observer_add(cs->notify, NT_CONFIG, 0, log_observer, 0);
+
+  set_list(cs);
+
+  TEST_CHECK(test_source_commands(cs, &err));
+  TEST_CHECK(test_source_errors(cs, &err));
+  TEST_CHECK(test_source_inherit(cs, &err));
+  TEST_CHECK(test_validate_file(cs, &err));
+  TEST_CHECK(test_validate_files(cs, &err));
+  TEST_CHECK(test_validate_arena(&err));
+
+  cs_free(&cs);
+  FREE(&err.data);
+}